@@ -15,6 +15,8 @@
 
 namespace gr {
 namespace sandia_utils {
+// which completed blocks are kept when the output falls behind
+enum block_policy_t { BLOCK_LATEST = 0, BLOCK_FIFO = 1, BLOCK_EVERY_KTH = 2 };
 
 /*!
  * \brief Guarantee blocks of continuous samples, free of overflows or rate changes.
@@ -28,12 +30,43 @@ namespace sandia_utils {
  * the tag is the number of samples which have been skipped since the last
  * block (not counting any skips from source overflows).
  *
+ * Blocks are held in a ring of depth buffers, one being filled, one being
+ * output and up to depth - 2 completed blocks waiting. When the output
+ * falls behind, the policy decides which blocks are dropped:
+ *   - BLOCK_LATEST: the oldest waiting block is dropped, so the newest
+ *     blocks are output (with the default depth of 3, only the latest)
+ *   - BLOCK_FIFO: blocks are output in order, new blocks are dropped while
+ *     the ring is full
+ *   - BLOCK_EVERY_KTH: only every keep_every'th completed block is kept,
+ *     then handled as BLOCK_FIFO
+ * Dropped blocks are counted, see get_dropped_blocks(), and show up as
+ * skipped samples in the next BLOCK tag.
+ *
+ * With a hop smaller than nsamples, consecutive blocks are overlapping
+ * windows starting hop samples apart, e.g. nsamples / 2 for 50% overlap.
+ * The shared samples are carried over between the block buffers. Each
+ * window gets its own rx_time, estimated from the last rx_time tag, and a
+ * BLOCK tag counting the samples skipped beyond one hop.
+ *
  * An example use case would be to place this block immediately after a
  * source, proceeded by a throttle. Then, the source can be set to a high
  * sample rate, while the processing is done at a lower, configurable rate.
  * Only connect one block to the output of this block as odd behavior has
  * been observed with multiple connected blocks due to the scheduler.
  *
+ * With pdu_output set, the block has no stream output. Each completed block
+ * is published on the pdu_out port instead, as a PDU whose vector is the
+ * buffer the samples were read into, so the samples are copied only once.
+ * Buffers come from a pool of pool_size, and are reused once every
+ * consumer has released the PDU. While all of them are held, incoming
+ * samples are skipped. The ring is not used, but BLOCK_EVERY_KTH still
+ * selects which blocks are published. The vector type follows itemsize: c32 for 8 bytes,
+ * f32 for 4, s16 for 2 and u8 otherwise, with itemsize bytes per sample.
+ * The metadata carries rx_time (from the block's first sample, or
+ * estimated from the last rx_time tag), BLOCK (samples skipped) and tags,
+ * a vector of (offset, key, value) tuples with offsets from the start of
+ * the block.
+ *
  */
 class SANDIA_UTILS_API block_buffer : virtual public gr::block
 {
@@ -52,9 +85,23 @@ public:
      * \param nsamples    Number of samples per block
      * \param samp_rate   Sample rate
      * \param pass_data   Pass data through or block
+     * \param pdu_output  Publish blocks as PDUs instead of a stream
+     * \param pool_size   Number of pooled PDU buffers
+     * \param depth       Number of block buffers in the ring, at least 3
+     * \param policy      Which blocks to keep when the output falls behind
+     * \param keep_every  Keep one of every keep_every blocks with BLOCK_EVERY_KTH
+     * \param hop         Samples between block starts, 0 for disjoint blocks
      */
-    static sptr
-    make(size_t itemsize, uint64_t nsamples, float samp_rate, bool pass_data = true);
+    static sptr make(size_t itemsize,
+                     uint64_t nsamples,
+                     float samp_rate,
+                     bool pass_data = true,
+                     bool pdu_output = false,
+                     int pool_size = 4,
+                     int depth = 3,
+                     block_policy_t policy = BLOCK_LATEST,
+                     int keep_every = 1,
+                     uint64_t hop = 0);
 
     /*! \brief Set number of samples in the buffer
      *
@@ -62,6 +109,25 @@ public:
      */
     virtual void set_nsamples(uint64_t nsamples) = 0;
 
+    /*! \brief Set which completed blocks are kept
+     *
+     * \param policy     Drop policy
+     * \param keep_every Keep one of every keep_every blocks with BLOCK_EVERY_KTH
+     */
+    virtual void set_policy(block_policy_t policy, int keep_every = 1) = 0;
+
+    /*! \brief Get the number of completed blocks dropped
+     *
+     * \return Dropped blocks
+     */
+    virtual uint64_t get_dropped_blocks() = 0;
+
+    /*! \brief Set the number of samples between block starts
+     *
+     * \param hop Hop size, 0 or nsamples for disjoint blocks
+     */
+    virtual void set_hop(uint64_t hop) = 0;
+
     /*! \brief Set whether to flow data or drop on the floor
      *
      * \param pass_data Flag to pass data_type
@@ -50,6 +50,21 @@ SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__item_size();
 SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__publish();
 SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__tune_request();
 SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__timeout();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__annotation();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__host_time();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__stats();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__resyncs();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__streams();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__packets();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__bytes();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__packet_rate();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__byte_rate();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__seq_gaps();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__time_discontinuities();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__callback_time();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__stream_id();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__context();
+SANDIA_UTILS_API const pmt::pmt_t PMTCONSTSTR__tags();
 
 enum STUB_MODE { DROP_STUB = 0, PAD_RIGHT = 1, PAD_LEFT = 2 };
 enum GATE_STATE { GATE_WAIT, GATE_DISCARD, GATE_PUBLISH };
@@ -26,14 +26,24 @@ namespace sandia_utils {
  * new file opened when commanded.
  *
  * Adding file tags will cause the stream tags available based on the file type
- * to be added to the output stream at the first sample of the file.  Similarly,
+ * to be added to the output stream at the first sample of the file. SigMF
+ * recordings additionally tag each later capture and every annotation at its
+ * sample index as the file is read.  Similarly,
  * if the beginning tags are populated, the first sample of every file will
  *  contain that tag.
  *
+ * In message mode the file is memory mapped and messages can be paced by a
+ * fixed period, by their rx_time, or sent as fast as possible.
+ *
  * PDU sink port allows remote control of the file to be played. PDU
  * must contain a dict with the key of fname. The value associated with fname
  * is the file name that will be replayed.
  *
+ * Alternatively, a playlist of files matching a glob pattern (or all files in
+ * a directory) can be streamed back to back. The next file is opened and
+ * prefetched while the current one plays, and file tags are only added where
+ * the header time of the next file does not continue the previous one.
+ *
  * \ingroup sandia_utils
  *
  */
@@ -82,6 +92,18 @@ public:
      */
     virtual void open(const char* filename, bool repeat) = 0;
 
+    /*!
+     * \brief Stream a sequence of files back to back.
+     *
+     * Replaces any queued files with all files matching \p pattern. If
+     * \p pattern is a directory, every regular file in it is used. When
+     * repeat is enabled the whole playlist is looped.
+     *
+     * \param pattern	glob pattern or directory
+     * \param sort_by	playlist order, one of "name" or "time" (header time)
+     */
+    virtual void open_playlist(const char* pattern, const char* sort_by = "name") = 0;
+
     /*!
      * \brief Close the file handle.
      */
@@ -117,9 +139,98 @@ public:
      * Set the amount of time between message emissions from a file in
      * milliseconds.
      *
-     * \param period_ms  Emission period (ms)
+     * \param period_ms  Emission period (ms), zero for no delay
      */
     virtual void set_msg_hop_period(int period_ms) = 0;
+
+    /*!
+     * \brief Set the sample format stored in the file
+     *
+     * Allows a file stored as complex integers to be output as complex
+     * float without a separate conversion block. Samples are divided by
+     * \p scale while they are read. Use an empty string (or "fc32") when
+     * the file is already in the output format.
+     *
+     * \param type  on-disk sample type, one of "", "sc16", "sc8"
+     * \param scale  full scale value, zero uses 1.0
+     */
+    virtual void set_disk_type(const char* type, double scale = 0.0) = 0;
+
+    /*!
+     * \brief Keep small files in memory
+     *
+     * Files whose sample data is at most \p max_bytes are loaded into
+     * memory on the first read, so repeat passes are served from the
+     * buffer instead of the file. Repeat counting and begin tags are
+     * unchanged.
+     *
+     * \param max_bytes  largest file to cache, zero disables caching
+     * \param hugepages  back the cache with huge pages when available
+     */
+    virtual void set_cache_size(uint64_t max_bytes, bool hugepages = false) = 0;
+
+    /*!
+     * \brief Read a strided subset of each file for a quick look
+     *
+     * Only the first \p keep items of every \p stride items are read, the
+     * items in between are skipped on disk. Each kept block is tagged with
+     * its rx_time when the file provides a start time and sample rate.
+     *
+     * \param keep  items kept at the start of each block, zero reads the
+     *              whole file
+     * \param stride  block length in items
+     */
+    virtual void set_stride(uint64_t keep, uint64_t stride) = 0;
+
+    /*!
+     * \brief Read a strided subset of each file, one block per period
+     *
+     * Same as set_stride() with the block length given in seconds and
+     * converted with the sample rate of each file. Files without a sample
+     * rate are read in full.
+     *
+     * \param keep  items kept at the start of each block, zero reads the
+     *              whole file
+     * \param period  block length in seconds
+     */
+    virtual void set_stride_period(uint64_t keep, double period) = 0;
+
+    /*!
+     * \brief Set how messages are paced when replaying a message file
+     *
+     * "period" waits the message hop period between messages, "burst"
+     * emits messages as fast as possible and "time" paces messages on the
+     * rx_time in their metadata, relative to the first timed message.
+     * Messages without an rx_time use the hop period.
+     *
+     * \param mode  one of "period", "burst" or "time"
+     */
+    virtual void set_msg_pacing(const char* mode) = 0;
+
+    /*!
+     * \brief Seek to the Nth message of a message file
+     *
+     * The first seek builds an index of the file.
+     *
+     * \param n  message number
+     * @return bool - true on success
+     */
+    virtual bool seek_msg(uint64_t n) = 0;
+
+    /*!
+     * \brief Seek to the first message with an rx_time at or after \p time
+     *
+     * \param time  epoch seconds
+     * @return bool - true on success
+     */
+    virtual bool seek_msg_time(double time) = 0;
+
+    /*!
+     * \brief Number of messages in a message file
+     *
+     * @return uint64_t - message count
+     */
+    virtual uint64_t msg_count() = 0;
 };
 
 } // namespace sandia_utils
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_H
+#define INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_H
+
+#include <gnuradio/sandia_utils/api.h>
+#include <gnuradio/sync_block.h>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace sandia_utils {
+
+/*!
+ * \brief Synchronized multi-channel file source
+ *
+ * Plays back one capture file per output channel in lockstep. When the file
+ * type carries a start time, the channels are aligned to the latest start
+ * time by dropping leading samples from the earlier channels, and playback
+ * stops at the end of the shortest channel.
+ *
+ * All files are read by a single I/O thread using positional reads into a
+ * small ring of chunks shared by every channel, so no channel can run ahead
+ * of the others.
+ *
+ * File tags for each channel are added at the first output sample, with the
+ * rx_time set to the aligned start time.
+ *
+ * \ingroup sandia_utils
+ *
+ */
+class SANDIA_UTILS_API multi_file_source : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<multi_file_source> sptr;
+
+    /*!
+     * \brief Create a multi-channel file source.
+     *
+     * \param itemsize	the size of each item in the files, in bytes
+     * \param filenames	one file per output channel
+     * \param type	file type, one of raw, raw_header, sigmf, blue
+     * \param align	align channel start on the file header time
+     * \param repeat	repeat the files from the aligned start
+     */
+    static sptr make(size_t itemsize,
+                     const std::vector<std::string>& filenames,
+                     const char* type,
+                     bool align = true,
+                     bool repeat = false);
+
+    /*!
+     * \brief Number of leading samples dropped from a channel for alignment
+     *
+     * \param chan	channel index
+     * @return uint64_t - dropped samples
+     */
+    virtual uint64_t trimmed(size_t chan) const = 0;
+
+    /*!
+     * \brief Number of aligned samples played per channel
+     *
+     * @return uint64_t - samples per channel
+     */
+    virtual uint64_t nitems() const = 0;
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_H */
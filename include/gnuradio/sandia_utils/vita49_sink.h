@@ -0,0 +1,93 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_SINK_H
+#define INCLUDED_SANDIA_UTILS_VITA49_SINK_H
+
+#include <gnuradio/sandia_utils/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace sandia_utils {
+
+/*!
+ * \brief VITA 49 sink
+ * \ingroup sandia_utils
+ *
+ * Sends a sample stream as VRT Signal Data packets over TCP or UDP, the
+ * counterpart of vita49_stream_source. Each packet carries the stream ID,
+ * a 4 bit packet count and samples_per_packet samples in the payload
+ * format.
+ *
+ * Packets are time stamped (UTC seconds, real time picoseconds) with the
+ * time of their first sample, taken from the last rx_time tag and advanced
+ * by the sample rate from rx_rate tags. Packets are not time stamped until
+ * both are known. A Context packet with the RF reference frequency and
+ * sample rate is sent when an rx_freq or rx_rate tag changes them. Packets
+ * end early at these tags so each packet has a single time reference.
+ *
+ * Packets are sent a batch at a time, each work() call sends what it
+ * completed.
+ *
+ */
+class SANDIA_UTILS_API vita49_sink : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<vita49_sink> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of sandia_utils::vita49_sink.
+     *
+     * @param host - destination host name or address
+     * @param port - destination port
+     * @param transport - "tcp" or "udp"
+     * @param type - input format, "sc16" (interleaved short) or "fc32" (complex
+     * float)
+     * @param payload - payload format, one of sc16, sc8, sc12, fc32
+     * @param samples_per_packet - samples in a full packet
+     * @param stream_id - VRT stream ID of the data and context packets
+     * @param scale - full scale value of the integer samples, fc32 input is
+     * multiplied by it and sc16 input is divided by it for float payloads
+     */
+    static sptr make(const std::string& host,
+                     int port,
+                     const std::string& transport = "udp",
+                     const std::string& type = "fc32",
+                     const std::string& payload = "sc16",
+                     int samples_per_packet = 360,
+                     uint32_t stream_id = 0,
+                     double scale = 32768.0);
+
+    /**
+     * Returns the number of VRT packets sent, data and context
+     *
+     * @return uint64_t - packets sent
+     */
+    virtual uint64_t getPacketCount(void) = 0;
+
+    /**
+     * Returns the number of bytes sent
+     *
+     * @return uint64_t - bytes sent
+     */
+    virtual uint64_t getByteCount(void) = 0;
+
+    /**
+     * Returns the number of packets that could not be sent, such as while
+     * the TCP connection is down
+     *
+     * @return uint64_t - dropped packets
+     */
+    virtual uint64_t getDropCount(void) = 0;
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_SINK_H */
@@ -0,0 +1,144 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_H
+#define INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_H
+
+#include <gnuradio/sandia_utils/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+namespace sandia_utils {
+
+/*!
+ * \brief VITA 49 stream source
+ * \ingroup sandia_utils
+ *
+ * Receives VRT Signal Data packets over TCP or UDP and produces their
+ * payload as a continuous sample stream. Payloads are complex samples in
+ * network byte order, I first, as 16 bit (sc16), 8 bit (sc8), packed 12 bit
+ * (sc12) or IEEE float (fc32) values.
+ *
+ * VRT time stamps are reported as rx_time tags on the first sample of the
+ * stream and again after any gap, detected from the packet count, from
+ * packets dropped because the output fell behind, or once the sample rate
+ * is known, from a time stamp more than half a sample away from the time
+ * expected from the samples since the last rx_time tag. Time is kept as
+ * integer seconds and picoseconds, so the expected time does not drift.
+ * Context packets produce rx_freq (RF reference) and rx_rate (sample rate)
+ * tags, so the stream can be written with file_sink.
+ *
+ * Per stream ID receive statistics are published on the stats port once
+ * every statistics period, see setStatsPeriod().
+ *
+ */
+class SANDIA_UTILS_API vita49_stream_source : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<vita49_stream_source> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of
+     * sandia_utils::vita49_stream_source.
+     *
+     * @param port - port to listen on
+     * @param transport - "tcp" or "udp"
+     * @param type - output format, "sc16" (interleaved short) or "fc32" (complex
+     * float)
+     * @param scale - full scale value of the integer samples, fc32 output is
+     * divided by it and float payloads are multiplied by it for sc16 output
+     * @param payload - payload format, one of sc16, sc8, sc12, fc32
+     */
+    static sptr make(int port,
+                     const std::string& transport = "tcp",
+                     const std::string& type = "fc32",
+                     double scale = 32768.0,
+                     const std::string& payload = "sc16");
+
+    /**
+     * Sets the socket receive buffer size. Applied when the socket is next
+     * opened.
+     *
+     * @param bytes - receive buffer size in bytes, 0 for the system default
+     */
+    virtual void setRcvBuf(int bytes) = 0;
+
+    /**
+     * Returns the number of packets dropped because the output fell behind
+     *
+     * @return uint64_t - dropped packets
+     */
+    virtual uint64_t getOverflowCount(void) = 0;
+
+    /**
+     * Sets how often the receive statistics are published on the stats
+     * port and the rates updated. Applied from the next packet received.
+     *
+     * @param seconds - statistics period, 0 disables
+     */
+    virtual void setStatsPeriod(double seconds) = 0;
+
+    /**
+     * Returns the receive statistics of every stream ID seen, in the format
+     * of the stats port messages
+     *
+     * @return pmt_t - stats dictionary
+     */
+    virtual pmt::pmt_t getStats(void) = 0;
+
+    /**
+     * Returns the number of VRT packets received over all stream IDs
+     *
+     * @return uint64_t - packets received
+     */
+    virtual uint64_t getPacketCount(void) = 0;
+
+    /**
+     * Returns the number of bytes received, including any discarded
+     *
+     * @return uint64_t - bytes received
+     */
+    virtual uint64_t getByteCount(void) = 0;
+
+    /**
+     * Returns the number of packets missing from the VRT packet counts
+     *
+     * @return uint64_t - sequence gaps
+     */
+    virtual uint64_t getSeqGaps(void) = 0;
+
+    /**
+     * Returns the number of times the receiver lost packet alignment on a
+     * bad header
+     *
+     * @return uint64_t - resync events
+     */
+    virtual uint64_t getResyncCount(void) = 0;
+
+    /**
+     * Returns the number of data packets whose timestamp did not follow on
+     * from the samples of the previous packet
+     *
+     * @return uint64_t - timestamp discontinuities
+     */
+    virtual uint64_t getTimeDiscontinuities(void) = 0;
+
+    /**
+     * Returns the time the receiver thread has spent handing packets to
+     * this block
+     *
+     * @return double - seconds
+     */
+    virtual double getCallbackTime(void) = 0;
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_H */
@@ -20,7 +20,22 @@ namespace sandia_utils {
  * \brief VITA 49 source block
  * \ingroup sandia_utils
  *
- * Assumes all VRT Signal Data packets are timed bursts
+ * Assumes all VRT Signal Data packets are timed bursts. Any number of
+ * senders may connect at once, each connection is parsed separately.
+ *
+ * Data PDUs carry the packet time stamp as rx_time (uint64 seconds,
+ * double fractional seconds), the fraction converted from the integer
+ * picosecond time stamp.
+ *
+ * Packets of different stream IDs can be routed to their own out<N> and
+ * tune<N> ports. Port N carries stream_ids[N], or with more ports than
+ * listed IDs, the unlisted stream IDs in the order they are first seen.
+ * Packets of streams without a port go to out and tune. Data PDUs carry
+ * their stream ID and the metadata of the last context packet of the same
+ * stream, as stream_id and context.
+ *
+ * Per stream ID receive statistics are published on the stats port once
+ * every statistics period, see setStatsPeriod().
  *
  */
 class SANDIA_UTILS_API vita49_tcp_msg_source : virtual public gr::block
@@ -34,8 +49,15 @@ public:
      *
      * @param port - TCP port to listen on
      * @param socket_always_on - true to always leave TCP socket open, default false
+     * @param stream_ids - stream IDs routed to out0/tune0, out1/tune1, ...
+     * @param num_streams - number of routed port pairs, at least the number
+     * of stream_ids. Ports without a listed ID are assigned to new stream IDs
+     * as they arrive.
      */
-    static sptr make(int port, bool socket_always_on = false);
+    static sptr make(int port,
+                     bool socket_always_on = false,
+                     const std::vector<uint32_t>& stream_ids = std::vector<uint32_t>(),
+                     int num_streams = 0);
 
 
     /**
@@ -74,6 +96,107 @@ public:
      * Ensures TCP socket is closed
      */
     virtual void closeSocket(void) = 0;
+
+    /**
+     * Sets the TCP receive buffer size of client connections. Applied when
+     * the socket is next opened.
+     *
+     * @param bytes - receive buffer size in bytes, 0 for the system default
+     */
+    virtual void setRcvBuf(int bytes) = 0;
+
+    /**
+     * Records the raw bytes received to a file for offline replay, with an
+     * index of the arrival time and size of every receive. Applied when the
+     * socket is next opened, which replaces the file.
+     *
+     * @param path - capture file, empty to stop capturing
+     */
+    virtual void setCapture(const std::string& path) = 0;
+
+    /**
+     * Sets how often the receive statistics are published on the stats
+     * port and the rates updated. Applied from the next packet received.
+     *
+     * @param seconds - statistics period, 0 disables
+     */
+    virtual void setStatsPeriod(double seconds) = 0;
+
+    /**
+     * Returns the receive statistics of every stream ID seen, in the format
+     * of the stats port messages
+     *
+     * @return pmt_t - stats dictionary
+     */
+    virtual pmt::pmt_t getStats(void) = 0;
+
+    /**
+     * Returns the number of VRT packets received over all stream IDs
+     *
+     * @return uint64_t - packets received
+     */
+    virtual uint64_t getPacketCount(void) = 0;
+
+    /**
+     * Returns the number of bytes received, including any discarded
+     *
+     * @return uint64_t - bytes received
+     */
+    virtual uint64_t getByteCount(void) = 0;
+
+    /**
+     * Returns the number of packets missing from the VRT packet counts
+     *
+     * @return uint64_t - sequence gaps
+     */
+    virtual uint64_t getSeqGaps(void) = 0;
+
+    /**
+     * Returns the number of times the receiver lost packet alignment on a
+     * bad header
+     *
+     * @return uint64_t - resync events
+     */
+    virtual uint64_t getResyncCount(void) = 0;
+
+    /**
+     * Returns the number of data packets whose timestamp did not follow on
+     * from the samples of the previous packet
+     *
+     * @return uint64_t - timestamp discontinuities
+     */
+    virtual uint64_t getTimeDiscontinuities(void) = 0;
+
+    /**
+     * Returns the time spent handing packets to this block
+     *
+     * @return double - seconds
+     */
+    virtual double getCallbackTime(void) = 0;
+
+    /**
+     * Sets the number of packets queued between the socket thread and the
+     * thread that publishes them, 256 by default. A full queue drops
+     * packets rather than slowing the socket. Applied when the socket is
+     * next opened.
+     *
+     * @param packets - queue size, 0 to publish from the socket thread
+     */
+    virtual void setQueueSize(int packets) = 0;
+
+    /**
+     * Returns the number of packets waiting to be published
+     *
+     * @return uint64_t - queue depth
+     */
+    virtual uint64_t getQueueDepth(void) = 0;
+
+    /**
+     * Returns the number of packets dropped on a full queue
+     *
+     * @return uint64_t - queue drops
+     */
+    virtual uint64_t getQueueDrops(void) = 0;
 };
 
 } // namespace sandia_utils
@@ -0,0 +1,202 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_H
+#define INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/sandia_utils/api.h>
+
+namespace gr {
+namespace sandia_utils {
+
+/*!
+ * \brief VITA 49 UDP source block
+ * \ingroup sandia_utils
+ *
+ * UDP counterpart of vita49_tcp_msg_source, each datagram carries one VRT
+ * packet. Signal Data packets are published on the out port, Context
+ * packets on the tune port, in the same PDU format as the TCP source.
+ * Receive statistics are published on the stats port, as for the TCP
+ * source.
+ *
+ */
+class SANDIA_UTILS_API vita49_udp_msg_source : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<vita49_udp_msg_source> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of
+     * sandia_utils::vita49_udp_msg_source.
+     *
+     * @param port - UDP port to listen on
+     */
+    static sptr make(int port);
+
+
+    /**
+     * Sets Ignore Time behavior
+     *
+     * @param val - true, VITA time stamps are ignored, false, VITA time stamps are
+     * processed
+     */
+    virtual void setIgnoreTime(bool val = false) = 0;
+
+    /**
+     * Returns current Ignore Time behavior
+     *
+     * @return bool - true, VITA time stamps are ignored, false, VITA time stamps are
+     * processed
+     */
+    virtual bool getIgnoreTime(void) = 0;
+
+    /**
+     * Sets Ignore Tune behavior
+     *
+     * @param val - true, VITA context packets are ignored, false, VITA context packets
+     * are processed
+     */
+    virtual void setIgnoreTune(bool val = false) = 0;
+
+    /**
+     * Returns current Ignore Tune behavior
+     *
+     * @return bool - true, VITA context packets are ignored, false, VITA context packets
+     * are processed
+     */
+    virtual bool getIgnoreTune(void) = 0;
+
+    /**
+     * Ensures UDP socket is closed
+     */
+    virtual void closeSocket(void) = 0;
+
+    /**
+     * Sets the UDP socket receive buffer size. Applied when the socket is
+     * next opened.
+     *
+     * @param bytes - receive buffer size in bytes, 0 for the system default
+     */
+    virtual void setRcvBuf(int bytes) = 0;
+
+    /**
+     * Records the raw bytes received to a file for offline replay, with an
+     * index of the arrival time and size of every receive. Applied when the
+     * socket is next opened, which replaces the file.
+     *
+     * @param path - capture file, empty to stop capturing
+     */
+    virtual void setCapture(const std::string& path) = 0;
+
+    /**
+     * Enables kernel receive timestamps. Data PDUs then carry the host
+     * receive time as host_time (uint64 seconds, double fractional seconds).
+     * Applied when the socket is next opened.
+     *
+     * @param val - true to timestamp received packets
+     */
+    virtual void setHostTimestamps(bool val = false) = 0;
+
+    /**
+     * Returns the number of datagrams that were not a valid VRT packet
+     *
+     * @return uint64_t - dropped datagrams
+     */
+    virtual uint64_t getDropCount(void) = 0;
+
+    /**
+     * Sets how often the receive statistics are published on the stats
+     * port and the rates updated. Applied from the next packet received.
+     *
+     * @param seconds - statistics period, 0 disables
+     */
+    virtual void setStatsPeriod(double seconds) = 0;
+
+    /**
+     * Returns the receive statistics of every stream ID seen, in the format
+     * of the stats port messages
+     *
+     * @return pmt_t - stats dictionary
+     */
+    virtual pmt::pmt_t getStats(void) = 0;
+
+    /**
+     * Returns the number of VRT packets received over all stream IDs
+     *
+     * @return uint64_t - packets received
+     */
+    virtual uint64_t getPacketCount(void) = 0;
+
+    /**
+     * Returns the number of bytes received, including any discarded
+     *
+     * @return uint64_t - bytes received
+     */
+    virtual uint64_t getByteCount(void) = 0;
+
+    /**
+     * Returns the number of packets missing from the VRT packet counts
+     *
+     * @return uint64_t - sequence gaps
+     */
+    virtual uint64_t getSeqGaps(void) = 0;
+
+    /**
+     * Returns the number of times the receiver lost packet alignment on a
+     * bad header
+     *
+     * @return uint64_t - resync events
+     */
+    virtual uint64_t getResyncCount(void) = 0;
+
+    /**
+     * Returns the number of data packets whose timestamp did not follow on
+     * from the samples of the previous packet
+     *
+     * @return uint64_t - timestamp discontinuities
+     */
+    virtual uint64_t getTimeDiscontinuities(void) = 0;
+
+    /**
+     * Returns the time spent handing packets to this block
+     *
+     * @return double - seconds
+     */
+    virtual double getCallbackTime(void) = 0;
+
+    /**
+     * Sets the number of packets queued between the socket thread and the
+     * thread that publishes them, 256 by default. A full queue drops
+     * packets rather than slowing the socket. Applied when the socket is
+     * next opened.
+     *
+     * @param packets - queue size, 0 to publish from the socket thread
+     */
+    virtual void setQueueSize(int packets) = 0;
+
+    /**
+     * Returns the number of packets waiting to be published
+     *
+     * @return uint64_t - queue depth
+     */
+    virtual uint64_t getQueueDepth(void) = 0;
+
+    /**
+     * Returns the number of packets dropped on a full queue
+     *
+     * @return uint64_t - queue drops
+     */
+    virtual uint64_t getQueueDrops(void) = 0;
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_H */
@@ -20,11 +20,27 @@
 namespace gr {
 namespace sandia_utils {
 
-block_buffer::sptr
-block_buffer::make(size_t itemsize, uint64_t nsamples, float samp_rate, bool pass_data)
+block_buffer::sptr block_buffer::make(size_t itemsize,
+                                       uint64_t nsamples,
+                                       float samp_rate,
+                                       bool pass_data,
+                                       bool pdu_output,
+                                       int pool_size,
+                                       int depth,
+                                       block_policy_t policy,
+                                       int keep_every,
+                                       uint64_t hop)
 {
-    return gnuradio::get_initial_sptr(
-        new block_buffer_impl(itemsize, nsamples, samp_rate, pass_data));
+    return gnuradio::get_initial_sptr(new block_buffer_impl(itemsize,
+                                                            nsamples,
+                                                            samp_rate,
+                                                            pass_data,
+                                                            pdu_output,
+                                                            pool_size,
+                                                            depth,
+                                                            policy,
+                                                            keep_every,
+                                                            hop));
 }
 
 /*
@@ -33,16 +49,35 @@ block_buffer::make(size_t itemsize, uint64_t nsamples, float samp_rate, bool pas
 block_buffer_impl::block_buffer_impl(size_t itemsize,
                                      uint64_t nsamples,
                                      float samp_rate,
-                                     bool pass_data)
+                                     bool pass_data,
+                                     bool pdu_output,
+                                     int pool_size,
+                                     int depth,
+                                     block_policy_t policy,
+                                     int keep_every,
+                                     uint64_t hop)
     : gr::block("block_buffer",
                 gr::io_signature::make(1, 1, itemsize),
-                gr::io_signature::make(1, 1, itemsize)),
+                pdu_output ? gr::io_signature::make(0, 0, 0)
+                           : gr::io_signature::make(1, 1, itemsize)),
       d_itemsize(itemsize),
       d_samp_rate(samp_rate),
-      d_pass_data(pass_data)
+      d_depth(std::max(depth, 3)),
+      d_policy(policy),
+      d_keep_every(std::max(keep_every, 1)),
+      d_nblocks(0),
+      d_dropped_blocks(0),
+      d_hop(hop),
+      d_pass_data(pass_data),
+      d_pdu_output(pdu_output),
+      d_pool_size(std::max(pool_size, 1)),
+      d_pool_next(0)
 {
+    d_buf.resize(d_depth);
     init_buffers(nsamples);
 
+    message_port_register_out(PMTCONSTSTR__pdu_out());
+
     // small spinlock timeout at beginning till rate is reading
     d_usleep = 10;
 
@@ -64,8 +99,8 @@ block_buffer_impl::block_buffer_impl(size_t itemsize,
  */
 block_buffer_impl::~block_buffer_impl()
 {
-    for (int i = 0; i < 3; i++) {
-        if (d_buf[i].ptr != nullptr) {
+    for (size_t i = 0; i < d_buf.size(); i++) {
+        if (d_buf[i].ptr != nullptr && !d_pdu_output) {
             free(d_buf[i].ptr);
             d_buf[i].ptr = nullptr;
         }
@@ -77,11 +112,11 @@ void block_buffer_impl::forecast(int noutput_items, gr_vector_int& ninput_items_
     // This block is more concerned about processing inputs than producing
     // outputs. If there is input available, then we want work to be called.
 
-    // If d_latest_valid is true, then we have samples ready to write out,
-    // so we require no (0) inputs. If d_latest_valid is false, we still
+    // If d_writing_valid is true, then we have samples ready to write out,
+    // so we require no (0) inputs. If d_writing_valid is false, we still
     // want to process inputs, regardless of whether we end up writing
     // anything, so we need at least 1 input.
-    ninput_items_required[0] = d_latest_valid ? 0 : 1;
+    ninput_items_required[0] = d_writing_valid ? 0 : 1;
 }
 
 void block_buffer_impl::set_nsamples(uint64_t nsamples)
@@ -92,29 +127,266 @@ void block_buffer_impl::set_nsamples(uint64_t nsamples)
     d_read_idx = 0;
 }
 
+void block_buffer_impl::set_policy(block_policy_t policy, int keep_every)
+{
+    std::lock_guard<std::mutex> lock(work_mutex);
+
+    d_policy = policy;
+    d_keep_every = std::max(keep_every, 1);
+}
+
+void block_buffer_impl::set_hop(uint64_t hop)
+{
+    std::lock_guard<std::mutex> lock(work_mutex);
+
+    d_hop = hop;
+}
+
 void block_buffer_impl::init_buffers(uint64_t nsamples)
 {
 
     d_nsamples = nsamples;
-    for (int i = 0; i < 3; i++) {
+    for (size_t i = 0; i < d_buf.size(); i++) {
         if (d_buf[i].ptr != nullptr) {
-            free(d_buf[i].ptr);
+            if (!d_pdu_output) {
+                free(d_buf[i].ptr);
+            }
             d_buf[i].ptr = nullptr;
         }
-        d_buf[i].ptr = (void*)malloc(d_nsamples * d_itemsize);
+        d_buf[i].vec = pmt::PMT_NIL;
+        if (!d_pdu_output) {
+            d_buf[i].ptr = (void*)malloc(d_nsamples * d_itemsize);
+        }
     }
 
+    // vectors still held downstream stay valid, the pool starts again at
+    // the new size
+    d_pool.clear();
+    d_pool_next = 0;
+
     d_write_idx = d_read_idx = 0;
 
     d_reading = 0;
-    d_writing = 1;
-    d_latest = -1;
-    d_latest_valid = false;
+    d_writing = 0;
+    d_writing_valid = false;
+    d_ready.clear();
+    d_free.clear();
+    for (int i = d_depth - 1; i > 0; i--) {
+        d_free.push_back(i);
+    }
 
     // reset flag
     d_next_nsamples = 0;
 }
 
+pmt::pmt_t block_buffer_impl::acquire_pdu_vector()
+{
+    // an entry only the pool references has been released by every consumer
+    for (size_t i = 0; i < d_pool.size(); i++) {
+        size_t idx = (d_pool_next + i) % d_pool.size();
+        if (d_pool[idx].use_count() == 1) {
+            d_pool_next = (idx + 1) % d_pool.size();
+            return d_pool[idx];
+        }
+    }
+
+    if (d_pool.size() >= d_pool_size) {
+        return pmt::PMT_NIL;
+    }
+
+    pmt::pmt_t vec;
+    switch (d_itemsize) {
+    case 8:
+        vec = pmt::make_c32vector(d_nsamples, gr_complex(0, 0));
+        break;
+    case 4:
+        vec = pmt::make_f32vector(d_nsamples, 0);
+        break;
+    case 2:
+        vec = pmt::make_s16vector(d_nsamples, 0);
+        break;
+    default:
+        vec = pmt::make_u8vector(d_nsamples * d_itemsize, 0);
+        break;
+    }
+    d_pool.push_back(vec);
+
+    return vec;
+}
+
+uint64_t block_buffer_impl::update_block_time(int buf, bool estimate)
+{
+    // pop from the d_rx_time_tags queue until d_current_rx_time_tag has the last
+    // rx_time tag received before the beginning of this buffer
+    while (!d_rx_time_tags.empty() &&
+           d_buf[buf].abs_read_idx >= d_rx_time_tags.front().offset) {
+        d_current_rx_time_tag = d_rx_time_tags.front();
+        d_rx_time_tags.pop();
+    }
+
+    // number of samples skipped since the last block, which started one hop
+    // earlier
+    uint64_t numsamples_skipped = 0;
+    if ((d_buf[buf].abs_read_idx != 0) &&
+        (d_buf[buf].abs_read_idx > d_last_abs_read_idx + block_hop())) {
+        numsamples_skipped = d_buf[buf].abs_read_idx - d_last_abs_read_idx - block_hop();
+    }
+
+    if (pmt::eqv(d_buf[buf].rx_time, pmt::PMT_NIL) &&
+        (numsamples_skipped > 0 || estimate)) {
+        // estimate the time elapsed since last received rx_time tag
+        double time_elapsed =
+            (d_buf[buf].abs_read_idx - d_current_rx_time_tag.offset) / d_samp_rate;
+        // add that time to the last received rx_time
+        double frac_seconds =
+            pmt::to_double(pmt::tuple_ref(d_current_rx_time_tag.value, 1)) +
+            time_elapsed;
+        // subtract any whole seconds
+        uint64_t seconds = floor(frac_seconds);
+        frac_seconds -= seconds;
+        // add on the whole seconds from the last rx_time
+        seconds += pmt::to_uint64(pmt::tuple_ref(d_current_rx_time_tag.value, 0));
+        d_buf[buf].rx_time =
+            pmt::make_tuple(pmt::from_uint64(seconds), pmt::from_double(frac_seconds));
+    }
+
+    d_last_abs_read_idx = d_buf[buf].abs_read_idx;
+
+    return numsamples_skipped;
+}
+
+void block_buffer_impl::publish_block(int buf)
+{
+    uint64_t numsamples_skipped = update_block_time(buf, true);
+
+    // tag offsets from the start of the block
+    pmt::pmt_t tags = pmt::make_vector(d_buf[buf].tags.size(), pmt::PMT_NIL);
+    for (size_t i = 0; i < d_buf[buf].tags.size(); i++) {
+        const tag_t& tag = d_buf[buf].tags[i];
+        pmt::vector_set(tags,
+                        i,
+                        pmt::make_tuple(pmt::from_uint64(tag.offset - d_buf[buf].abs_read_idx),
+                                        tag.key,
+                                        tag.value));
+    }
+
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(meta, PMTCONSTSTR__rx_time(), d_buf[buf].rx_time);
+    meta = pmt::dict_add(meta, PMTCONSTSTR__BLOCK(), pmt::from_uint64(numsamples_skipped));
+    meta = pmt::dict_add(meta, PMTCONSTSTR__tags(), tags);
+    message_port_pub(PMTCONSTSTR__pdu_out(), pmt::cons(meta, d_buf[buf].vec));
+
+    // the pool and the consumers hold the vector from here
+    d_buf[buf].vec = pmt::PMT_NIL;
+    d_buf[buf].ptr = nullptr;
+}
+
+void block_buffer_impl::carry_overlap(int prev)
+{
+    uint64_t hop = block_hop();
+    uint64_t overlap = d_nsamples - hop;
+    if (overlap == 0) {
+        d_read_idx = 0;
+        return;
+    }
+
+    // the next window starts hop samples into the last one, prev may be the
+    // buffer being read into when the last block was dropped
+    buffer_t& next = d_buf[d_reading];
+    char* src = static_cast<char*>(d_buf[prev].ptr) + d_itemsize * hop;
+    memmove(next.ptr, src, d_itemsize * overlap);
+
+    uint64_t start = d_buf[prev].abs_read_idx + hop;
+    std::vector<tag_t> tags;
+    pmt::pmt_t rx_time = pmt::PMT_NIL;
+    for (const tag_t& tag : d_buf[prev].tags) {
+        if (tag.offset >= start) {
+            tags.push_back(tag);
+            if (tag.offset == start && pmt::eqv(tag.key, PMTCONSTSTR__rx_time())) {
+                rx_time = tag.value;
+            }
+        }
+    }
+
+    next.abs_read_idx = start;
+    next.tags.swap(tags);
+    next.rx_time = rx_time;
+    d_read_idx = overlap;
+}
+
+bool block_buffer_impl::complete_block()
+{
+    bool keep = true;
+    if (d_policy == BLOCK_EVERY_KTH) {
+        keep = (d_nblocks % d_keep_every) == 0;
+    }
+    d_nblocks++;
+
+    int prev = d_reading;
+
+    if (d_pdu_output) {
+        // published as is, the next block is read into a new vector. A
+        // dropped block's vector is read into again
+        if (!keep) {
+            d_dropped_blocks++;
+            carry_overlap(prev);
+            return false;
+        }
+
+        // the overlap goes into the next vector before this one is handed
+        // on, the other buffer slot holds it. Without a free vector the
+        // next block starts from scratch once one is released
+        d_read_idx = 0;
+        if (block_hop() < d_nsamples) {
+            int next = 1 - prev;
+            d_buf[next].vec = acquire_pdu_vector();
+            if (!pmt::is_null(d_buf[next].vec)) {
+                size_t len;
+                d_buf[next].ptr =
+                    pmt::uniform_vector_writable_elements(d_buf[next].vec, len);
+                d_reading = next;
+                carry_overlap(prev);
+            }
+        }
+        publish_block(prev);
+        return true;
+    }
+
+    // one buffer is being read into and one written out, the rest can wait
+    if (keep && d_ready.size() >= (size_t)(d_depth - 2)) {
+        if (d_policy == BLOCK_LATEST) {
+            // make room by dropping the oldest waiting block
+            d_free.push_back(d_ready.front());
+            d_ready.pop_front();
+            d_dropped_blocks++;
+        } else {
+            keep = false;
+        }
+    }
+
+    if (!keep) {
+        // read the next block into the same buffer
+        d_dropped_blocks++;
+        carry_overlap(prev);
+        return false;
+    }
+
+    d_ready.push_back(d_reading);
+    d_reading = d_free.back();
+    d_free.pop_back();
+    carry_overlap(prev);
+
+    if (!d_writing_valid) {
+        // jump start the writing buffer if it has been waiting
+        d_write_idx = 0;
+        d_writing = d_ready.front();
+        d_ready.pop_front();
+        d_writing_valid = true;
+    }
+
+    return true;
+}
+
 int block_buffer_impl::general_work(int noutput_items,
                                     gr_vector_int& ninput_items,
                                     gr_vector_const_void_star& input_items,
@@ -153,6 +425,27 @@ int block_buffer_impl::general_work(int noutput_items,
             d_buf[d_reading].abs_read_idx = nitems_read(0) + in_idx;
             d_buf[d_reading].tags.clear();
             d_buf[d_reading].rx_time = pmt::PMT_NIL;
+
+            // PDU blocks are read straight into a pooled vector. While every
+            // vector is still held downstream the input is skipped, keeping
+            // its rx_time tags to estimate later block times from
+            if (d_pdu_output && pmt::is_null(d_buf[d_reading].vec)) {
+                d_buf[d_reading].vec = acquire_pdu_vector();
+                if (pmt::is_null(d_buf[d_reading].vec)) {
+                    std::vector<tag_t> tags;
+                    get_tags_in_window(
+                        tags, 0, in_idx, ninput_items[0], PMTCONSTSTR__rx_time());
+                    for (const tag_t& tag : tags) {
+                        if (d_rx_time_tags.empty() || !(d_rx_time_tags.back() == tag)) {
+                            d_rx_time_tags.push(tag);
+                        }
+                    }
+                    break;
+                }
+                size_t len;
+                d_buf[d_reading].ptr =
+                    pmt::uniform_vector_writable_elements(d_buf[d_reading].vec, len);
+            }
         }
 
         // read as much as we can into the current buffer
@@ -272,23 +565,14 @@ int block_buffer_impl::general_work(int noutput_items,
 
         // check if the buffer is full
         if (d_read_idx == d_nsamples) {
-            // buffer is full, switch to new buffer
-            d_read_idx = 0;
-            d_latest = d_reading;
-            d_reading = 3 - d_writing - d_latest;
-            if (d_latest_valid == false) {
-                // jump start the writing buffer if it has been waiting
-                d_write_idx = 0;
-                d_writing = d_latest;
-            }
-            d_latest_valid = true;
+            complete_block();
         }
     }
 
     consume_each(ninput_items[0]);
 
     // write
-    while (d_latest_valid && out_idx < noutput_items - d_nreserved) {
+    while (d_writing_valid && out_idx < noutput_items - d_nreserved) {
 
         // if at the beginning of a buffer, copy all tags onto the output stream
         if (d_write_idx == 0) {
@@ -301,42 +585,12 @@ int block_buffer_impl::general_work(int noutput_items,
                 add_item_tag(0, tag);
             }
 
-            // pop from the d_rx_time_tags queue until d_current_rx_time_tag has the last
-            // rx_time tag received before the beginning of this buffer
-            while (!d_rx_time_tags.empty() &&
-                   d_buf[d_writing].abs_read_idx >= d_rx_time_tags.front().offset) {
-                d_current_rx_time_tag = d_rx_time_tags.front();
-                d_rx_time_tags.pop();
-            }
-
-            // number of samples skipped since the last buffer written
-            int64_t numsamples_skipped =
-                (d_buf[d_writing].abs_read_idx == 0)
-                    ? 0
-                    : std::max(d_buf[d_writing].abs_read_idx - d_last_abs_read_idx -
-                                   d_nsamples,
-                               0lu);
-
             // if there's not already an rx_time tag, and some samples were skipped,
             // estimate and add an rx_time tag
-            if (pmt::eqv(d_buf[d_writing].rx_time, pmt::PMT_NIL) &&
-                numsamples_skipped > 0) {
-                // estimate the time elapsed since last received rx_time tag
-                double time_elapsed =
-                    (d_buf[d_writing].abs_read_idx - d_current_rx_time_tag.offset) /
-                    d_samp_rate;
-                // add that time to the last received rx_time
-                double frac_seconds =
-                    pmt::to_double(pmt::tuple_ref(d_current_rx_time_tag.value, 1)) +
-                    time_elapsed;
-                // subtract any whole seconds
-                uint64_t seconds = floor(frac_seconds);
-                frac_seconds -= seconds;
-                // add on the whole seconds from the last rx_time
-                seconds += pmt::to_uint64(pmt::tuple_ref(d_current_rx_time_tag.value, 0));
-                // create the rx_time tag and add it to the stream
-                d_buf[d_writing].rx_time = pmt::make_tuple(
-                    pmt::from_uint64(seconds), pmt::from_double(frac_seconds));
+            bool tagged = !pmt::eqv(d_buf[d_writing].rx_time, pmt::PMT_NIL);
+            uint64_t numsamples_skipped =
+                update_block_time(d_writing, block_hop() < d_nsamples);
+            if (!tagged && !pmt::eqv(d_buf[d_writing].rx_time, pmt::PMT_NIL)) {
                 add_item_tag(0,
                              d_buf[d_writing].abs_write_idx,
                              PMTCONSTSTR__rx_time(),
@@ -348,7 +602,6 @@ int block_buffer_impl::general_work(int noutput_items,
                          d_buf[d_writing].abs_write_idx,
                          PMTCONSTSTR__BLOCK(),
                          pmt::mp((uint64_t)numsamples_skipped));
-            d_last_abs_read_idx = d_buf[d_writing].abs_read_idx;
         }
 
         // write as much as we can from the current buffer
@@ -365,15 +618,13 @@ int block_buffer_impl::general_work(int noutput_items,
 
         // check if the buffer is empty
         if (d_write_idx == d_nsamples) {
-            // buffer is empty, switch to new buffer
-            if (d_latest == d_writing) {
-                // no new buffer available
-                d_latest_valid = false;
-
-            } else {
-                // switch to latest filled buffer
+            // buffer is empty, switch to the next completed block if any
+            d_free.push_back(d_writing);
+            d_writing_valid = !d_ready.empty();
+            if (d_writing_valid) {
                 d_write_idx = 0;
-                d_writing = d_latest;
+                d_writing = d_ready.front();
+                d_ready.pop_front();
             }
         }
     }
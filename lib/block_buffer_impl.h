@@ -11,6 +11,7 @@
 #define INCLUDED_SANDIA_UTILS_BLOCK_BUFFER_IMPL_H
 
 #include <gnuradio/sandia_utils/block_buffer.h>
+#include <deque> // std::deque
 #include <mutex> // std::mutex
 #include <queue> // std::queue
 
@@ -38,11 +39,30 @@ private:
     tag_t d_current_rx_time_tag;
     std::queue<tag_t> d_rx_time_tags;
 
-    // which of the three buffers is currently being written to or read from
+    // ring of d_depth buffers: one being read into, completed blocks
+    // waiting in d_ready (oldest first), one being written out when
+    // d_writing_valid, the rest in d_free
+    int d_depth;
     int d_reading;
     int d_writing;
-    int d_latest;
-    bool d_latest_valid;
+    bool d_writing_valid;
+    std::deque<int> d_ready;
+    std::vector<int> d_free;
+
+    // which completed blocks are kept, see block_policy_t
+    block_policy_t d_policy;
+    int d_keep_every;
+    uint64_t d_nblocks;
+    uint64_t d_dropped_blocks;
+
+    // samples between the starts of consecutive blocks, the rest of a
+    // block is carried over into the next buffer. 0 for disjoint blocks
+    uint64_t d_hop;
+
+    uint64_t block_hop() const
+    {
+        return (d_hop == 0 || d_hop > d_nsamples) ? d_nsamples : d_hop;
+    }
 
     // pass data?
     bool d_pass_data;
@@ -53,25 +73,82 @@ private:
     // spinlock timeouts (computed based on input buffer size and sample rate)
     int d_usleep;
 
-    // internal buffers
-    struct {
+    // internal buffers, in PDU mode ptr points into vec
+    struct buffer_t {
         void* ptr = nullptr;
         std::vector<tag_t> tags;
         uint64_t abs_read_idx;
         uint64_t abs_write_idx;
         pmt::pmt_t rx_time;
-    } d_buf[3];
+        pmt::pmt_t vec = pmt::PMT_NIL;
+    };
+    std::vector<buffer_t> d_buf;
+
+    // PDU output, blocks are read straight into vectors from the pool. A
+    // pool entry only referenced by the pool is free for reuse
+    bool d_pdu_output;
+    size_t d_pool_size;
+    size_t d_pool_next;
+    std::vector<pmt::pmt_t> d_pool;
 
     // make set_nsamples and general_work threadsafe
     std::mutex work_mutex;
 
     void init_buffers(uint64_t nsamples);
 
+    /*!
+     * \brief Returns a free vector from the PDU pool
+     *
+     * \return PDU vector of d_nsamples, or PMT_NIL if all are in use
+     */
+    pmt::pmt_t acquire_pdu_vector();
+
+    /*!
+     * \brief Finds the rx_time of a completed buffer and the samples
+     * skipped since the previous block
+     *
+     * rx_time is estimated from the last rx_time tag when the buffer does
+     * not start on one and samples were skipped, or always with estimate.
+     *
+     * \param buf      Index of the buffer
+     * \param estimate Estimate rx_time even if no samples were skipped
+     * \return Number of samples skipped
+     */
+    uint64_t update_block_time(int buf, bool estimate);
+
+    /*!
+     * \brief Publishes a completed buffer on pdu_out
+     *
+     * \param buf Index of the buffer
+     */
+    void publish_block(int buf);
+
+    /*!
+     * \brief Hands a completed block to the writer according to the policy
+     *
+     * \return true if the block was kept, false if it was dropped
+     */
+    bool complete_block();
+
+    /*!
+     * \brief Starts the next block in d_reading with the samples and tags
+     * its window shares with the completed block
+     *
+     * \param prev Index of the completed block, may be d_reading
+     */
+    void carry_overlap(int prev);
+
 public:
     block_buffer_impl(size_t itemsize,
                       uint64_t nsamples,
                       float samp_rate,
-                      bool pass_data = true);
+                      bool pass_data = true,
+                      bool pdu_output = false,
+                      int pool_size = 4,
+                      int depth = 3,
+                      block_policy_t policy = BLOCK_LATEST,
+                      int keep_every = 1,
+                      uint64_t hop = 0);
     ~block_buffer_impl();
 
     void set_pass_data(bool pass_data)
@@ -84,6 +161,16 @@ public:
 
     void set_nsamples(uint64_t nsamples);
 
+    void set_policy(block_policy_t policy, int keep_every);
+
+    void set_hop(uint64_t hop);
+
+    uint64_t get_dropped_blocks()
+    {
+        std::lock_guard<std::mutex> lock(work_mutex);
+        return d_dropped_blocks;
+    }
+
     void forecast(int noutput_items, gr_vector_int& ninput_items_required);
 
     int general_work(int noutput_items,
@@ -184,6 +184,96 @@ const pmt::pmt_t PMTCONSTSTR__timeout()
     return val;
 }
 
+const pmt::pmt_t PMTCONSTSTR__annotation()
+{
+    static const pmt::pmt_t val = pmt::mp("annotation");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__host_time()
+{
+    static const pmt::pmt_t val = pmt::mp("host_time");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__stats()
+{
+    static const pmt::pmt_t val = pmt::mp("stats");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__resyncs()
+{
+    static const pmt::pmt_t val = pmt::mp("resyncs");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__streams()
+{
+    static const pmt::pmt_t val = pmt::mp("streams");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__packets()
+{
+    static const pmt::pmt_t val = pmt::mp("packets");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__bytes()
+{
+    static const pmt::pmt_t val = pmt::mp("bytes");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__packet_rate()
+{
+    static const pmt::pmt_t val = pmt::mp("packet_rate");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__byte_rate()
+{
+    static const pmt::pmt_t val = pmt::mp("byte_rate");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__seq_gaps()
+{
+    static const pmt::pmt_t val = pmt::mp("seq_gaps");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__time_discontinuities()
+{
+    static const pmt::pmt_t val = pmt::mp("time_discontinuities");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__callback_time()
+{
+    static const pmt::pmt_t val = pmt::mp("callback_time");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__stream_id()
+{
+    static const pmt::pmt_t val = pmt::mp("stream_id");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__context()
+{
+    static const pmt::pmt_t val = pmt::mp("context");
+    return val;
+}
+
+const pmt::pmt_t PMTCONSTSTR__tags()
+{
+    static const pmt::pmt_t val = pmt::mp("tags");
+    return val;
+}
+
 
 
 } // end namespace sandia_utils
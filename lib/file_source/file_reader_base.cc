@@ -12,20 +12,90 @@
 #endif
 
 #include <gnuradio/io_signature.h>
+#include <gnuradio/sandia_utils/constants.h>
 #include "file_reader_base.h"
+#include "file_reader_blue.h"
+#include "file_reader_raw_header.h"
+#include "file_reader_sigmf.h"
+#ifdef HAVE_BLUEFILE_LIB
+#include "file_reader_bluefile.h"
+#endif
 // #include "../file_source_impl.h"
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <volk/volk.h>
+#include <cerrno>
+#include <cmath>
+
+// amount of data to request from the kernel ahead of a file switch
+#define PREFETCH_BYTES (64 * 1024 * 1024)
+
+// huge page size used to round up hugepage-backed cache allocations
+#define HUGEPAGE_BYTES (2 * 1024 * 1024)
 
 
 namespace gr {
   namespace sandia_utils {
 
+  file_reader_base::sptr
+  file_reader_base::make(std::string type, size_t itemsize, gr::logger_ptr logger)
+  {
+      sptr p;
+
+      if (type == "raw") {
+          p = sptr(new file_reader_base(itemsize, logger));
+      } else if (type == "raw_header") {
+          p = sptr(new file_reader_raw_header(itemsize, logger));
+      } else if (type == "blue") {
+          p = sptr(new file_reader_blue(itemsize, logger));
+      } else if (type == "sigmf") {
+          p = sptr(new file_reader_sigmf(itemsize, logger));
+      }
+#ifdef HAVE_BLUEFILE_LIB
+      else if (type == "bluefile") {
+          p = sptr(new file_reader_bluefile(itemsize, logger));
+      }
+#endif
+      else {
+          throw std::runtime_error(
+              str(boost::format("Invalid file source format %s") % type));
+      }
+
+      return p;
+  }
+
     /*
      * The public constructor
      */
   file_reader_base::file_reader_base(size_t itemsize, gr::logger_ptr logger)
-      : d_itemsize(itemsize), d_logger(logger), d_is_open(false), d_fp(NULL)
+      : d_itemsize(itemsize),
+        d_logger(logger),
+        d_is_open(false),
+        d_fp(NULL),
+        d_file_size(0),
+        d_data_offset(0),
+        d_disk_itemsize(itemsize),
+        d_disk_scale(0.0),
+        d_stage(NULL),
+        d_stage_size(0),
+        d_auto_disk_type(false),
+        d_cache_limit(0),
+        d_cache_hugepages(false),
+        d_cache(NULL),
+        d_cache_size(0),
+        d_cache_alloc(0),
+        d_cache_pos(0),
+        d_cache_checked(false),
+        d_stride_keep(0),
+        d_stride(0),
+        d_stride_period(0.0),
+        d_stride_items(0),
+        d_stride_checked(false),
+        d_read_pos(0),
+        d_stride_pread(false),
+        d_stride_pos(0)
   {
       d_tags.resize(0);
     }
@@ -36,6 +106,8 @@ namespace gr {
     file_reader_base::~file_reader_base()
     {
       if (d_is_open) { this->close(); }
+      if (d_stage) { volk_free(d_stage); }
+      free_cache();
     }
 
     void
@@ -46,6 +118,12 @@ namespace gr {
 
       // clear all tags
       d_tags.clear();
+      d_filename = std::string(filename);
+      d_data_offset = 0;
+      d_cache_checked = false;
+      d_stride_checked = false;
+      d_stride_pread = false;
+      d_read_pos = 0;
 
       // we use "open" to use to the O_LARGEFILE flag
       int fd;
@@ -61,15 +139,28 @@ namespace gr {
       }
 
       //Check to ensure the file will be consumed according to item size
-      fseek(d_fp, 0, SEEK_END);
-      d_file_size = ftell(d_fp);
+      fseeko(d_fp, 0, SEEK_END);
+      d_file_size = ftello(d_fp);
       rewind (d_fp);
 
       d_is_open = true;
+      advise();
+    }
+
+    void
+    file_reader_base::advise() {
+      if ((not d_is_open) or (d_fp == NULL)) { return; }
+
+      // files are consumed front to back, allow aggressive readahead. When
+      // striding, readahead would pull in the pages that are skipped
+      posix_fadvise(fileno(d_fp), 0, 0,
+                    d_stride_keep ? POSIX_FADV_RANDOM : POSIX_FADV_SEQUENTIAL);
     }
 
     void
     file_reader_base::close() {
+      free_cache();
+      d_stride_pread = false;
       if ((d_is_open) and (d_fp != NULL)) {
         fclose(d_fp);
         d_is_open = false;
@@ -90,12 +181,304 @@ namespace gr {
         if (not d_fp)
             return true;
 
-        return fseek((FILE*)d_fp, seek_point * d_itemsize, whence) == 0;
+        // positional reads only track the item offset
+        if (d_stride_pread) {
+            int64_t pos = seek_point;
+            if (whence == SEEK_CUR) {
+                pos += d_stride_pos;
+            } else if (whence == SEEK_END) {
+                pos += nitems();
+            }
+            if ((pos < 0) or ((uint64_t)pos > nitems())) {
+                return false;
+            }
+            d_stride_pos = pos;
+            return true;
+        }
+
+        // cached files only move the position within the buffer
+        if (d_cache) {
+            int64_t pos = (int64_t)seek_point * d_disk_itemsize;
+            if (whence == SEEK_CUR) {
+                pos += d_cache_pos;
+            } else if (whence == SEEK_END) {
+                pos += d_cache_size;
+            }
+            if ((pos < 0) or ((uint64_t)pos > d_cache_size)) {
+                return false;
+            }
+            d_cache_pos = pos;
+            return true;
+        }
+
+        // absolute positions are relative to the first sample, not the header
+        off_t offset = (off_t)seek_point * d_disk_itemsize;
+        if (whence == SEEK_SET) {
+            offset += d_data_offset;
+        }
+
+        return fseeko((FILE*)d_fp, offset, whence) == 0;
+    }
+
+    uint64_t file_reader_base::tell()
+    {
+        if (d_cache) {
+            return d_cache_pos / d_disk_itemsize;
+        }
+        if (d_stride_pread) {
+            return d_stride_pos;
+        }
+        if (not d_fp) {
+            return 0;
+        }
+
+        return ((uint64_t)ftello(d_fp) - d_data_offset) / d_disk_itemsize;
+    }
+
+    double file_reader_base::get_start_time()
+    {
+        for (auto& tag : d_tags) {
+            if (pmt::eqv(tag.key, PMTCONSTSTR__rx_time())) {
+                return (double)pmt::to_uint64(pmt::tuple_ref(tag.value, 0)) +
+                       pmt::to_double(pmt::tuple_ref(tag.value, 1));
+            }
+        }
+
+        return -1.0;
+    }
+
+    double file_reader_base::get_rate()
+    {
+        for (auto& tag : d_tags) {
+            if (pmt::eqv(tag.key, PMTCONSTSTR__rate()) or
+                pmt::eqv(tag.key, PMTCONSTSTR__rx_rate())) {
+                return pmt::to_double(tag.value);
+            }
+        }
+
+        return 0.0;
+    }
+
+    void file_reader_base::prefetch()
+    {
+        if (d_is_open and (d_fp != NULL) and (d_cache == NULL)) {
+            posix_fadvise(fileno(d_fp),
+                          d_data_offset,
+                          std::min((uint64_t)PREFETCH_BYTES, d_file_size - d_data_offset),
+                          POSIX_FADV_WILLNEED);
+        }
+    }
+
+    void file_reader_base::set_disk_type(std::string type, double scale)
+    {
+      apply_disk_type(type, scale);
+      d_auto_disk_type = false;
+    }
+
+    void file_reader_base::set_auto_disk_type(std::string type)
+    {
+      // an empty type leaves the choice open for the next file
+      if (d_auto_disk_type or d_disk_type.empty()) {
+        apply_disk_type(type, d_disk_scale);
+        d_auto_disk_type = not type.empty();
+      }
+    }
+
+    void file_reader_base::apply_disk_type(std::string type, double scale)
+    {
+      size_t nfloats = d_itemsize / sizeof(float);
+      if (type.empty() or (type == "fc32")) {
+        d_disk_itemsize = d_itemsize;
+      } else if ((type == "sc16") or (type == "sc8")) {
+        if (d_itemsize % (2 * sizeof(float))) {
+          throw std::runtime_error(
+              str(boost::format("Disk type %s requires a complex float output") % type));
+        }
+        d_disk_itemsize = nfloats * ((type == "sc16") ? sizeof(int16_t) : sizeof(int8_t));
+      } else {
+        throw std::runtime_error(str(boost::format("Invalid disk type %s") % type));
+      }
+
+      d_disk_type = (type == "fc32") ? "" : type;
+      d_disk_scale = scale;
+    }
+
+    void file_reader_base::set_stride(uint64_t keep, uint64_t stride)
+    {
+      d_stride_keep = keep;
+      d_stride = stride;
+      d_stride_period = 0.0;
+      d_stride_checked = false;
+      advise();
+    }
+
+    void file_reader_base::set_stride_period(uint64_t keep, double period)
+    {
+      d_stride_keep = keep;
+      d_stride = 0;
+      d_stride_period = period;
+      d_stride_checked = false;
+      advise();
+    }
+
+    void file_reader_base::check_stride()
+    {
+      // the mode may change below, keep the position across it
+      uint64_t pos = tell();
+      bool pread_mode = d_stride_pread;
+
+      resolve_stride();
+
+      d_stride_pread = (d_stride_items > 0) and (d_cache == NULL) and (fd() >= 0);
+      if (d_stride_pread) {
+        d_stride_pos = pos;
+      } else if (pread_mode) {
+        seek(pos, SEEK_SET);
+      }
+    }
+
+    void file_reader_base::resolve_stride()
+    {
+      d_stride_checked = true;
+      d_stride_items = 0;
+      if (d_stride_keep == 0) { return; }
+
+      uint64_t stride = d_stride;
+      if (d_stride_period > 0.0) {
+        double rate = get_rate();
+        if (rate <= 0.0) {
+          GR_LOG_WARN(d_logger,
+                      boost::format("%s has no sample rate, reading the whole file") %
+                          d_filename);
+          return;
+        }
+        stride = (uint64_t)std::llround(d_stride_period * rate);
+      }
+
+      // a block no longer than the kept items reads everything
+      if (stride > d_stride_keep) {
+        d_stride_items = stride;
+        GR_LOG_DEBUG(d_logger,
+                     boost::format("Reading %d of every %d items of %s") % d_stride_keep %
+                         d_stride_items % d_filename);
+      }
+    }
+
+    bool file_reader_base::stride_tag(uint64_t pos, gr::tag_t &tag)
+    {
+      if ((d_stride_items == 0) or (pos % d_stride_items)) { return false; }
+
+      double rate = get_rate();
+      if (rate <= 0.0) { return false; }
+
+      // offset the file time in whole and fractional seconds separately to
+      // keep sub-sample precision for long files
+      for (auto& t : d_tags) {
+        if (pmt::eqv(t.key, PMTCONSTSTR__rx_time())) {
+          uint64_t sec = pmt::to_uint64(pmt::tuple_ref(t.value, 0));
+          double frac = pmt::to_double(pmt::tuple_ref(t.value, 1)) + (double)pos / rate;
+          uint64_t whole = (uint64_t)frac;
+          tag.key = PMTCONSTSTR__rx_time();
+          tag.value = pmt::make_tuple(pmt::from_uint64(sec + whole),
+                                      pmt::from_double(frac - whole));
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    void file_reader_base::load_cache()
+    {
+        d_cache_checked = true;
+
+        uint64_t nbytes = d_file_size - d_data_offset;
+        if ((d_cache_limit == 0) or (nbytes == 0) or (nbytes > d_cache_limit)) {
+            return;
+        }
+
+        // page aligned anonymous mapping, huge pages if available
+        void* buf = MAP_FAILED;
+        uint64_t alloc = nbytes;
+        if (d_cache_hugepages) {
+            alloc = ((nbytes + HUGEPAGE_BYTES - 1) / HUGEPAGE_BYTES) * HUGEPAGE_BYTES;
+            buf = mmap(NULL,
+                       alloc,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                       -1,
+                       0);
+            if (buf == MAP_FAILED) {
+                GR_LOG_DEBUG(d_logger, "Huge pages unavailable, using normal pages");
+            }
+        }
+        if (buf == MAP_FAILED) {
+            alloc = nbytes;
+            buf = mmap(
+                NULL, alloc, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buf == MAP_FAILED) {
+                GR_LOG_WARN(d_logger, "Unable to allocate file cache");
+                return;
+            }
+        }
+
+        // fill from the data offset, independent of the stream position
+        char* dest = (char*)buf;
+        uint64_t pos = 0;
+        while (pos < nbytes) {
+            ssize_t n = pread(fileno(d_fp), dest + pos, nbytes - pos, d_data_offset + pos);
+            if (n <= 0) {
+                GR_LOG_WARN(d_logger,
+                            boost::format("Unable to cache %s, reading from file") %
+                                d_filename);
+                munmap(buf, alloc);
+                return;
+            }
+            pos += n;
+        }
+
+        d_cache = dest;
+        d_cache_size = nbytes;
+        d_cache_alloc = alloc;
+        d_cache_pos = std::min((uint64_t)(ftello(d_fp) - d_data_offset), nbytes);
+
+        GR_LOG_DEBUG(d_logger,
+                     boost::format("Cached %d bytes of %s") % nbytes % d_filename);
+    }
+
+    void file_reader_base::free_cache()
+    {
+        if (d_cache) {
+            munmap(d_cache, d_cache_alloc);
+            d_cache = NULL;
+            d_cache_size = 0;
+            d_cache_alloc = 0;
+            d_cache_pos = 0;
+        }
+    }
+
+    int file_reader_base::read_impl(char *dest, int nitems)
+    {
+      if (not d_is_open) { return 0; }
+
+      if (not d_cache_checked) { load_cache(); }
+
+      if (d_cache) {
+        uint64_t n = std::min((uint64_t)nitems, (d_cache_size - d_cache_pos) / d_disk_itemsize);
+        memcpy(dest, d_cache + d_cache_pos, n * d_disk_itemsize);
+        d_cache_pos += n * d_disk_itemsize;
+        return n;
+      }
+
+      return fread(dest, d_disk_itemsize, nitems, (FILE *)d_fp);
     }
 
     /**
      * Read items from file.
-     * Number of bytes read from file is based on #d_itemsize
+     * When striding, reads stop at the end of each kept block and the
+     * position then moves to the start of the next one, so the skipped
+     * items are never read. Uncached files read each kept block with
+     * pread() at its offset instead of seeking the stream.
      *
      * @param dest - destination storage for sample
      * @param nitems - number of items to ready
@@ -103,10 +486,139 @@ namespace gr {
      */
     int file_reader_base::read(char *dest, int nitems)
     {
-      if (d_is_open) {
-        return fread(dest, d_itemsize,nitems,(FILE *)d_fp);
+      // the cache decides how strided reads are done, load it first
+      if (not d_cache_checked and (d_fp != NULL)) { load_cache(); }
+      if (not d_stride_checked) { check_stride(); }
+
+      d_read_pos = tell();
+      if (d_stride_items == 0) {
+        return read_convert(dest, nitems);
+      }
+
+      uint64_t end = this->nitems();
+      uint64_t phase = d_read_pos % d_stride_items;
+      if (phase >= d_stride_keep) {
+        // moved into a skipped region, continue with the next block
+        d_read_pos += d_stride_items - phase;
+        phase = 0;
+        if (d_read_pos >= end) {
+          seek(end, SEEK_SET);
+          return 0;
+        }
+        seek(d_read_pos, SEEK_SET);
+      }
+
+      int nread;
+      uint64_t count = std::min((uint64_t)nitems, d_stride_keep - phase);
+      if (d_stride_pread) {
+        // read the kept block in place, no seek and no stdio buffering
+        if (d_read_pos >= end) { return 0; }
+        nread = read_at(dest, d_read_pos, (int)std::min(count, end - d_read_pos));
+        d_stride_pos += std::max(nread, 0);
+      } else {
+        nread = read_convert(dest, (int)count);
+      }
+      if ((nread > 0) and (phase + nread == d_stride_keep)) {
+        seek(std::min(d_read_pos - phase + d_stride_items, end), SEEK_SET);
+      }
+
+      return nread;
+    }
+
+    /**
+     * Read items from file.
+     * Number of bytes read from file is based on #d_disk_itemsize, which
+     * is converted into #d_itemsize output items if the formats differ
+     *
+     * @param dest - destination storage for sample
+     * @param nitems - number of items to ready
+     * @return int - number of items read. 0 on EOF or error
+     */
+    int file_reader_base::read_convert(char *dest, int nitems)
+    {
+      if (d_disk_type.empty()) {
+        return read_impl(dest, nitems);
+      }
+
+      if (not d_cache_checked and (d_fp != NULL)) { load_cache(); }
+
+      // cached samples are converted straight out of memory
+      if (d_cache) {
+        uint64_t n = std::min((uint64_t)nitems, (d_cache_size - d_cache_pos) / d_disk_itemsize);
+        convert(dest, d_cache + d_cache_pos, n);
+        d_cache_pos += n * d_disk_itemsize;
+        return n;
+      }
+
+      // stage the raw samples read from the file, then convert in a single
+      // pass
+      char *raw = stage(nitems);
+      int nread = read_impl(raw, nitems);
+      if (nread <= 0) {
+        return nread;
+      }
+
+      convert(dest, raw, nread);
+
+      return nread;
+    }
+
+    int file_reader_base::read_at(char *dest, uint64_t pos, int nitems)
+    {
+      char *raw = d_disk_type.empty() ? dest : stage(nitems);
+      size_t nbytes = (size_t)nitems * d_disk_itemsize;
+      off_t offset = d_data_offset + pos * d_disk_itemsize;
+
+      size_t done = 0;
+      while (done < nbytes) {
+        ssize_t n = pread(fd(), raw + done, nbytes - done, offset + done);
+        if ((n < 0) and (errno == EINTR)) { continue; }
+        if (n <= 0) { break; }
+        done += n;
+      }
+
+      int nread = done / d_disk_itemsize;
+      if ((nread > 0) and (raw != dest)) {
+        convert(dest, raw, nread);
+      }
+
+      return nread;
+    }
+
+    char *file_reader_base::stage(int nitems)
+    {
+      size_t nbytes = (size_t)nitems * d_disk_itemsize;
+      if (nbytes > d_stage_size) {
+        if (d_stage) { volk_free(d_stage); }
+        d_stage = (char *)volk_malloc(nbytes, volk_get_alignment());
+        d_stage_size = nbytes;
+      }
+
+      return d_stage;
+    }
+
+    /**
+     * Converts items from the on-disk format into the output format
+     *
+     * @param dest - destination storage for nitems output items
+     * @param src - nitems items in the on-disk format
+     * @param nitems - number of items to convert
+     */
+    void file_reader_base::convert(char *dest, const char *src, int nitems)
+    {
+      if (d_disk_type.empty()) {
+        memcpy(dest, src, (size_t)nitems * d_itemsize);
+        return;
+      }
+
+      float scale = (d_disk_scale > 0.0) ? (float)d_disk_scale : 1.0;
+
+      unsigned int nfloats = nitems * (d_itemsize / sizeof(float));
+      if (d_disk_type == "sc16") {
+        volk_16i_s32f_convert_32f((float *)dest, (const int16_t *)src, scale, nfloats);
+      } else {
+        volk_8i_s32f_convert_32f((float *)dest, (const int8_t *)src, scale, nfloats);
       }
-      else { return 0; }
     }
 
   } /* namespace sandia_utils */
@@ -61,14 +61,150 @@ namespace gr
         bool d_is_open;
         std::string d_filename;
         FILE *d_fp;
-        int d_file_size;
+        uint64_t d_file_size;
+
+        // byte offset of the first sample (non-zero for files with a header)
+        uint64_t d_data_offset;
 
         // metadata tags
         std::vector<gr::tag_t> d_tags;
 
+        // on-disk sample format when it differs from the output format,
+        // converted to float on read
+        std::string d_disk_type;
+        size_t d_disk_itemsize;
+        double d_disk_scale;
+        char *d_stage;
+        size_t d_stage_size;
+
+        // true if the reader selected the disk type from the file metadata,
+        // cleared when the user sets one with set_disk_type()
+        bool d_auto_disk_type;
+
+        // in-memory copy of the sample data of small files, so repeated
+        // passes do not go back to the file
+        uint64_t d_cache_limit;
+        bool d_cache_hugepages;
+        char *d_cache;
+        uint64_t d_cache_size;
+        uint64_t d_cache_alloc;
+        uint64_t d_cache_pos;
+        bool d_cache_checked;
+
+        // quick-look striding, keep d_stride_keep items out of every
+        // d_stride items, or every d_stride_period seconds of the file
+        uint64_t d_stride_keep;
+        uint64_t d_stride;
+        double d_stride_period;
+        uint64_t d_stride_items;
+        bool d_stride_checked;
+
+        // item offset of the first item returned by the last read
+        uint64_t d_read_pos;
+
+        // strided reads of an uncached file use positional reads and track
+        // the position here, the FILE* position is left alone
+        bool d_stride_pread;
+        uint64_t d_stride_pos;
+
+        /**
+         * Applies a disk type without changing who chose it
+         *
+         * @param type - "" for none, or one of fc32, sc16, sc8
+         * @param scale - full scale value, zero uses 1.0
+         */
+        void apply_disk_type( std::string type, double scale );
+
+        /**
+         * Selects the disk type from the file metadata. Readers call this
+         * on open, it does not override a type the user set explicitly.
+         *
+         * @param type - "" for none, or one of sc16, sc8
+         */
+        void set_auto_disk_type( std::string type );
+
+        /**
+         * Loads the sample data into memory if caching is enabled and the
+         * file is small enough. Called on first read, after any header has
+         * been parsed.
+         */
+        void load_cache();
+
+        /**
+         * Releases the cache buffer
+         */
+        void free_cache();
+
+        /**
+         * Resolves the stride of the open file, converting a stride period
+         * with the file sample rate. Called on first read, after any header
+         * has been parsed.
+         */
+        void check_stride();
+
+        /**
+         * Sets #d_stride_items from the configured stride or stride period
+         */
+        void resolve_stride();
+
+        /**
+         * Sets the kernel access pattern of the open file, sequential
+         * readahead unless skipping through the file
+         */
+        void advise();
+
+        /**
+         * Reads items and converts them from the on-disk format
+         *
+         * @param dest - destination storage for sample
+         * @param nitems - number of items to ready
+         * @return int - number of items read. 0 on EOF or error
+         */
+        int read_convert( char *dest, int nitems );
+
+        /**
+         * Reads items at an item offset with pread() and converts them from
+         * the on-disk format. Does not use or move the FILE* position.
+         *
+         * @param dest - destination storage for sample
+         * @param pos - item offset from the first sample
+         * @param nitems - number of items to read
+         * @return int - number of items read. 0 on EOF or error
+         */
+        int read_at( char *dest, uint64_t pos, int nitems );
+
+        /**
+         * Returns the staging buffer for raw samples, grown to hold nitems
+         * on-disk items
+         *
+         * @param nitems - number of items to stage
+         * @return char* - staging buffer
+         */
+        char *stage( int nitems );
+
+        /**
+         * Read items from file in the on-disk format.
+         * Number of bytes read from file is based on #d_disk_itemsize
+         *
+         * @param dest - destination storage for sample
+         * @param nitems - number of items to ready
+         * @return int - number of items read. 0 on EOF or error
+         */
+        virtual int read_impl( char *dest, int nitems );
+
       public:
         typedef boost::shared_ptr<file_reader_base> sptr;
 
+        /**
+         * Construct a reader for the specified file type
+         *
+         * @param type - file type, Example Values = raw, raw_header, sigmf, blue, bluefile
+         * @param itemsize - per item size in bytes
+         * @param logger - parent file source logger instance
+         * @return sptr - new reader, throws on an unknown type
+         */
+        static sptr make( std::string type, size_t itemsize, gr::logger_ptr logger );
+
         /**
          * Consructor
          *
@@ -105,14 +241,146 @@ namespace gr
         virtual void close();
 
         /**
-         * Read items from file.
-         * Number of bytes read from file is based on #d_itemsize
+         * Read items from file, converting from the on-disk format if one
+         * is set.
          *
          * @param dest - destination storage for sample
          * @param nitems - number of items to ready
          * @return int - number of items read. 0 on EOF or error
          */
-        virtual int read( char *dest, int nitems );
+        int read( char *dest, int nitems );
+
+        /**
+         * Set the sample format stored in the file when it differs from the
+         * output format. Samples are converted to float while reading.
+         *
+         * @param type - "" for none, or one of sc16, sc8
+         * @param scale - full scale value, samples are divided by it. Zero
+         *                uses 1.0
+         */
+        void set_disk_type( std::string type, double scale );
+
+        /**
+         * Returns the size of an item as stored in the file, which differs
+         * from the output itemsize when a disk type is set
+         *
+         * @return size_t - on-disk itemsize in bytes
+         */
+        size_t disk_itemsize()
+        {
+          return d_disk_itemsize;
+        }
+
+        /**
+         * Converts items from the on-disk format into the output format, for
+         * callers reading the file descriptor directly
+         *
+         * @param dest - destination storage for nitems output items
+         * @param src - nitems items in the on-disk format
+         * @param nitems - number of items to convert
+         */
+        void convert( char *dest, const char *src, int nitems );
+
+        /**
+         * Keep the sample data of files up to \p max_bytes in memory.
+         * The open file is loaded on the next read if it has not been
+         * cached yet.
+         *
+         * @param max_bytes - largest file to cache, zero disables caching
+         * @param hugepages - back the cache with huge pages when available
+         */
+        void set_cache_size( uint64_t max_bytes, bool hugepages )
+        {
+          d_cache_limit = max_bytes;
+          d_cache_hugepages = hugepages;
+          d_cache_checked = ( d_cache != NULL );
+        }
+
+        /**
+         * Read only \p keep items out of every \p stride items. The items
+         * in between are skipped without being read, so a quick look at a
+         * large file costs a fraction of reading it. Reads never cross the
+         * end of a kept block.
+         *
+         * @param keep - items kept at the start of each block, zero disables
+         * @param stride - block length in items
+         */
+        void set_stride( uint64_t keep, uint64_t stride );
+
+        /**
+         * Read only \p keep items out of every \p period seconds. The
+         * block length is taken from the file sample rate, files without
+         * one are read in full.
+         *
+         * @param keep - items kept at the start of each block, zero disables
+         * @param period - block length in seconds
+         */
+        void set_stride_period( uint64_t keep, double period );
+
+        /**
+         * Returns the time tag of a kept block when \p pos starts one.
+         * The tag carries the rx_time of the block start, derived from the
+         * file start time and sample rate.
+         *
+         * @param pos - item offset from the first sample
+         * @param tag - rx_time tag, offset not set
+         * @return bool - true if \p pos starts a kept block with a known time
+         */
+        bool stride_tag( uint64_t pos, gr::tag_t &tag );
+
+        /**
+         * Returns the item offset of the first item returned by the last
+         * read(). Strided reads may move past skipped items first, so this
+         * is not always the position before the read.
+         *
+         * @return uint64_t - item offset from the first sample
+         */
+        uint64_t read_pos()
+        {
+          return d_read_pos;
+        }
+
+        /**
+         * Returns true if the open file is served from memory
+         *
+         * @return bool - true if cached
+         */
+        bool is_cached()
+        {
+          return d_cache != NULL;
+        }
+
+        /**
+         * Returns the current read position
+         *
+         * @return uint64_t - item offset from the first sample
+         */
+        virtual uint64_t tell();
+
+        /**
+         * Returns true if the format has tags placed within the file that
+         * must be collected with range_tags() as the file is read
+         *
+         * @return bool - true if the format has in-file tags
+         */
+        virtual bool has_range_tags()
+        {
+          return false;
+        }
+
+        /**
+         * Returns the tags placed within the file between \p start and
+         * \p start + \p nitems. Tag offsets are item offsets from the first
+         * sample of the file.
+         *
+         * @param start - item offset of the first item read
+         * @param nitems - number of items read
+         * @return vector<gr::tag_t> - tags in the range
+         */
+        virtual std::vector<gr::tag_t> range_tags( uint64_t start, uint64_t nitems )
+        {
+          return std::vector<gr::tag_t>();
+        }
 
         /**
          * Returns tags vector
@@ -140,8 +408,71 @@ namespace gr
          */
         virtual bool eof()
         {
-          return (ftell( d_fp ) == d_file_size);
+          // a trailing partial item is never returned, and strided reads
+          // stop at the last whole item
+          return tell() >= nitems();
+        }
+
+        /**
+         * Returns the name of the currently open file
+         *
+         * @return string - filename
+         */
+        std::string get_filename()
+        {
+          return d_filename;
+        }
+
+        /**
+         * Returns the descriptor of the open file for positional reads
+         *
+         * @return int - file descriptor, or -1 if the format does not use one
+         */
+        virtual int fd()
+        {
+          return (d_is_open and (d_fp != NULL)) ? fileno( d_fp ) : -1;
+        }
+
+        /**
+         * Returns the byte offset of the first sample in the file
+         *
+         * @return uint64_t - data offset in bytes
+         */
+        uint64_t data_offset()
+        {
+          return d_data_offset;
+        }
+
+        /**
+         * Returns the number of items in the file, excluding any header
+         *
+         * @return uint64_t - number of items
+         */
+        virtual uint64_t nitems()
+        {
+          return (d_file_size - d_data_offset) / d_disk_itemsize;
         }
+
+        /**
+         * Returns the time of the first sample from the file metadata
+         *
+         * @return double - epoch seconds, or a negative value if unknown
+         */
+        double get_start_time();
+
+        /**
+         * Returns the sample rate from the file metadata
+         *
+         * @return double - sample rate (Hz), or zero if unknown
+         */
+        double get_rate();
+
+        /**
+         * Hint to the kernel that the beginning of the file will be read
+         * soon so the first reads after a file switch are served from the
+         * page cache instead of blocking on the disk.
+         */
+        virtual void prefetch();
     }; //end class file_reader_base
 
   } // namespace sandia_utils
@@ -0,0 +1,280 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_reader_blue.h"
+#include <gnuradio/sandia_utils/constants.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+// size of the BLUE header control block
+#define BLUE_HCB_BYTES 512
+
+// seconds from the BLUE epoch (1950-01-01) to the unix epoch
+#define BLUE_EPOCH_OFFSET 631152000.0
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    namespace
+    {
+      // header fields are stored in the byte order named by head_rep
+      template <typename T>
+      T hcb_get( const char *buf, size_t offset, bool swap )
+      {
+        T value;
+        memcpy( &value, buf + offset, sizeof(T) );
+        if( swap )
+        {
+          char *p = (char *)&value;
+          std::reverse( p, p + sizeof(T) );
+        }
+        return value;
+      }
+
+      // ascii keyword values are converted to numbers where possible
+      pmt::pmt_t ascii_to_pmt( const std::string &value )
+      {
+        try
+        {
+          size_t idx;
+          double d = std::stod( value, &idx );
+          if( idx == value.size() )
+          {
+            return pmt::from_double( d );
+          }
+        }
+        catch( ... )
+        {
+        }
+
+        return pmt::string_to_symbol( value );
+      }
+    }
+
+    void file_reader_blue::open( const char *filename )
+    {
+      file_reader_base::open( filename );
+
+      char hcb[BLUE_HCB_BYTES];
+      if( pread( fileno( d_fp ), hcb, BLUE_HCB_BYTES, 0 ) != BLUE_HCB_BYTES )
+      {
+        throw std::runtime_error( "Unable to read BLUE header" );
+      }
+      if( strncmp( hcb, "BLUE", 4 ) != 0 )
+      {
+        throw std::runtime_error( str( boost::format( "%s is not a BLUE file" ) % filename ) );
+      }
+
+      // EEEI is little endian, IEEE big endian
+      bool swap = ( strncmp( hcb + 4, "IEEE", 4 ) == 0 );
+      bool data_swap = ( strncmp( hcb + 8, "IEEE", 4 ) == 0 );
+
+      if( hcb_get<int32_t>( hcb, 12, swap ) != 0 )
+      {
+        throw std::runtime_error( "Detached BLUE files are not supported" );
+      }
+
+      int32_t ext_start = hcb_get<int32_t>( hcb, 24, swap );
+      int32_t ext_size = hcb_get<int32_t>( hcb, 28, swap );
+      double data_start = hcb_get<double>( hcb, 32, swap );
+      double data_size = hcb_get<double>( hcb, 40, swap );
+      int32_t type = hcb_get<int32_t>( hcb, 48, swap );
+      d_format = std::string( hcb + 52, 2 );
+      double timecode = hcb_get<double>( hcb, 56, swap );
+      int32_t keylength = hcb_get<int32_t>( hcb, 160, swap );
+      double xstart = hcb_get<double>( hcb, 256, swap );
+      double xdelta = hcb_get<double>( hcb, 264, swap );
+
+      if( type / 1000 != 1 )
+      {
+        GR_LOG_WARN( d_logger, boost::format( "BLUE type %d is read as a flat sample stream" ) %
+            type );
+      }
+      if( data_swap )
+      {
+        GR_LOG_WARN( d_logger, "BLUE data is big endian, samples are not byte swapped" );
+      }
+
+      // the data region, anything after it (extended header) is not samples
+      d_data_offset = (uint64_t)data_start;
+      d_file_size = std::min( d_file_size, (uint64_t)( data_start + data_size ) );
+      fseeko( d_fp, d_data_offset, SEEK_SET );
+
+      // select the conversion from the file format, unless the user chose
+      // one explicitly
+      std::string disk_type;
+      if( d_itemsize % ( 2 * sizeof(float) ) == 0 )
+      {
+        if( d_format == "CI" )
+        {
+          disk_type = "sc16";
+        }
+        else if( d_format == "CB" )
+        {
+          disk_type = "sc8";
+        }
+      }
+      set_auto_disk_type( disk_type );
+
+      gr::tag_t tag;
+      if( xdelta > 0.0 )
+      {
+        tag.key = PMTCONSTSTR__rate();
+        tag.value = pmt::from_double( 1.0 / xdelta );
+        d_tags.push_back( tag );
+      }
+
+      // time of the first sample, timecode is relative to 1950
+      double start = xstart;
+      if( timecode > 0.0 )
+      {
+        start += timecode - BLUE_EPOCH_OFFSET;
+      }
+      epoch_time file_time( start );
+      tag.key = PMTCONSTSTR__rx_time();
+      tag.value = pmt::make_tuple( pmt::from_uint64( file_time.epoch_sec() ),
+          pmt::from_double( file_time.epoch_frac() ) );
+      d_tags.push_back( tag );
+
+      // main header keywords, NAME=VALUE separated by nulls
+      std::string keywords( hcb + 164, std::min( std::max( keylength, 0 ), 92 ) );
+      size_t pos = 0;
+      while( pos < keywords.size() )
+      {
+        size_t end = keywords.find( '\0', pos );
+        if( end == std::string::npos )
+        {
+          end = keywords.size();
+        }
+        std::string entry = keywords.substr( pos, end - pos );
+        size_t eq = entry.find( '=' );
+        if( eq != std::string::npos )
+        {
+          add_keyword( entry.substr( 0, eq ), ascii_to_pmt( entry.substr( eq + 1 ) ) );
+        }
+        pos = end + 1;
+      }
+
+      if( ( ext_start > 0 ) and ( ext_size > 0 ) )
+      {
+        parse_extended_header( (uint64_t)ext_start * BLUE_HCB_BYTES, ext_size, swap );
+      }
+
+      GR_LOG_DEBUG( d_logger, boost::format( "BLUE file %s: type %d, format %s, %d bytes "
+            "of data at %d" ) % filename % type % d_format % ( d_file_size - d_data_offset ) %
+          d_data_offset );
+    } //end open
+
+    void file_reader_blue::parse_extended_header( uint64_t offset, uint64_t size, bool swap )
+    {
+      std::vector<char> buf( size );
+      if( pread( fileno( d_fp ), buf.data(), size, offset ) != (ssize_t)size )
+      {
+        GR_LOG_WARN( d_logger, "Unable to read BLUE extended header" );
+        return;
+      }
+
+      // each record: int32 lkey (record length), int16 lext (non-data
+      // length), int8 ltag (name length), char type, data, name, padding
+      uint64_t pos = 0;
+      while( pos + 8 <= size )
+      {
+        int32_t lkey = hcb_get<int32_t>( buf.data(), pos, swap );
+        int16_t lext = hcb_get<int16_t>( buf.data(), pos + 4, swap );
+        int8_t ltag = buf[pos + 6];
+        char type = buf[pos + 7];
+        if( ( lkey <= 0 ) or ( pos + lkey > size ) or ( lext > lkey ) or ( ltag < 0 ) or
+            ( lext < 8 + ltag ) )
+        {
+          break;
+        }
+
+        const char *data = buf.data() + pos + 8;
+        size_t ldata = lkey - lext;
+        std::string name( data + ldata, ltag );
+
+        pmt::pmt_t value = pmt::PMT_NIL;
+        switch( type )
+        {
+          case 'A':
+            value = ascii_to_pmt( std::string( data, strnlen( data, ldata ) ) );
+            break;
+          case 'D':
+            if( ldata >= 8 )
+              value = pmt::from_double( hcb_get<double>( data, 0, swap ) );
+            break;
+          case 'F':
+            if( ldata >= 4 )
+              value = pmt::from_double( hcb_get<float>( data, 0, swap ) );
+            break;
+          case 'X':
+            if( ldata >= 8 )
+              value = pmt::from_long( hcb_get<int64_t>( data, 0, swap ) );
+            break;
+          case 'L':
+            if( ldata >= 4 )
+              value = pmt::from_long( hcb_get<int32_t>( data, 0, swap ) );
+            break;
+          case 'I':
+            if( ldata >= 2 )
+              value = pmt::from_long( hcb_get<int16_t>( data, 0, swap ) );
+            break;
+          case 'B':
+            if( ldata >= 1 )
+              value = pmt::from_long( (int8_t)data[0] );
+            break;
+          default:
+            GR_LOG_DEBUG( d_logger, boost::format( "Skipping BLUE keyword %s of type %c" ) %
+                name % type );
+        }
+
+        if( not pmt::is_null( value ) )
+        {
+          add_keyword( name, value );
+        }
+
+        pos += lkey;
+      }
+    }
+
+    void file_reader_blue::add_keyword( const std::string &name, pmt::pmt_t value )
+    {
+      gr::tag_t tag;
+      if( name == "RFFREQ" )
+      {
+        if( not pmt::is_number( value ) )
+        {
+          return;
+        }
+        tag.key = PMTCONSTSTR__rx_freq();
+        tag.value = pmt::from_double( pmt::to_double( value ) );
+      }
+      else
+      {
+        tag.key = pmt::intern( name );
+        tag.value = value;
+      }
+      d_tags.push_back( tag );
+    }
+
+    int file_reader_blue::read_impl( char *dest, int count )
+    {
+      uint64_t remaining = nitems() - tell();
+      return file_reader_base::read_impl( dest, (int)std::min( (uint64_t)count, remaining ) );
+    }
+
+  }
+// namespace sandia_utils
+}// namespace gr
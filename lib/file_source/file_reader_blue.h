@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_FILE_READER_BLUE_H
+#define INCLUDED_SANDIA_UTILS_FILE_READER_BLUE_H
+
+#include "file_reader_base.h"
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * Native BLUE file reader.
+     *
+     * Parses the 512 byte header control block and the main and extended
+     * header keywords itself, then reads the data region through the raw
+     * file path so caching and convert-on-read apply. Does not require the
+     * bluefile library.
+     */
+    class SANDIA_UTILS_API file_reader_blue : public file_reader_base
+    {
+      private:
+        // BLUE format code, e.g. CI, CF, SB
+        std::string d_format;
+
+        /**
+         * Adds a tag for a header keyword. RFFREQ is reported as rx_freq.
+         *
+         * @param name - keyword name
+         * @param value - keyword value
+         */
+        void add_keyword( const std::string &name, pmt::pmt_t value );
+
+        /**
+         * Parses the extended header keywords
+         *
+         * @param offset - byte offset of the extended header
+         * @param size - size of the extended header in bytes
+         * @param swap - true if the header is big endian
+         */
+        void parse_extended_header( uint64_t offset, uint64_t size, bool swap );
+
+      protected:
+        // reads are limited to the data region, the extended header may
+        // follow the data
+        virtual int read_impl( char *dest, int nitems );
+
+      public:
+        file_reader_blue( size_t itemsize, gr::logger_ptr logger )
+          : file_reader_base( itemsize, logger )
+        {
+        }
+        ~file_reader_blue()
+        {
+        }
+
+        virtual void open( const char *filename );
+
+        /**
+         * Returns the BLUE format code of the open file
+         *
+         * @return string - format, e.g. CI
+         */
+        std::string get_format()
+        {
+          return d_format;
+        }
+
+    }; //end class file_reader_blue
+
+  } // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_FILE_READER_BLUE_H */
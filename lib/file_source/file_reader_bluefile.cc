@@ -23,11 +23,13 @@ namespace gr
 
       GR_LOG_DEBUG( d_logger, boost::format("File Reader: Opening file %s") % filename );
       d_filename = std::string( filename );
+      d_stride_checked = false;
+      d_read_pos = 0;
 
       d_blue_reader = new bluefile::BlueFile();
 
       // open file
-      d_file_size = int( d_blue_reader->open( filename, bluefile::BlueFile::READ ) );
+      d_file_size = uint64_t( d_blue_reader->open( filename, bluefile::BlueFile::READ ) );
       d_type = d_blue_reader->get_format();
       d_bpe = d_blue_reader->get_bpe();
       d_bps = d_blue_reader->get_bps();
@@ -75,7 +77,7 @@ namespace gr
       d_is_open = true;
     }
 
-    int file_reader_bluefile::read( char *dest, int nitems )
+    int file_reader_bluefile::read_impl( char *dest, int nitems )
     {
       if( d_blue_reader->is_open() )
       {
@@ -125,7 +127,17 @@ namespace gr
         return true;
       }
 
-      return (int( d_blue_reader->tell() ) == d_file_size);
+      return (uint64_t( d_blue_reader->tell() ) == d_file_size);
+    }
+
+    uint64_t file_reader_bluefile::tell()
+    {
+      if( ( d_blue_reader == NULL ) or ( not d_blue_reader->is_open() ) )
+      {
+        return 0;
+      }
+
+      return uint64_t( d_blue_reader->tell() );
     }
 
   }
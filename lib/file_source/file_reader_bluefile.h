@@ -30,6 +30,9 @@ namespace gr
         int d_bpe;
         int d_bps;
 
+      protected:
+        virtual int read_impl( char *dest, int nitems );
+
       public:
         // typedef boost::shared_ptr<file_reader_base> sptr;
 
@@ -39,7 +42,8 @@ namespace gr
          * @param itemsize - per item size in bytes
          * @param logger - parent file source logger instance
          */
-        file_reader_bluefile( size_t itemsize, gr::logger_ptr logger ) : file_reader_base( itemsize, logger )
+        file_reader_bluefile( size_t itemsize, gr::logger_ptr logger ) : file_reader_base( itemsize, logger ),
+          d_blue_reader( NULL )
         {
         }
         ~file_reader_bluefile()
@@ -48,14 +52,20 @@ namespace gr
 
         virtual void open( const char *filename );
 
-        virtual int read( char *dest, int nitems );
-
         virtual bool seek( long seek_point, int whence );
 
         virtual void close();
 
         virtual bool eof();
 
+        virtual uint64_t tell();
+
+        // the bluefile library reports sizes in elements
+        virtual uint64_t nitems()
+        {
+          return d_file_size;
+        }
+
     };
 
   } // namespace sandia_utils
@@ -0,0 +1,262 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_reader_message.h"
+#include <gnuradio/sandia_utils/constants.h>
+#include <boost/format.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <streambuf>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    namespace
+    {
+      // read-only stream buffer over a mapped record so deserialization does
+      // not need to copy the record into a string first
+      class record_buf : public std::streambuf
+      {
+        public:
+          record_buf( const char *begin, size_t len )
+          {
+            char *p = const_cast<char *>( begin );
+            setg( p, p, p + len );
+          }
+      };
+    }
+
+    file_reader_message::file_reader_message( gr::logger_ptr logger )
+      : d_logger( logger ),
+        d_is_open( false ),
+        d_base( NULL ),
+        d_file_size( 0 ),
+        d_cursor( 0 ),
+        d_indexed( false )
+    {
+    }
+
+    file_reader_message::~file_reader_message()
+    {
+      close();
+    }
+
+    void file_reader_message::open( const char *filename )
+    {
+      close();
+
+      GR_LOG_DEBUG( d_logger, boost::format( "Message Reader: Opening file %s" ) % filename );
+
+      int fd = ::open( filename, O_RDONLY );
+      if( fd < 0 )
+      {
+        throw std::runtime_error(
+          str( boost::format( "Unable to open file %s" ) % filename ) );
+      }
+
+      struct stat st;
+      if( fstat( fd, &st ) < 0 )
+      {
+        ::close( fd );
+        throw std::runtime_error(
+          str( boost::format( "Unable to stat file %s" ) % filename ) );
+      }
+
+      // an empty file is valid, it just has no records
+      d_file_size = st.st_size;
+      if( d_file_size > 0 )
+      {
+        void *base = mmap( NULL, d_file_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( base == MAP_FAILED )
+        {
+          ::close( fd );
+          throw std::runtime_error(
+            str( boost::format( "Unable to map file %s" ) % filename ) );
+        }
+        madvise( base, d_file_size, MADV_SEQUENTIAL );
+        d_base = (const char *)base;
+      }
+
+      // the mapping holds its own reference to the file
+      ::close( fd );
+
+      d_filename = std::string( filename );
+      d_cursor = 0;
+      d_index.clear();
+      d_index_time.clear();
+      d_indexed = false;
+      d_is_open = true;
+    }
+
+    void file_reader_message::close()
+    {
+      if( d_base != NULL )
+      {
+        munmap( (void *)d_base, d_file_size );
+        d_base = NULL;
+      }
+      d_is_open = false;
+      d_file_size = 0;
+      d_cursor = 0;
+    }
+
+    bool file_reader_message::read_record( pmt::pmt_t &msg )
+    {
+      if( not is_open() or eof() )
+      {
+        return false;
+      }
+
+      uint32_t len;
+      memcpy( &len, d_base + d_cursor, sizeof(uint32_t) );
+      if( d_cursor + sizeof(uint32_t) + len > d_file_size )
+      {
+        GR_LOG_ERROR( d_logger, boost::format( "Truncated message at offset %lu" ) % d_cursor );
+        d_cursor = d_file_size;
+        return false;
+      }
+
+      record_buf buf( d_base + d_cursor + sizeof(uint32_t), len );
+      d_cursor += sizeof(uint32_t) + len;
+      if( len == 0 )
+      {
+        msg = pmt::PMT_EOF;
+        return true;
+      }
+
+      try
+      {
+        msg = pmt::deserialize( buf );
+      }
+      catch( ... )
+      {
+        GR_LOG_ERROR( d_logger, "Unable to deserialize message" );
+        return false;
+      }
+
+      return true;
+    }
+
+    bool file_reader_message::next( pmt::pmt_t &msg )
+    {
+      // zero length records are padding, skip them
+      while( read_record( msg ) )
+      {
+        if( not pmt::eq( msg, pmt::PMT_EOF ) )
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    void file_reader_message::build_index()
+    {
+      if( d_indexed )
+      {
+        return;
+      }
+
+      uint64_t cursor = d_cursor;
+      d_cursor = 0;
+
+      pmt::pmt_t msg;
+      uint64_t offset = d_cursor;
+      while( next( msg ) )
+      {
+        d_index.push_back( offset );
+        d_index_time.push_back( msg_time( msg ) );
+        offset = d_cursor;
+      }
+
+      d_cursor = cursor;
+      d_indexed = true;
+
+      GR_LOG_DEBUG( d_logger, boost::format( "Indexed %lu messages in %s" ) %
+                                d_index.size() % d_filename );
+    }
+
+    uint64_t file_reader_message::nmsgs()
+    {
+      build_index();
+      return d_index.size();
+    }
+
+    bool file_reader_message::seek_msg( uint64_t n )
+    {
+      build_index();
+      if( n >= d_index.size() )
+      {
+        return false;
+      }
+
+      d_cursor = d_index[n];
+      return true;
+    }
+
+    bool file_reader_message::seek_time( double time )
+    {
+      build_index();
+
+      // untimed messages do not move the search
+      auto it = std::find_if( d_index_time.begin(), d_index_time.end(),
+                              [time]( double t ) { return t >= time; } );
+      if( it == d_index_time.end() )
+      {
+        return false;
+      }
+
+      d_cursor = d_index[it - d_index_time.begin()];
+      return true;
+    }
+
+    double file_reader_message::msg_time( pmt::pmt_t msg )
+    {
+      // same order of precedence as the file source command port, a bare
+      // dictionary first and then the metadata of a PDU
+      pmt::pmt_t t = pmt::PMT_NIL;
+      if( pmt::is_dict( msg ) )
+      {
+        t = pmt::dict_ref( msg, PMTCONSTSTR__rx_time(), pmt::PMT_NIL );
+      }
+      if( pmt::is_null( t ) and pmt::is_pair( msg ) and pmt::is_dict( pmt::car( msg ) ) )
+      {
+        t = pmt::dict_ref( pmt::car( msg ), PMTCONSTSTR__rx_time(), pmt::PMT_NIL );
+      }
+
+      if( pmt::is_tuple( t ) and ( pmt::length( t ) == 2 ) )
+      {
+        return (double)pmt::to_uint64( pmt::tuple_ref( t, 0 ) ) +
+               pmt::to_double( pmt::tuple_ref( t, 1 ) );
+      }
+      else if( pmt::is_pair( t ) )
+      {
+        return (double)pmt::to_uint64( pmt::car( t ) ) + pmt::to_double( pmt::cdr( t ) );
+      }
+      else if( pmt::is_real( t ) or pmt::is_integer( t ) )
+      {
+        return pmt::to_double( t );
+      }
+
+      return -1.0;
+    }
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
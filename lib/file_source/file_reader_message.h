@@ -0,0 +1,168 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_FILE_READER_MESSAGE_H
+#define INCLUDED_SANDIA_UTILS_FILE_READER_MESSAGE_H
+
+#include <gnuradio/logger.h>
+#include <gnuradio/sandia_utils/api.h>
+#include <pmt/pmt.h>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * Reader for message files written by the file sink in message mode.
+     *
+     * Each record is a native-endian uint32 length followed by a serialized
+     * PMT. The file is memory mapped and records are deserialized in place.
+     * An index of record offsets and times is built on first use so the
+     * reader can seek to the Nth message or to a message time.
+     */
+    class SANDIA_UTILS_API file_reader_message
+    {
+      private:
+        // logger
+        gr::logger_ptr d_logger;
+
+        // mapped file
+        bool d_is_open;
+        std::string d_filename;
+        const char *d_base;
+        uint64_t d_file_size;
+
+        // byte offset of the next record
+        uint64_t d_cursor;
+
+        // record offsets and times (negative if not timed)
+        std::vector<uint64_t> d_index;
+        std::vector<double> d_index_time;
+        bool d_indexed;
+
+        /**
+         * Deserializes the record at the cursor and advances past it
+         *
+         * @param msg - deserialized message
+         * @return bool - false on EOF or a corrupt record
+         */
+        bool read_record( pmt::pmt_t &msg );
+
+        /**
+         * Builds the record offset index by walking the whole file
+         */
+        void build_index();
+
+      public:
+        typedef boost::shared_ptr<file_reader_message> sptr;
+
+        /**
+         * Consructor
+         *
+         * @param logger - parent file source logger instance
+         */
+        file_reader_message( gr::logger_ptr logger );
+
+        /**
+         * Deconstructor
+         */
+        ~file_reader_message();
+
+        /**
+         * Maps a message file. Closes current file if open
+         *
+         * @param filename - filename of file to open
+         */
+        void open( const char *filename );
+
+        /**
+         * Unmaps the open file
+         */
+        void close();
+
+        /**
+         * returns file open status
+         *
+         * @return bool - true if reader is open
+         */
+        bool is_open()
+        {
+          return d_is_open;
+        }
+
+        /**
+         * Returns End Of File( EOF ) status
+         *
+         * @return bool - true if there are no more records
+         */
+        bool eof()
+        {
+          return d_cursor + sizeof(uint32_t) > d_file_size;
+        }
+
+        /**
+         * Returns to the first message in the file
+         */
+        void rewind()
+        {
+          d_cursor = 0;
+        }
+
+        /**
+         * Reads the next message
+         *
+         * @param msg - next message
+         * @return bool - false on EOF or a corrupt record
+         */
+        bool next( pmt::pmt_t &msg );
+
+        /**
+         * Returns the number of messages in the file, building the index if
+         * needed.
+         *
+         * @return uint64_t - number of messages
+         */
+        uint64_t nmsgs();
+
+        /**
+         * Seek to the Nth message in the file
+         *
+         * @param n - message number
+         * @return bool - true on success
+         */
+        bool seek_msg( uint64_t n );
+
+        /**
+         * Seek to the first message with a time at or after \p time. Message
+         * times are assumed to be non-decreasing through the file.
+         *
+         * @param time - epoch seconds
+         * @return bool - true on success
+         */
+        bool seek_time( double time );
+
+        /**
+         * Extracts the rx_time from the metadata of a PDU, or from a bare
+         * metadata dictionary
+         *
+         * @param msg - message
+         * @return double - epoch seconds, or a negative value if not timed
+         */
+        static double msg_time( pmt::pmt_t msg );
+
+    }; //end class file_reader_message
+
+  } // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_FILE_READER_MESSAGE_H */
@@ -32,6 +32,7 @@ namespace gr
         {
           throw std::runtime_error( "Unable to read metadata from file" );
         }
+        d_data_offset = 3 * sizeof(double);
 
         // set timed
         epoch_time file_time( metadata[2] );
@@ -0,0 +1,237 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_reader_sigmf.h"
+#include <gnuradio/sandia_utils/constants.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    namespace
+    {
+      // annotation fields keep their SigMF names, values are converted to
+      // numbers where possible
+      pmt::pmt_t to_pmt( const std::string &value )
+      {
+        if( value == "true" or value == "false" )
+        {
+          return pmt::from_bool( value == "true" );
+        }
+
+        try
+        {
+          size_t idx;
+          double d = std::stod( value, &idx );
+          if( idx == value.size() )
+          {
+            return pmt::from_double( d );
+          }
+        }
+        catch( ... )
+        {
+        }
+
+        return pmt::string_to_symbol( value );
+      }
+
+      bool tag_offset_less( const gr::tag_t &a, const gr::tag_t &b )
+      {
+        return a.offset < b.offset;
+      }
+    }
+
+    double file_reader_sigmf::parse_datetime( const std::string &datetime )
+    {
+      int year, month, day, hour, minute;
+      double second;
+      if( sscanf( datetime.c_str(), "%d-%d-%dT%d:%d:%lf", &year, &month, &day, &hour,
+            &minute, &second ) != 6 )
+      {
+        return -1.0;
+      }
+
+      struct tm t = {};
+      t.tm_year = year - 1900;
+      t.tm_mon = month - 1;
+      t.tm_mday = day;
+      t.tm_hour = hour;
+      t.tm_min = minute;
+      t.tm_sec = 0;
+
+      return (double)timegm( &t ) + second;
+    }
+
+    void file_reader_sigmf::open( const char *filename )
+    {
+      // recording name without the SigMF extension
+      std::string base( filename );
+      for( const char *ext : { ".sigmf-meta", ".sigmf-data", ".sigmf" } )
+      {
+        if( boost::algorithm::ends_with( base, ext ) )
+        {
+          base = base.substr( 0, base.size() - strlen( ext ) );
+          break;
+        }
+      }
+
+      boost::property_tree::ptree meta;
+      try
+      {
+        boost::property_tree::read_json( base + ".sigmf-meta", meta );
+      }
+      catch( boost::property_tree::json_parser_error &e )
+      {
+        throw std::runtime_error(
+          str( boost::format( "Unable to parse SigMF metadata %s: %s" ) %
+            ( base + ".sigmf-meta" ) % e.what() ) );
+      }
+
+      file_reader_base::open( ( base + ".sigmf-data" ).c_str() );
+      d_range_tags.clear();
+
+      // select the conversion from the recording datatype, unless the user
+      // chose one explicitly
+      std::string datatype = meta.get<std::string>( "global.core:datatype", "" );
+      std::string disk_type;
+      if( d_itemsize % ( 2 * sizeof(float) ) == 0 )
+      {
+        if( datatype == "ci16_le" )
+        {
+          disk_type = "sc16";
+        }
+        else if( datatype == "ci8" or datatype == "ci8_le" )
+        {
+          disk_type = "sc8";
+        }
+      }
+      set_auto_disk_type( disk_type );
+      if( boost::algorithm::ends_with( datatype, "_be" ) )
+      {
+        GR_LOG_WARN( d_logger, boost::format( "SigMF datatype %s is big endian, samples are "
+              "not byte swapped" ) % datatype );
+      }
+
+      gr::tag_t tag;
+      double rate = meta.get<double>( "global.core:sample_rate", 0.0 );
+      if( rate > 0.0 )
+      {
+        tag.key = PMTCONSTSTR__rate();
+        tag.value = pmt::from_double( rate );
+        d_tags.push_back( tag );
+      }
+
+      // captures, the first one describes the start of the file
+      boost::property_tree::ptree empty;
+      bool first = true;
+      for( auto &entry : meta.get_child( "captures", empty ) )
+      {
+        const boost::property_tree::ptree &capture = entry.second;
+        uint64_t start = capture.get<uint64_t>( "core:sample_start", 0 );
+
+        if( first )
+        {
+          uint64_t header_bytes = capture.get<uint64_t>( "core:header_bytes", 0 );
+          if( header_bytes )
+          {
+            d_data_offset = header_bytes;
+            fseeko( d_fp, d_data_offset, SEEK_SET );
+          }
+        }
+
+        std::vector<gr::tag_t> tags;
+        boost::optional<double> freq = capture.get_optional<double>( "core:frequency" );
+        if( freq )
+        {
+          tag.key = PMTCONSTSTR__rx_freq();
+          tag.value = pmt::from_double( *freq );
+          tags.push_back( tag );
+        }
+        double t = parse_datetime( capture.get<std::string>( "core:datetime", "" ) );
+        if( t >= 0.0 )
+        {
+          epoch_time capture_time( t );
+          tag.key = PMTCONSTSTR__rx_time();
+          tag.value = pmt::make_tuple( pmt::from_uint64( capture_time.epoch_sec() ),
+              pmt::from_double( capture_time.epoch_frac() ) );
+          tags.push_back( tag );
+        }
+
+        // the start of the file is already covered by the file tags
+        for( auto &tag : tags )
+        {
+          if( first and ( start == 0 ) )
+          {
+            d_tags.push_back( tag );
+          }
+          else
+          {
+            tag.offset = start;
+            d_range_tags.push_back( tag );
+          }
+        }
+        first = false;
+      }
+
+      // annotations
+      for( auto &entry : meta.get_child( "annotations", empty ) )
+      {
+        const boost::property_tree::ptree &annotation = entry.second;
+        pmt::pmt_t dict = pmt::make_dict();
+        for( auto &field : annotation )
+        {
+          if( field.first != "core:sample_start" and field.second.empty() )
+          {
+            dict = pmt::dict_add( dict, pmt::intern( field.first ),
+                to_pmt( field.second.data() ) );
+          }
+        }
+
+        tag.offset = annotation.get<uint64_t>( "core:sample_start", 0 );
+        tag.key = PMTCONSTSTR__annotation();
+        tag.value = dict;
+        d_range_tags.push_back( tag );
+      }
+
+      std::stable_sort( d_range_tags.begin(), d_range_tags.end(), tag_offset_less );
+
+      GR_LOG_DEBUG( d_logger, boost::format( "SigMF recording %s: %s, %d in-file tags" ) %
+          base % datatype % d_range_tags.size() );
+    } //end open
+
+    std::vector<gr::tag_t> file_reader_sigmf::range_tags( uint64_t start, uint64_t nitems )
+    {
+      gr::tag_t key;
+      key.offset = start;
+      auto it = std::lower_bound( d_range_tags.begin(), d_range_tags.end(), key,
+          tag_offset_less );
+
+      std::vector<gr::tag_t> tags;
+      for( ; ( it != d_range_tags.end() ) and ( it->offset < start + nitems ); ++it )
+      {
+        tags.push_back( *it );
+      }
+
+      return tags;
+    }
+
+  }
+// namespace sandia_utils
+}// namespace gr
@@ -0,0 +1,70 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_FILE_READER_SIGMF_H
+#define INCLUDED_SANDIA_UTILS_FILE_READER_SIGMF_H
+
+#include "file_reader_base.h"
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * SigMF recording reader.
+     *
+     * The .sigmf-meta file is parsed once on open. Global rate and the first
+     * capture's frequency and time are reported through get_tags() like the
+     * raw_header format. Later captures and all annotations are reported
+     * through range_tags() at their sample index.
+     */
+    class SANDIA_UTILS_API file_reader_sigmf : public file_reader_base
+    {
+      private:
+        // tags within the recording, sorted by offset
+        std::vector<gr::tag_t> d_range_tags;
+
+        /**
+         * Parses an ISO 8601 UTC timestamp
+         *
+         * @param datetime - timestamp string
+         * @return double - epoch seconds, or a negative value on error
+         */
+        static double parse_datetime( const std::string &datetime );
+
+      public:
+        file_reader_sigmf( size_t itemsize, gr::logger_ptr logger )
+          : file_reader_base( itemsize, logger )
+        {
+        }
+        ~file_reader_sigmf()
+        {
+        }
+
+        /**
+         * Opens a recording. \p filename may name the .sigmf-meta or
+         * .sigmf-data file, or the recording without an extension.
+         *
+         * @param filename - recording to open
+         */
+        virtual void open( const char *filename );
+
+        virtual bool has_range_tags()
+        {
+          return not d_range_tags.empty();
+        }
+
+        virtual std::vector<gr::tag_t> range_tags( uint64_t start, uint64_t nitems );
+
+    }; //end class file_reader_sigmf
+
+  } // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_FILE_READER_SIGMF_H */
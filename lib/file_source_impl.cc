@@ -13,8 +13,10 @@
 
 #include "file_source_impl.h"
 #include <gnuradio/io_signature.h>
+#include <glob.h>
 #include <boost/filesystem.hpp>
-#include <fstream>
+#include <algorithm>
+#include <cmath>
 
 namespace gr {
 namespace sandia_utils {
@@ -32,7 +34,7 @@ namespace sandia_utils {
  *
  * \param itemsize  the size of each item in the file, in bytes
  * \param filename  name of the file to source from
- * \param type file type, Example Values = message, raw, raw_header, bluefile
+ * \param type file type, Example Values = message, raw, raw_header, sigmf, blue, bluefile
  * \param repeat  repeat file from start
  * \param force_new Force open new file upon command, regardless of current status
  */
@@ -48,7 +50,7 @@ file_source::sptr file_source::make(
  *
  * @param itemsize - per item size in bytes
  * @param filename - filename to open as source.
- * @param type - type of file input, Example Values = message, raw, raw_header, bluefile
+ * @param type - type of file input, Example Values = message, raw, raw_header, sigmf, blue, bluefile
  * @param repeat - repeat a single file over and over.
  * @param force_new - Force open new file upon command, regardless of current status
  */
@@ -66,10 +68,19 @@ file_source_impl::file_source_impl(
       d_add_begin_tag(pmt::PMT_NIL),
       d_first_pass(true),
       d_file_queue_depth(DEFAULT_FILE_QUEUE_DEPTH),
+      d_playlist_idx(0),
       d_tag_on_open(false),
       d_tag_now(false),
       d_method_count(0),
-      d_msg_hop_period(0)
+      d_msg_hop_period(0),
+      d_msg_pacing("period"),
+      d_pace_msg_ref(-1.0),
+      d_disk_scale(0.0),
+      d_cache_size(0),
+      d_cache_hugepages(false),
+      d_stride_keep(0),
+      d_stride(0),
+      d_stride_period(0.0)
 {
     d_output_type = std::string(type);
     d_filename = std::string(filename);
@@ -78,23 +89,9 @@ file_source_impl::file_source_impl(
     if (strcmp(type, "message") == 0) {
         // register output port
         message_port_register_out(PMTCONSTSTR__out());
+        d_msg_reader = file_reader_message::sptr(new file_reader_message(d_logger));
     } else {
-        if (strcmp(type, "raw") == 0) {
-            d_reader = file_reader_base::sptr(new file_reader_base(itemsize, d_logger));
-        } else if (strcmp(type, "raw_header") == 0) {
-            d_reader =
-                file_reader_base::sptr(new file_reader_raw_header(itemsize, d_logger));
-        }
-#ifdef HAVE_BLUEFILE_LIB
-        else if (strcmp(type, "bluefile") == 0) {
-            d_reader =
-                file_reader_base::sptr(new file_reader_bluefile(itemsize, d_logger));
-        }
-#endif
-        else {
-            throw std::runtime_error(
-                str(boost::format("Invalid file source format %s") % type));
-        }
+        d_reader = file_reader_base::make(d_output_type, itemsize, d_logger);
 
         // empty list of tags for now
         d_tags.resize(0);
@@ -123,6 +120,11 @@ bool file_source_impl::start()
 {
     // start message generation thread
     if (d_output_type == "message") {
+        {
+            boost::mutex::scoped_lock lock(d_msg_mutex);
+            open_msg_file();
+        }
+
         // NOTE: d_finished should be something explicitly thread safe. But since
         // nothing breaks on concurrent access, I'll just leave it as bool.
         d_finished = false;
@@ -135,6 +137,9 @@ bool file_source_impl::start()
 
 bool file_source_impl::stop()
 {
+    // release an idle work() call
+    d_file_cond.notify_all();
+
     if (d_output_type == "message") {
         // Shut down the thread
         d_finished = true;
@@ -145,78 +150,219 @@ bool file_source_impl::stop()
     return block::stop();
 }
 
-void file_source_impl::run()
+void file_source_impl::_post(pmt::pmt_t which_port, pmt::pmt_t msg)
 {
-    // open file
-    std::string current_file = d_filename;
-    std::ifstream file;
-    GR_LOG_DEBUG(d_logger, str(boost::format("Opening message file: %s") % current_file));
-    file.open(current_file, std::ios::in | std::ios::binary);
-    if (not file.is_open()) {
-        throw std::runtime_error(
-            str(boost::format("Unable to open file %s") % current_file));
+    block::_post(which_port, msg);
+
+    // work() checks the message queue under d_setlock before it waits, so
+    // taking it here means the wakeup cannot fall between the two
+    gr::thread::scoped_lock lock(d_setlock);
+    d_file_cond.notify_all();
+}
+
+void file_source_impl::open_msg_file()
+{
+    if (not d_msg_reader->is_open()) {
+        GR_LOG_DEBUG(d_logger, str(boost::format("Opening message file: %s") % d_filename));
+        d_msg_reader->open(d_filename.c_str());
     }
+}
 
-    while (!d_finished) {
-        boost::this_thread::sleep(
-            boost::posix_time::milliseconds(static_cast<long>(d_msg_hop_period)));
-        if (d_finished) {
-            // close file
-            file.close();
+void file_source_impl::pace_msg(const std::string& pacing,
+                                double t,
+                                boost::chrono::steady_clock::time_point wall_ref,
+                                double msg_ref)
+{
+    if (pacing == "burst") {
+        boost::this_thread::interruption_point();
+        return;
+    }
 
-            return;
+    if ((pacing == "time") and (t >= 0.0) and (msg_ref >= 0.0)) {
+        // monotonic, so clock adjustments neither stall nor burst the replay
+        boost::chrono::steady_clock::time_point due =
+            wall_ref + boost::chrono::microseconds((int64_t)((t - msg_ref) * 1e6));
+        if (due > boost::chrono::steady_clock::now()) {
+            boost::this_thread::sleep_until(due);
+        } else {
+            boost::this_thread::interruption_point();
         }
+        return;
+    }
 
-        // read in message length
-        uint32_t len;
-        file.read((char*)&len, sizeof(uint32_t));
-        if (file.fail()) {
-            GR_LOG_ERROR(d_logger, str(boost::format("Unable to read message length")));
-            break;
-        }
-        GR_LOG_DEBUG(d_logger, str(boost::format("Message length: %u") % len));
-
-        // read in message
-        if (len != 0) {
-            std::string st((size_t)len, 0);
-            file.read((char*)st.c_str(), len);
-            if (file.fail()) {
-                GR_LOG_ERROR(d_logger, str(boost::format("Unable to read message")));
-                break;
-            }
+    // untimed messages fall back to the hop period
+    if (d_msg_hop_period > 0) {
+        boost::this_thread::sleep(
+            boost::posix_time::milliseconds(static_cast<long>(d_msg_hop_period)));
+    } else {
+        boost::this_thread::interruption_point();
+    }
+}
 
-            // deserialize str
-            pmt::pmt_t msg;
-            try {
-                msg = pmt::deserialize_str(st);
-            } catch (...) {
-                GR_LOG_ERROR(d_logger,
-                             str(boost::format("Unable to deserialize message")));
+void file_source_impl::run()
+{
+    pmt::pmt_t msg;
+    uint64_t pass_count = 0;
+    std::string pacing;
+    double t;
+    boost::chrono::steady_clock::time_point wall_ref;
+    double msg_ref;
+    while (!d_finished) {
+        {
+            boost::mutex::scoped_lock lock(d_msg_mutex);
+            if (not d_msg_reader->next(msg)) {
+                // repeat, unless the file did not produce anything
+                if (d_msg_reader->eof() and d_repeat and (pass_count > 0)) {
+                    d_msg_reader->rewind();
+                    d_pace_msg_ref = -1.0;
+                    pass_count = 0;
+                    continue;
+                }
                 break;
             }
-            message_port_pub(PMTCONSTSTR__out(), msg);
-
-            // check if end of file and whether to reopen
-            if (file.peek() == EOF) {
-                if (d_repeat) {
-                    file.seekg(0, file.beg);
-                } else {
-                    break;
-                }
+            pass_count++;
+
+            // the pacing state is changed at runtime, take a copy to wait on
+            pacing = d_msg_pacing;
+            t = (pacing == "time") ? file_reader_message::msg_time(msg) : -1.0;
+
+            // first timed message, or time went backwards (repeat or seek)
+            if ((t >= 0.0) and ((d_pace_msg_ref < 0.0) or (t < d_pace_msg_ref))) {
+                d_pace_wall_ref = boost::chrono::steady_clock::now();
+                d_pace_msg_ref = t;
             }
-        } // end len != 0;
-    }     // end while (!d_finished)
+            wall_ref = d_pace_wall_ref;
+            msg_ref = d_pace_msg_ref;
+        }
+
+        pace_msg(pacing, t, wall_ref, msg_ref);
+        if (d_finished) {
+            return;
+        }
+
+        message_port_pub(PMTCONSTSTR__out(), msg);
+    } // end while (!d_finished)
 } // end run()
 
 // set message hop period
 void file_source_impl::set_msg_hop_period(int period_ms)
 {
     gr::thread::scoped_lock lock(fp_mutex);
-    if (period_ms > 0) {
+    if (period_ms >= 0) {
         d_msg_hop_period = period_ms;
     }
 }
 
+void file_source_impl::set_msg_pacing(const char* mode)
+{
+    std::string pacing(mode);
+    if ((pacing != "period") and (pacing != "burst") and (pacing != "time")) {
+        throw std::runtime_error(
+            str(boost::format("Invalid message pacing %s") % pacing));
+    }
+
+    boost::mutex::scoped_lock lock(d_msg_mutex);
+    d_msg_pacing = pacing;
+    d_pace_msg_ref = -1.0;
+}
+
+bool file_source_impl::seek_msg(uint64_t n)
+{
+    if (not d_msg_reader) {
+        return false;
+    }
+
+    boost::mutex::scoped_lock lock(d_msg_mutex);
+    open_msg_file();
+    d_pace_msg_ref = -1.0;
+    return d_msg_reader->seek_msg(n);
+}
+
+bool file_source_impl::seek_msg_time(double time)
+{
+    if (not d_msg_reader) {
+        return false;
+    }
+
+    boost::mutex::scoped_lock lock(d_msg_mutex);
+    open_msg_file();
+    d_pace_msg_ref = -1.0;
+    return d_msg_reader->seek_time(time);
+}
+
+uint64_t file_source_impl::msg_count()
+{
+    if (not d_msg_reader) {
+        return 0;
+    }
+
+    boost::mutex::scoped_lock lock(d_msg_mutex);
+    open_msg_file();
+    return d_msg_reader->nmsgs();
+}
+
+void file_source_impl::set_disk_type(const char* type, double scale)
+{
+    if (not d_reader) {
+        throw std::runtime_error("Disk types are not supported for message files");
+    }
+
+    gr::thread::scoped_lock lock(d_setlock);
+    d_disk_type = std::string(type);
+    d_disk_scale = scale;
+    d_reader->set_disk_type(d_disk_type, d_disk_scale);
+    if (d_next_reader) {
+        d_next_reader->set_disk_type(d_disk_type, d_disk_scale);
+    }
+}
+
+void file_source_impl::set_cache_size(uint64_t max_bytes, bool hugepages)
+{
+    if (not d_reader) {
+        throw std::runtime_error("Caching is not supported for message files");
+    }
+
+    gr::thread::scoped_lock lock(d_setlock);
+    d_cache_size = max_bytes;
+    d_cache_hugepages = hugepages;
+    d_reader->set_cache_size(d_cache_size, d_cache_hugepages);
+    if (d_next_reader) {
+        d_next_reader->set_cache_size(d_cache_size, d_cache_hugepages);
+    }
+}
+
+void file_source_impl::set_stride(uint64_t keep, uint64_t stride)
+{
+    if (not d_reader) {
+        throw std::runtime_error("Striding is not supported for message files");
+    }
+
+    gr::thread::scoped_lock lock(d_setlock);
+    d_stride_keep = keep;
+    d_stride = stride;
+    d_stride_period = 0.0;
+    d_reader->set_stride(d_stride_keep, d_stride);
+    if (d_next_reader) {
+        d_next_reader->set_stride(d_stride_keep, d_stride);
+    }
+}
+
+void file_source_impl::set_stride_period(uint64_t keep, double period)
+{
+    if (not d_reader) {
+        throw std::runtime_error("Striding is not supported for message files");
+    }
+
+    gr::thread::scoped_lock lock(d_setlock);
+    d_stride_keep = keep;
+    d_stride = 0;
+    d_stride_period = period;
+    d_reader->set_stride_period(d_stride_keep, d_stride_period);
+    if (d_next_reader) {
+        d_next_reader->set_stride_period(d_stride_keep, d_stride_period);
+    }
+}
+
 bool file_source_impl::seek(long seek_point, int whence)
 {
     if (not d_reader->is_open())
@@ -237,6 +383,7 @@ void file_source_impl::open(const char* filename, bool repeat)
     // queue and let work function handle Opening
     if (d_force_new) {
         GR_LOG_DEBUG(d_logger, "Forcing file close and new file open");
+        d_playlist.clear();
         d_reader->close();
         d_reader->open(filename);
         d_tag_now = true;
@@ -263,6 +410,7 @@ void file_source_impl::open(const char* filename, bool repeat)
 
     // attempt to open next files
     open_next();
+    d_file_cond.notify_all();
 }
 
 void file_source_impl::open_next()
@@ -282,11 +430,175 @@ void file_source_impl::open_next()
 
 void file_source_impl::close()
 {
+    d_playlist.clear();
+    if (d_next_reader) {
+        d_next_reader->close();
+    }
+
     if (d_reader->is_open()) {
         d_reader->close();
     }
 }
 
+void file_source_impl::open_playlist(const char* pattern, const char* sort_by)
+{
+    if (not d_reader) {
+        throw std::runtime_error("Playlists are not supported for message files");
+    }
+
+    // expand directory or glob pattern
+    std::vector<std::string> files;
+    boost::filesystem::path path(pattern);
+    if (boost::filesystem::is_directory(path)) {
+        for (auto& entry : boost::filesystem::directory_iterator(path)) {
+            if (boost::filesystem::is_regular_file(entry.path())) {
+                files.push_back(entry.path().string());
+            }
+        }
+    } else {
+        glob_t matches;
+        if (glob(pattern, 0, NULL, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                files.push_back(std::string(matches.gl_pathv[i]));
+            }
+        }
+        globfree(&matches);
+    }
+
+    if (files.empty()) {
+        GR_LOG_ERROR(d_logger, boost::format("no files match %s") % pattern);
+        return;
+    }
+
+    // always sort by name first so equal times keep a stable order
+    std::sort(files.begin(), files.end());
+    if (strcmp(sort_by, "time") == 0) {
+        std::vector<std::pair<double, std::string>> timed;
+        file_reader_base::sptr reader =
+            file_reader_base::make(d_output_type, d_itemsize, d_logger);
+        for (auto& fname : files) {
+            reader->open(fname.c_str());
+            timed.push_back(std::make_pair(reader->get_start_time(), fname));
+            reader->close();
+        }
+        std::stable_sort(timed.begin(),
+                         timed.end(),
+                         [](const std::pair<double, std::string>& a,
+                            const std::pair<double, std::string>& b) {
+                             return a.first < b.first;
+                         });
+        for (size_t i = 0; i < timed.size(); i++) {
+            files[i] = timed[i].second;
+        }
+    } else if (strcmp(sort_by, "name") != 0) {
+        throw std::runtime_error(
+            str(boost::format("Invalid playlist sort order %s") % sort_by));
+    }
+
+    gr::thread::scoped_lock lock(d_setlock);
+
+    // the playlist replaces any queued files
+    {
+        gr::thread::scoped_lock lock(fp_mutex);
+        while (d_file_queue.size()) {
+            d_file_queue.pop();
+        }
+    }
+
+    GR_LOG_DEBUG(d_logger,
+                 boost::format("Opening playlist of %d files from %s") % files.size() %
+                     pattern);
+    d_playlist = files;
+    d_playlist_idx = 0;
+    d_reader->close();
+    d_reader->open(d_playlist[0].c_str());
+    d_tag_now = true;
+    d_first_pass = false;
+
+    playlist_prefetch();
+    d_file_cond.notify_all();
+}
+
+void file_source_impl::playlist_prefetch()
+{
+    size_t next = d_playlist_idx + 1;
+    if (next >= d_playlist.size()) {
+        if (not d_repeat) {
+            if (d_next_reader) {
+                d_next_reader->close();
+            }
+            return;
+        }
+        next = 0;
+    }
+
+    if (not d_next_reader) {
+        d_next_reader = file_reader_base::make(d_output_type, d_itemsize, d_logger);
+        d_next_reader->set_disk_type(d_disk_type, d_disk_scale);
+        d_next_reader->set_cache_size(d_cache_size, d_cache_hugepages);
+        if (d_stride_period > 0.0) {
+            d_next_reader->set_stride_period(d_stride_keep, d_stride_period);
+        } else {
+            d_next_reader->set_stride(d_stride_keep, d_stride);
+        }
+    }
+
+    try {
+        d_next_reader->open(d_playlist[next].c_str());
+        d_next_reader->prefetch();
+    } catch (std::exception& e) {
+        GR_LOG_ERROR(d_logger,
+                     boost::format("unable to open %s: %s") % d_playlist[next] %
+                         e.what());
+        d_next_reader->close();
+    }
+}
+
+bool file_source_impl::playlist_next()
+{
+    // where the current file ends in time
+    double rate = d_reader->get_rate();
+    double start = d_reader->get_start_time();
+    uint64_t nitems = d_reader->nitems();
+    d_reader->close();
+
+    if ((not d_next_reader) or (not d_next_reader->is_open())) {
+        GR_LOG_DEBUG(d_logger, "End of playlist reached");
+        d_playlist.clear();
+        return false;
+    }
+
+    d_playlist_idx++;
+    if (d_playlist_idx >= d_playlist.size()) {
+        d_playlist_idx = 0;
+        d_repeat_cnt++;
+    }
+
+    // the prefetched reader becomes current, the old one is reused for the
+    // next prefetch
+    std::swap(d_reader, d_next_reader);
+
+    // only tag the new file if its header time does not continue the stream
+    double next_rate = d_reader->get_rate();
+    double next_start = d_reader->get_start_time();
+    if ((rate > 0.0) and (start >= 0.0)) {
+        double expected = start + (double)nitems / rate;
+        d_tag_now = (next_rate != rate) or (next_start < 0.0) or
+                    (std::fabs(next_start - expected) > 0.5 / rate);
+    } else {
+        d_tag_now = (next_start >= 0.0);
+    }
+    if (d_tag_now) {
+        GR_LOG_DEBUG(d_logger,
+                     boost::format("Time discontinuity at start of %s") %
+                         d_reader->get_filename());
+    }
+
+    playlist_prefetch();
+
+    return true;
+}
+
 void file_source_impl::set_begin_tag(pmt::pmt_t tag)
 {
     d_add_begin_tag = tag;
@@ -347,14 +659,21 @@ int file_source_impl::work(int noutput_items,
     d_method_count--;
 
     if (not d_reader->is_open()) {
-        // no file ready to be produced...sleep for a bit to avoid
-        // consuming all resources
-        usleep(1);
-        return 0;
+        // no file ready to be produced...block until open() or a PDU
+        // provides one rather than spinning. d_setlock is released while
+        // waiting. A queued PDU is handled once work() returns, so do not
+        // wait if one is already pending
+        if (empty_handled_p()) {
+            d_file_cond.wait_for(lock, boost::chrono::milliseconds(IDLE_WAIT_MS));
+        }
+        if (not d_reader->is_open()) {
+            return 0;
+        }
     }
 
     while (size) {
         // add stream tags if necessary
+        bool file_tagged = d_tag_now;
         if (d_tag_now) {
             d_tags = d_reader->get_tags();
             for (auto tag : d_tags) {
@@ -376,6 +695,29 @@ int file_source_impl::work(int noutput_items,
 
         // read data
         nread = d_reader->read(out, size);
+        uint64_t file_pos = d_reader->read_pos();
+
+        // strided reads jump in time at the start of each kept block, the
+        // file tags already cover the first one
+        gr::tag_t block_tag;
+        if ((nread > 0) and not(file_tagged and (file_pos == 0)) and
+            d_reader->stride_tag(file_pos, block_tag)) {
+            add_item_tag(0,
+                         nitems_written(0) + noutput_items - size,
+                         block_tag.key,
+                         block_tag.value);
+        }
+
+        // tags placed within the file are added as the read crosses them
+        if (d_reader->has_range_tags() and (nread > 0)) {
+            for (auto& tag : d_reader->range_tags(file_pos, nread)) {
+                add_item_tag(0,
+                             nitems_written(0) + noutput_items - size +
+                                 (tag.offset - file_pos),
+                             tag.key,
+                             tag.value);
+            }
+        }
 
         // update pointers
         size -= nread;
@@ -392,8 +734,18 @@ int file_source_impl::work(int noutput_items,
         // We got a zero from read.  This is either EOF or an error.
         // In any event, if we're in repeat mode, seek back to the
         // beginning of the file and try again, otherwise load next file
-        // and process
-        if (not d_repeat) {
+        // and process.  Playlists continue with the prefetched next file.
+        if (d_playlist.size()) {
+            if (d_reader->eof() and playlist_next()) {
+                continue;
+            }
+
+            // playlist exhausted, fall back to queued files
+            d_reader->close();
+            d_playlist.clear();
+            open_next();
+            break;
+        } else if (not d_repeat) {
             // prepare next files
             if (d_reader->eof()) {
                 d_reader->close();
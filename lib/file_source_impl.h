@@ -11,21 +11,21 @@
 #define INCLUDED_SANDIA_UTILS_FILE_SOURCE_IMPL_H
 
 #include "file_source/file_reader_base.h"
-#include "file_source/file_reader_raw_header.h"
+#include "file_source/file_reader_message.h"
 #include <gnuradio/sandia_utils/constants.h>
 #include <gnuradio/sandia_utils/file_source.h>
 #include <gnuradio/tags.h>
+#include <boost/chrono.hpp>
 #include <boost/thread/mutex.hpp>
 #include <queue>
 #include <utility>
 
-// conditional libraries
-#ifdef HAVE_BLUEFILE_LIB
-#include "file_source/file_reader_bluefile.h"
-#endif
-
 #define DEFAULT_FILE_QUEUE_DEPTH 100
 
+// longest time work() blocks waiting for a file before returning to the
+// scheduler
+#define IDLE_WAIT_MS 100
+
 namespace gr {
 namespace sandia_utils {
 
@@ -41,6 +41,10 @@ private:
 
     boost::mutex fp_mutex;
 
+    // signaled when a file is opened, idle work() calls wait on it with
+    // d_setlock
+    gr::thread::condition_variable d_file_cond;
+
     // reader object
     file_reader_base::sptr d_reader;
 
@@ -48,6 +52,12 @@ private:
     std::queue<std::pair<std::string, bool>> d_file_queue;
     size_t d_file_queue_depth;
 
+    // playlist of files streamed back to back, with the next file
+    // opened ahead of time in its own reader
+    std::vector<std::string> d_playlist;
+    size_t d_playlist_idx;
+    file_reader_base::sptr d_next_reader;
+
     // add output tags
     std::vector<gr::tag_t> d_tags;
     bool d_tag_on_open;
@@ -59,9 +69,32 @@ private:
     // message hop period
     int d_msg_hop_period;
 
+    // message file reader and pacing
+    file_reader_message::sptr d_msg_reader;
+    std::string d_msg_pacing;
+    boost::mutex d_msg_mutex;
+
+    // monotonic clock and message time of the first timed message, used to
+    // pace messages on their rx_time
+    boost::chrono::steady_clock::time_point d_pace_wall_ref;
+    double d_pace_msg_ref;
+
     // output type
     std::string d_output_type;
 
+    // on-disk sample type and scale when converting on read
+    std::string d_disk_type;
+    double d_disk_scale;
+
+    // largest file kept in memory, zero disables the cache
+    uint64_t d_cache_size;
+    bool d_cache_hugepages;
+
+    // quick-look striding, zero keep reads whole files
+    uint64_t d_stride_keep;
+    uint64_t d_stride;
+    double d_stride_period;
+
     // current file being processed
     std::string d_filename;
 
@@ -76,7 +109,7 @@ public:
      * @param itemsize - per item size in bytes
      * @param filename - filename to open as source.
      * @param type - type of file input, Example Values = message, raw, raw_header,
-     * bluefile
+     * sigmf, blue, bluefile
      * @param repeat - repeat a single file over and over.
      * @param force_new - Force open new file upon command, regardless of current status
      */
@@ -95,6 +128,15 @@ public:
     bool start();
     bool stop();
 
+    /**
+     * Queues an incoming message and wakes an idle work() call, so a PDU
+     * that opens a file does not wait out the idle timeout
+     *
+     * @param which_port - input message port
+     * @param msg - message to queue
+     */
+    void _post(pmt::pmt_t which_port, pmt::pmt_t msg);
+
     /**
      * Seek in the file source
      *
@@ -115,6 +157,15 @@ public:
     void open(const char* filename, bool repeat);
     void close();
 
+    /**
+     * Stream all files matching a glob pattern, or all files in a
+     * directory, back to back.
+     *
+     * @param pattern - glob pattern or directory
+     * @param sort_by - playlist order, "name" or "time" (header time)
+     */
+    void open_playlist(const char* pattern, const char* sort_by);
+
     /**
      * Gnu Radio entry point to perform work
      *
@@ -135,6 +186,22 @@ public:
 
     void set_msg_hop_period(int period_ms);
 
+    void set_disk_type(const char* type, double scale);
+
+    void set_cache_size(uint64_t max_bytes, bool hugepages);
+
+    void set_stride(uint64_t keep, uint64_t stride);
+
+    void set_stride_period(uint64_t keep, double period);
+
+    void set_msg_pacing(const char* mode);
+
+    bool seek_msg(uint64_t n);
+
+    bool seek_msg_time(double time);
+
+    uint64_t msg_count();
+
 private:
     /**
      * Handles incoming PDUs to the PDU command port. Incoming PDUs
@@ -153,6 +220,40 @@ private:
 
     void open_next(); // get next file to be processed
 
+    /**
+     * Switches to the prefetched next file of the playlist. File tags are
+     * only scheduled if the new file does not continue the previous one in
+     * time or rate.
+     *
+     * @return bool - true if a new file was opened
+     */
+    bool playlist_next();
+
+    /**
+     * Opens and prefetches the file following the current playlist entry
+     */
+    void playlist_prefetch();
+
+    /**
+     * Opens the message file on first use
+     */
+    void open_msg_file();
+
+    /**
+     * Waits until the next message is due according to the pacing mode.
+     * The mode and pacing reference are copied under d_msg_mutex by the
+     * caller, so a runtime set_msg_pacing() does not race the wait
+     *
+     * @param pacing - pacing mode, one of period, burst, time
+     * @param t - rx_time of the message, negative if it has none
+     * @param wall_ref - clock time of the pacing reference
+     * @param msg_ref - message time of the pacing reference, negative if none
+     */
+    void pace_msg(const std::string& pacing,
+                  double t,
+                  boost::chrono::steady_clock::time_point wall_ref,
+                  double msg_ref);
+
     /**
      * Thread function for message source
      */
@@ -0,0 +1,403 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "epoch_time.h"
+#include "multi_file_source_impl.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sandia_utils/constants.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gr {
+namespace sandia_utils {
+
+multi_file_source::sptr multi_file_source::make(size_t itemsize,
+                                                const std::vector<std::string>& filenames,
+                                                const char* type,
+                                                bool align,
+                                                bool repeat)
+{
+    return gnuradio::get_initial_sptr(
+        new multi_file_source_impl(itemsize, filenames, type, align, repeat));
+}
+
+/**
+ * Constructor
+ *
+ * @param itemsize - per item size in bytes
+ * @param filenames - one file per output channel
+ * @param type - type of file input, Example Values = raw, raw_header, sigmf, blue
+ * @param align - align channels on the header time
+ * @param repeat - repeat the files from the aligned start
+ */
+multi_file_source_impl::multi_file_source_impl(size_t itemsize,
+                                               const std::vector<std::string>& filenames,
+                                               const char* type,
+                                               bool align,
+                                               bool repeat)
+    : gr::sync_block("multi_file_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(filenames.size(), filenames.size(), itemsize)),
+      d_itemsize(itemsize),
+      d_nchan(filenames.size()),
+      d_repeat(repeat),
+      d_nitems(0),
+      d_head(0),
+      d_tail(0),
+      d_tail_pos(0),
+      d_count(0),
+      d_eof(false),
+      d_finished(false),
+      d_fill_chunk(nullptr),
+      d_fill_offset(0),
+      d_fill_gen(0),
+      d_fill_pending(0),
+      d_fill_ok(true),
+      d_fill_stop(false)
+{
+    if (d_nchan == 0) {
+        throw std::runtime_error("multi_file_source requires at least one file");
+    }
+
+    // open every channel, the readers parse any header and provide the
+    // file descriptor for positional reads
+    for (auto& fname : filenames) {
+        file_reader_base::sptr reader =
+            file_reader_base::make(std::string(type), itemsize, d_logger);
+        reader->open(fname.c_str());
+        if (reader->fd() < 0) {
+            throw std::runtime_error(
+                str(boost::format("File type %s is not supported for multi-channel "
+                                  "playback") %
+                    type));
+        }
+        d_readers.push_back(reader);
+        d_tags.push_back(reader->get_tags());
+    }
+
+    d_trim.assign(d_nchan, 0);
+    d_stage.resize(d_nchan);
+    if (align) {
+        this->align();
+    }
+
+    d_nitems = UINT64_MAX;
+    for (size_t ch = 0; ch < d_nchan; ch++) {
+        uint64_t n = d_readers[ch]->nitems();
+        d_nitems = std::min(d_nitems, (n > d_trim[ch]) ? n - d_trim[ch] : 0);
+    }
+    if (d_nitems == 0) {
+        GR_LOG_WARN(d_logger, "Channels do not overlap in time, nothing to play");
+    }
+
+    // chunk ring
+    d_chunk_items = std::max((size_t)1, (size_t)MULTI_FILE_SOURCE_CHUNK_BYTES / itemsize);
+    d_chunks.resize(MULTI_FILE_SOURCE_NCHUNKS);
+    for (auto& c : d_chunks) {
+        c.data.resize(d_nchan, std::vector<char>(d_chunk_items * itemsize));
+        c.nitems = 0;
+        c.offset = 0;
+    }
+}
+
+/*
+ * Our virtual destructor.
+ */
+multi_file_source_impl::~multi_file_source_impl()
+{
+    for (auto& reader : d_readers) {
+        reader->close();
+    }
+}
+
+void multi_file_source_impl::align()
+{
+    // latest start time of all channels
+    double start = -1.0;
+    for (auto& reader : d_readers) {
+        double t = reader->get_start_time();
+        if ((t < 0.0) or (reader->get_rate() <= 0.0)) {
+            GR_LOG_WARN(d_logger,
+                        boost::format("%s has no start time, channels not aligned") %
+                            reader->get_filename());
+            return;
+        }
+        start = std::max(start, t);
+    }
+
+    for (size_t ch = 0; ch < d_nchan; ch++) {
+        double rate = d_readers[ch]->get_rate();
+        double t = d_readers[ch]->get_start_time();
+        if (rate != d_readers[0]->get_rate()) {
+            GR_LOG_WARN(d_logger,
+                        boost::format("%s sample rate %f differs from channel 0") %
+                            d_readers[ch]->get_filename() % rate);
+        }
+        d_trim[ch] = (uint64_t)std::llround((start - t) * rate);
+        GR_LOG_DEBUG(d_logger,
+                     boost::format("Channel %d trimmed by %d samples") % ch % d_trim[ch]);
+    }
+
+    // file tags report the aligned start
+    epoch_time aligned(start);
+    pmt::pmt_t time = pmt::make_tuple(pmt::from_uint64(aligned.epoch_sec()),
+                                      pmt::from_double(aligned.epoch_frac()));
+    for (size_t ch = 0; ch < d_nchan; ch++) {
+        for (auto& tag : d_tags[ch]) {
+            if (pmt::eqv(tag.key, PMTCONSTSTR__rx_time())) {
+                tag.value = time;
+            }
+        }
+    }
+}
+
+bool multi_file_source_impl::start()
+{
+    d_finished = false;
+    d_eof = false;
+    d_head = d_tail = d_count = 0;
+    d_tail_pos = 0;
+
+    // workers for channels 1 and up, started before the first fill
+    d_fill_stop = false;
+    uint64_t gen = d_fill_gen;
+    for (size_t ch = 1; ch < d_nchan; ch++) {
+        d_workers.push_back(boost::shared_ptr<gr::thread::thread>(
+            new gr::thread::thread([this, ch, gen]() { this->read_worker(ch, gen); })));
+    }
+    d_thread = boost::shared_ptr<gr::thread::thread>(
+        new gr::thread::thread([this]() { this->run(); }));
+
+    return block::start();
+}
+
+bool multi_file_source_impl::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_finished = true;
+        d_cond.notify_all();
+    }
+    if (d_thread) {
+        d_thread->join();
+        d_thread.reset();
+    }
+
+    // the reader thread is gone, no fill is waiting on the workers
+    {
+        boost::mutex::scoped_lock lock(d_fill_mutex);
+        d_fill_stop = true;
+        d_fill_cond.notify_all();
+    }
+    for (auto& worker : d_workers) {
+        worker->join();
+    }
+    d_workers.clear();
+
+    return block::stop();
+}
+
+bool multi_file_source_impl::fill(chunk& c, uint64_t offset)
+{
+    c.offset = offset;
+    c.nitems = std::min((uint64_t)d_chunk_items, d_nitems - offset);
+
+    // queue the reads of the following chunk on every channel so the disk
+    // works on all of them while this chunk is copied
+    for (size_t ch = 0; ch < d_nchan; ch++) {
+        size_t disk_itemsize = d_readers[ch]->disk_itemsize();
+        off_t next = d_readers[ch]->data_offset() +
+                     (d_trim[ch] + offset + c.nitems) * disk_itemsize;
+        posix_fadvise(
+            d_readers[ch]->fd(), next, c.nitems * disk_itemsize, POSIX_FADV_WILLNEED);
+    }
+
+    // every channel is read at once, channel 0 on this thread and the
+    // others on their workers
+    {
+        boost::mutex::scoped_lock lock(d_fill_mutex);
+        d_fill_chunk = &c;
+        d_fill_offset = offset;
+        d_fill_pending = d_workers.size();
+        d_fill_ok = true;
+        d_fill_gen++;
+        d_fill_cond.notify_all();
+    }
+
+    bool ok = fill_channel(0, c, offset);
+
+    boost::mutex::scoped_lock lock(d_fill_mutex);
+    while (d_fill_pending) {
+        d_fill_cond.wait(lock);
+    }
+
+    return ok and d_fill_ok;
+}
+
+bool multi_file_source_impl::fill_channel(size_t ch, chunk& c, uint64_t offset)
+{
+    // files stored in another sample format are read in their own itemsize
+    // and converted into the chunk
+    size_t disk_itemsize = d_readers[ch]->disk_itemsize();
+    bool convert = (disk_itemsize != d_itemsize);
+    std::vector<char>& stage = d_stage[ch];
+    if (convert and (stage.size() < c.nitems * disk_itemsize)) {
+        stage.resize(d_chunk_items * disk_itemsize);
+    }
+
+    int fd = d_readers[ch]->fd();
+    off_t pos = d_readers[ch]->data_offset() + (d_trim[ch] + offset) * disk_itemsize;
+    char* dest = convert ? stage.data() : c.data[ch].data();
+    size_t remaining = c.nitems * disk_itemsize;
+    while (remaining) {
+        ssize_t n = pread(fd, dest, remaining, pos);
+        if (n <= 0) {
+            GR_LOG_ERROR(d_logger,
+                         boost::format("Unable to read %s") %
+                             d_readers[ch]->get_filename());
+            return false;
+        }
+        dest += n;
+        pos += n;
+        remaining -= n;
+    }
+
+    if (convert) {
+        d_readers[ch]->convert(c.data[ch].data(), stage.data(), c.nitems);
+    }
+
+    return true;
+}
+
+void multi_file_source_impl::read_worker(size_t ch, uint64_t gen)
+{
+    while (true) {
+        chunk* c;
+        uint64_t offset;
+        {
+            boost::mutex::scoped_lock lock(d_fill_mutex);
+            while ((d_fill_gen == gen) and (not d_fill_stop)) {
+                d_fill_cond.wait(lock);
+            }
+            if (d_fill_stop) {
+                return;
+            }
+            gen = d_fill_gen;
+            c = d_fill_chunk;
+            offset = d_fill_offset;
+        }
+
+        bool ok = fill_channel(ch, *c, offset);
+
+        boost::mutex::scoped_lock lock(d_fill_mutex);
+        d_fill_ok = d_fill_ok and ok;
+        if (--d_fill_pending == 0) {
+            d_fill_cond.notify_all();
+        }
+    }
+}
+
+void multi_file_source_impl::run()
+{
+    uint64_t offset = 0;
+    while (true) {
+        // wait for a free chunk
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            while ((d_count == MULTI_FILE_SOURCE_NCHUNKS) and (not d_finished)) {
+                d_cond.wait(lock);
+            }
+            if (d_finished) {
+                return;
+            }
+        }
+
+        // the chunk at head is not visible to work() until counted
+        bool ok = (offset < d_nitems) and fill(d_chunks[d_head], offset);
+
+        boost::mutex::scoped_lock lock(d_mutex);
+        if (not ok) {
+            d_eof = true;
+            d_cond.notify_all();
+            return;
+        }
+
+        offset += d_chunks[d_head].nitems;
+        d_head = (d_head + 1) % MULTI_FILE_SOURCE_NCHUNKS;
+        d_count++;
+        d_cond.notify_all();
+
+        if (offset >= d_nitems) {
+            if (not d_repeat) {
+                d_eof = true;
+                return;
+            }
+            offset = 0;
+        }
+    }
+}
+
+int multi_file_source_impl::work(int noutput_items,
+                                 gr_vector_const_void_star& input_items,
+                                 gr_vector_void_star& output_items)
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        if (d_count == 0) {
+            if (d_eof) {
+                return WORK_DONE;
+            }
+
+            // wait briefly for the reader rather than spinning
+            d_cond.wait_for(lock, boost::chrono::milliseconds(100));
+            if (d_count == 0) {
+                return d_eof ? WORK_DONE : 0;
+            }
+        }
+    }
+
+    // the chunk at tail is owned by work() while counted
+    chunk& c = d_chunks[d_tail];
+    uint64_t nitems = std::min((uint64_t)noutput_items, c.nitems - d_tail_pos);
+
+    // tag the first aligned sample of every pass
+    if ((c.offset == 0) and (d_tail_pos == 0)) {
+        for (size_t ch = 0; ch < d_tags.size(); ch++) {
+            for (auto& tag : d_tags[ch]) {
+                add_item_tag(ch, nitems_written(ch), tag.key, tag.value);
+            }
+        }
+    }
+
+    for (size_t ch = 0; ch < d_nchan; ch++) {
+        memcpy(output_items[ch], c.data[ch].data() + d_tail_pos * d_itemsize,
+               nitems * d_itemsize);
+    }
+    d_tail_pos += nitems;
+
+    if (d_tail_pos == c.nitems) {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_tail = (d_tail + 1) % MULTI_FILE_SOURCE_NCHUNKS;
+        d_tail_pos = 0;
+        d_count--;
+        d_cond.notify_all();
+    }
+
+    return nitems;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
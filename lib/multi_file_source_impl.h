@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_IMPL_H
+#define INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_IMPL_H
+
+#include "file_source/file_reader_base.h"
+#include <gnuradio/sandia_utils/multi_file_source.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+// number of chunks in flight between the reader thread and work()
+#define MULTI_FILE_SOURCE_NCHUNKS 4
+
+// size of one chunk per channel
+#define MULTI_FILE_SOURCE_CHUNK_BYTES (1024 * 1024)
+
+namespace gr {
+namespace sandia_utils {
+
+class multi_file_source_impl : public multi_file_source
+{
+private:
+    // one block of aligned samples for every channel
+    struct chunk {
+        std::vector<std::vector<char>> data;
+        uint64_t nitems;
+        uint64_t offset;
+    };
+
+    size_t d_itemsize;
+    size_t d_nchan;
+    bool d_repeat;
+
+    // per channel readers, used for the header and the file descriptor
+    std::vector<file_reader_base::sptr> d_readers;
+    std::vector<uint64_t> d_trim;
+    uint64_t d_nitems;
+
+    // tags for each channel added at the first aligned sample
+    std::vector<std::vector<gr::tag_t>> d_tags;
+
+    // chunk ring, filled by the reader thread and drained by work()
+    std::vector<chunk> d_chunks;
+    size_t d_chunk_items;
+    size_t d_head;  // next chunk to fill
+    size_t d_tail;  // next chunk to drain
+    uint64_t d_tail_pos;
+    size_t d_count; // chunks ready
+    bool d_eof;
+
+    // raw samples of each channel stored in another format, converted
+    // into the chunk by the reader
+    std::vector<std::vector<char>> d_stage;
+
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+
+    // reader thread objects
+    boost::shared_ptr<gr::thread::thread> d_thread;
+    bool d_finished;
+
+    // one read worker per channel after the first, so the channels of a
+    // chunk are read concurrently. d_fill_gen counts the chunks handed out
+    std::vector<boost::shared_ptr<gr::thread::thread>> d_workers;
+    boost::mutex d_fill_mutex;
+    boost::condition_variable d_fill_cond;
+    chunk* d_fill_chunk;
+    uint64_t d_fill_offset;
+    uint64_t d_fill_gen;
+    size_t d_fill_pending;
+    bool d_fill_ok;
+    bool d_fill_stop;
+
+    /**
+     * Computes the samples to drop from each channel so they all start at
+     * the latest header time
+     */
+    void align();
+
+    /**
+     * Reads one chunk of every channel at the given aligned offset
+     *
+     * @param c - chunk to fill
+     * @param offset - aligned sample offset
+     * @return bool - false on a read error
+     */
+    bool fill(chunk& c, uint64_t offset);
+
+    /**
+     * Reads one channel of a chunk, converting from the on-disk format
+     *
+     * @param ch - channel index
+     * @param c - chunk to fill
+     * @param offset - aligned sample offset
+     * @return bool - false on a read error
+     */
+    bool fill_channel(size_t ch, chunk& c, uint64_t offset);
+
+    /**
+     * Thread function reading one channel of every chunk
+     *
+     * @param ch - channel index
+     * @param gen - d_fill_gen when the worker was started
+     */
+    void read_worker(size_t ch, uint64_t gen);
+
+    /**
+     * Thread function for file reading
+     */
+    void run();
+
+public:
+    /**
+     * Constructor
+     *
+     * @param itemsize - per item size in bytes
+     * @param filenames - one file per output channel
+     * @param type - type of file input, Example Values = raw, raw_header, sigmf, blue
+     * @param align - align channels on the header time
+     * @param repeat - repeat the files from the aligned start
+     */
+    multi_file_source_impl(size_t itemsize,
+                           const std::vector<std::string>& filenames,
+                           const char* type,
+                           bool align,
+                           bool repeat);
+
+    /**
+     * Deconstructor
+     */
+    ~multi_file_source_impl();
+
+    // overloaded block functions
+    bool start();
+    bool stop();
+
+    uint64_t trimmed(size_t chan) const { return d_trim.at(chan); }
+
+    uint64_t nitems() const { return d_nitems; }
+
+    /**
+     * Gnu Radio entry point to perform work
+     *
+     * @param noutput_items - number of items that should be provided
+     * @param input_items -
+     * @param output_items -  storage for output items
+     * @return int - number of items produced
+     */
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+}; // end class multi_file_source_impl
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_MULTI_FILE_SOURCE_IMPL_H */
@@ -16,6 +16,10 @@
 #include <gnuradio/top_block.h>
 #include <pmt/pmt.h>
 #include <boost/test/unit_test.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 
 namespace gr
@@ -54,6 +58,40 @@ namespace gr
         }
     };
 
+    /**
+     * Connects to the local receiver
+     *
+     * @param port - TCP port
+     * @return int - socket, or -1 on error
+     */
+    int connect_client( int port )
+    {
+      int fd = socket( AF_INET, SOCK_STREAM, 0 );
+      struct sockaddr_in addr;
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons( port );
+      addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+      if( connect( fd, (struct sockaddr *)&addr, sizeof(addr) ) != 0 )
+      {
+        close( fd );
+        return -1;
+      }
+      return fd;
+    }
+
+    /**
+     * Sends words in network byte order
+     */
+    void send_words( int fd, const std::vector<uint32_t> &words )
+    {
+      std::vector<uint32_t> be;
+      for( uint32_t w : words )
+      {
+        be.push_back( htonl( w ) );
+      }
+      BOOST_REQUIRE_EQUAL( (ssize_t)( 4 * be.size() ), write( fd, be.data(), 4 * be.size() ) );
+    }
+
     BOOST_FIXTURE_TEST_SUITE( qa_vita49_tcp_msg_source, TestFixture )
 
     BOOST_AUTO_TEST_CASE(test_instantiate)
@@ -119,7 +157,7 @@ namespace gr
       pmt::pmt_t pmt_time = pmt::dict_ref(meta, pmt::intern("time"), pmt::PMT_NIL);
       BOOST_REQUIRE_EQUAL( true, pmt::is_tuple( pmt_time ) );
       BOOST_REQUIRE_EQUAL( (uint64_t)50, pmt::to_uint64(pmt::tuple_ref(pmt_time, 0)) );
-      BOOST_REQUIRE_CLOSE( 0.0000003, pmt::to_double(pmt::tuple_ref(pmt_time, 1)), 1 );
+      BOOST_REQUIRE_EQUAL( 0.0000003, pmt::to_double(pmt::tuple_ref(pmt_time, 1)) );
 
     }
 
@@ -168,11 +206,11 @@ namespace gr
 
 
       printf("Generated Meta: \n%s\n", pmt::write_string(meta).c_str() );
-      BOOST_REQUIRE_EQUAL( true, pmt::dict_has_key( meta, pmt::intern("tx_time") ) );
-      pmt::pmt_t pmt_time = pmt::dict_ref(meta, pmt::intern("tx_time"), pmt::PMT_NIL);
+      BOOST_REQUIRE_EQUAL( true, pmt::dict_has_key( meta, pmt::intern("rx_time") ) );
+      pmt::pmt_t pmt_time = pmt::dict_ref(meta, pmt::intern("rx_time"), pmt::PMT_NIL);
       BOOST_REQUIRE_EQUAL( true, pmt::is_tuple( pmt_time ) );
       BOOST_REQUIRE_EQUAL( (uint64_t)50, pmt::to_uint64(pmt::tuple_ref(pmt_time, 0)) );
-      BOOST_REQUIRE_CLOSE( 0.0000003, pmt::to_double(pmt::tuple_ref(pmt_time, 1)), 1 );
+      BOOST_REQUIRE_EQUAL( 0.0000003, pmt::to_double(pmt::tuple_ref(pmt_time, 1)) );
 
       return;
     } //end test_data1
@@ -277,7 +315,7 @@ namespace gr
 
 
       printf("Generated Meta: \n%s\n", pmt::write_string(meta).c_str() );
-      BOOST_REQUIRE_EQUAL( false, pmt::dict_has_key( meta, pmt::intern("tx_time") ) );
+      BOOST_REQUIRE_EQUAL( false, pmt::dict_has_key( meta, pmt::intern("rx_time") ) );
 
       return;
     } //end test_data1
@@ -318,6 +356,110 @@ namespace gr
     }
 
 
+    /**
+     * Several senders are served at once, each with its own parse state
+     */
+    BOOST_AUTO_TEST_CASE( test_multi_client )
+    {
+      // signal data, UTC + real time stamps, one payload word
+      std::vector<uint32_t> pkt = { 0x00600005, 50, 0, 300000, 0x01020304 };
+
+      dut->setRcvBuf( 1024 * 1024 );
+      tb->start();
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+
+      int fd1 = connect_client( 8107 );
+      int fd2 = connect_client( 8107 );
+      BOOST_REQUIRE( fd1 >= 0 );
+      BOOST_REQUIRE( fd2 >= 0 );
+
+      // split a packet on the first connection around a complete packet on
+      // the second
+      send_words( fd1, std::vector<uint32_t>( pkt.begin(), pkt.begin() + 2 ) );
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+      send_words( fd2, pkt );
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+      send_words( fd1, std::vector<uint32_t>( pkt.begin() + 2, pkt.end() ) );
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+
+      close( fd1 );
+      close( fd2 );
+
+      tb->stop();
+      tb->wait();
+
+      BOOST_REQUIRE_EQUAL( 2, debug_data->num_messages() );
+      for( int i = 0; i < 2; i++ )
+      {
+        std::vector<int16_t> data = pmt::s16vector_elements( pmt::cdr( debug_data->get_message( i ) ) );
+        BOOST_REQUIRE_EQUAL( 2, data.size() );
+        BOOST_REQUIRE_EQUAL( (int16_t )0x0102, data.at(0) );
+        BOOST_REQUIRE_EQUAL( (int16_t )0x0304, data.at(1) );
+      }
+    } //end test_multi_client
+
+    BOOST_AUTO_TEST_CASE( test_stream_routing )
+    {
+      // 0x100 listed on port 0, port 1 goes to the first other stream
+      vita49_tcp_msg_source::sptr router = vita49_tcp_msg_source::make( 8110, false,
+          std::vector<uint32_t>( 1, 0x100 ), 2 );
+      gr::blocks::message_debug::sptr debug[3];
+      for( int i = 0; i < 3; i++ )
+      {
+        debug[i] = gr::blocks::message_debug::make();
+      }
+      gr::blocks::message_debug::sptr debug_tune0 = gr::blocks::message_debug::make();
+      tb->msg_connect(router, "out0", debug[0], "store");
+      tb->msg_connect(router, "out1", debug[1], "store");
+      tb->msg_connect(router, "out", debug[2], "store");
+      tb->msg_connect(router, "tune0", debug_tune0, "store");
+
+      ContextPacket ctx;
+      ctx.getHeader()->setType( PacketType::CONTEXT );
+      ctx.setStreamId( 0x100 );
+      ctx.getValues()->push_back( new CifValue( 27, 2440000000 ) );
+
+      VRTPacket pkt;
+      pkt.getHeader()->setType( PacketType::SIGNAL_DATA_ID );
+      pkt.getPayload()->push_back( 0x01020304 );
+
+      tb->start();
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+
+      vita49_tcp_msg_source_impl *raw = (vita49_tcp_msg_source_impl*)router.get();
+      raw->received_packet( PacketType::CONTEXT, &ctx );
+      for( uint32_t sid : { 0x100, 0x200, 0x300, 0x200 } )
+      {
+        pkt.setStreamId( sid );
+        raw->received_packet( PacketType::SIGNAL_DATA_ID, &pkt );
+      }
+
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+      tb->stop();
+      tb->wait();
+
+      BOOST_REQUIRE_EQUAL( 1, debug_tune0->num_messages() );
+      BOOST_REQUIRE_EQUAL( 1, debug[0]->num_messages() );
+      BOOST_REQUIRE_EQUAL( 2, debug[1]->num_messages() );
+      BOOST_REQUIRE_EQUAL( 1, debug[2]->num_messages() );
+
+      // the stream's last context travels with its data
+      pmt::pmt_t meta = pmt::car( debug[0]->get_message( 0 ) );
+      BOOST_REQUIRE_EQUAL( (uint64_t)0x100,
+          pmt::to_uint64( pmt::dict_ref( meta, pmt::intern("stream_id"), pmt::PMT_NIL ) ) );
+      pmt::pmt_t context = pmt::dict_ref( meta, pmt::intern("context"), pmt::PMT_NIL );
+      BOOST_REQUIRE_CLOSE( 2440000000,
+          pmt::to_double( pmt::dict_ref( context, pmt::intern("lo_freq"), pmt::PMT_NIL ) ), 1 );
+
+      meta = pmt::car( debug[1]->get_message( 0 ) );
+      BOOST_REQUIRE_EQUAL( (uint64_t)0x200,
+          pmt::to_uint64( pmt::dict_ref( meta, pmt::intern("stream_id"), pmt::PMT_NIL ) ) );
+      BOOST_REQUIRE_EQUAL( false, pmt::dict_has_key( meta, pmt::intern("context") ) );
+
+      return;
+    } //end test_stream_routing
+
+
     BOOST_AUTO_TEST_SUITE_END()
   } /* namespace sandia_utils */
 } /* namespace gr */
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/attributes.h>
+#include <gnuradio/blocks/message_debug.h>
+#include <gnuradio/sandia_utils/vita49_udp_msg_source.h>
+#include <gnuradio/top_block.h>
+#include <pmt/pmt.h>
+#include <boost/test/unit_test.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    class UdpTestFixture
+    {
+      public:
+
+        gr::sandia_utils::vita49_udp_msg_source::sptr dut;
+        gr::blocks::message_debug::sptr debug_cmd;
+        gr::blocks::message_debug::sptr debug_data;
+        gr::top_block_sptr tb;
+
+        UdpTestFixture()
+        {
+          tb = gr::make_top_block("t3");
+
+          dut = gr::sandia_utils::vita49_udp_msg_source::make( 8108 );
+
+          debug_cmd = gr::blocks::message_debug::make();
+          debug_data = gr::blocks::message_debug::make();
+
+          tb->msg_connect(dut, "tune", debug_cmd, "store");
+          tb->msg_connect(dut, "out", debug_data, "store");
+        }
+        virtual ~UdpTestFixture()
+        {
+
+        }
+    };
+
+    /**
+     * Sends words in network byte order as one datagram
+     */
+    void send_datagram( int port, const std::vector<uint32_t> &words )
+    {
+      int fd = socket( AF_INET, SOCK_DGRAM, 0 );
+      struct sockaddr_in addr;
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons( port );
+      addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+      std::vector<uint32_t> be;
+      for( uint32_t w : words )
+      {
+        be.push_back( htonl( w ) );
+      }
+      BOOST_REQUIRE_EQUAL( (ssize_t)( 4 * be.size() ), sendto( fd, be.data(), 4 * be.size(), 0,
+            (struct sockaddr *)&addr, sizeof(addr) ) );
+      close( fd );
+    }
+
+    BOOST_FIXTURE_TEST_SUITE( qa_vita49_udp_msg_source, UdpTestFixture )
+
+    BOOST_AUTO_TEST_CASE( test_udp_data )
+    {
+      // signal data, UTC + real time stamps, one payload word
+      std::vector<uint32_t> pkt = { 0x00600005, 50, 0, 300000, 0x01020304 };
+
+      dut->setRcvBuf( 1024 * 1024 );
+      dut->setHostTimestamps( true );
+      tb->start();
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+
+      send_datagram( 8108, pkt );
+      // a datagram that is not a whole packet is dropped
+      send_datagram( 8108, std::vector<uint32_t>( pkt.begin(), pkt.begin() + 3 ) );
+      send_datagram( 8108, pkt );
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+
+      tb->stop();
+      tb->wait();
+
+      BOOST_REQUIRE_EQUAL( 0, debug_cmd->num_messages() );
+      BOOST_REQUIRE_EQUAL( 2, debug_data->num_messages() );
+      BOOST_REQUIRE_EQUAL( (uint64_t)1, dut->getDropCount() );
+      BOOST_REQUIRE_EQUAL( (uint64_t)1, dut->getResyncCount() );
+      BOOST_REQUIRE_EQUAL( (uint64_t)2, dut->getPacketCount() );
+      BOOST_REQUIRE_EQUAL( (uint64_t)( 4 * 5 * 2 + 4 * 3 ), dut->getByteCount() );
+      for( int i = 0; i < 2; i++ )
+      {
+        pmt::pmt_t message = debug_data->get_message( i );
+        pmt::pmt_t meta = pmt::car( message );
+        std::vector<int16_t> data = pmt::s16vector_elements( pmt::cdr( message ) );
+        BOOST_REQUIRE_EQUAL( 2, data.size() );
+        BOOST_REQUIRE_EQUAL( (int16_t )0x0102, data.at(0) );
+        BOOST_REQUIRE_EQUAL( (int16_t )0x0304, data.at(1) );
+
+        BOOST_REQUIRE_EQUAL( true, pmt::dict_has_key( meta, pmt::intern("rx_time") ) );
+        BOOST_REQUIRE_EQUAL( true, pmt::dict_has_key( meta, pmt::intern("host_time") ) );
+        pmt::pmt_t host_time = pmt::dict_ref( meta, pmt::intern("host_time"), pmt::PMT_NIL );
+        BOOST_REQUIRE( pmt::to_uint64( pmt::tuple_ref( host_time, 0 ) ) > 0 );
+      }
+    } //end test_udp_data
+
+    BOOST_AUTO_TEST_SUITE_END()
+  } /* namespace sandia_utils */
+} /* namespace gr */
@@ -7,6 +7,7 @@
 
 #include "ContextPacket.h"
 #include "cifs_defs.h"
+#include <math.h>
 #include <stdio.h>
 
 namespace gr {
@@ -14,6 +15,10 @@ namespace sandia_utils {
 
 ContextPacket::ContextPacket()
 {
+    nfields = 0;
+    cursor = 0;
+    values.reserve(CONTEXT_MAX_VALUES);
+
     cif[0] = 0;
     cif[1] = 0;
     cif[2] = 0;
@@ -28,12 +33,7 @@ ContextPacket::ContextPacket()
     return;
 }
 
-ContextPacket::~ContextPacket()
-{
-    values.clear();
-
-    return;
-}
+ContextPacket::~ContextPacket() { return; }
 
 /**
  * Unpacks a 32byte word.
@@ -107,7 +107,9 @@ void ContextPacket::reset(void)
     cif[7] = 0;
     change = false;
 
+    nfields = 0;
     values.clear();
+    cursor = 0;
 
     return;
 }
@@ -119,35 +121,156 @@ void ContextPacket::reset(void)
  */
 std::vector<CifValue*>* ContextPacket::getValues(void) { return &values; }
 
+/**
+ * Adds a value to encode with pack()
+ *
+ * @param id - field id, 100 * CIF index + bit
+ * @param value - field value
+ * @return bool - false if the field can not be encoded or the packet is full
+ */
+bool ContextPacket::addValue(int id, double value)
+{
+    int idx = id / 100;
+    int bit = id % 100;
+
+    if (id < 0 || idx > 3 || bit > 31 || nfields >= CONTEXT_MAX_VALUES) {
+        return false;
+    }
+    if (cif_defs[idx][bit].format == CIF_SKIP) {
+        return false;
+    }
+
+    // a field is encoded once, the last value added wins
+    for (size_t i = 0; i < nfields; i++) {
+        if (fields[i].getId() == id) {
+            fields[i].setValue(value);
+            return true;
+        }
+    }
+
+    fields[nfields] = CifValue(id, value);
+    values.push_back(&fields[nfields]);
+    nfields++;
+
+    return true;
+}
+
+/**
+ * Encodes the CIF words and the added values into the payload, then packs
+ * the packet into a buffer in network byte order
+ *
+ * @param buf - destination buffer
+ * @param len - size of buf in bytes
+ * @return size_t - packet size in bytes, 0 if it does not fit
+ */
+size_t ContextPacket::pack(uint8_t* buf, size_t len)
+{
+    const CifValue* order[4][32] = {};
+    int i, j;
+
+    for (i = 0; i < 8; i++) {
+        cif[i] = 0;
+    }
+    if (change) {
+        cif[0] |= 0x80000000u;
+    }
+    for (size_t k = 0; k < nfields; k++) {
+        i = fields[k].getId() / 100;
+        j = fields[k].getId() % 100;
+        cif[i] |= 0x01u << j;
+        order[i][j] = &fields[k];
+    }
+    for (i = 1; i <= 3; i++) {
+        if (cif[i]) {
+            cif[0] |= 0x01u << i;
+        }
+    }
+
+    payload.clear();
+    payload_data = NULL;
+    payload_words = 0;
+    for (i = 0; i <= 3; i++) {
+        if (i == 0 || (cif[0] & (0x01u << i))) {
+            payload.push_back(cif[i]);
+        }
+    }
+
+    // fields in the order they are decoded, CIF0 first, high bit first
+    for (i = 0; i < 4; i++) {
+        for (j = 31; j >= 0; j--) {
+            if (!order[i][j]) {
+                continue;
+            }
+            const cif_field_def& def = cif_defs[i][j];
+            double scaled = order[i][j]->getValue() * (double)(1ULL << def.radix);
+            uint64_t raw;
+
+            switch (def.format) {
+            case CIF_FIXED64:
+                raw = scaled > 0.0 ? (uint64_t)llround(scaled) : 0;
+                break;
+            case CIF_SFIXED16:
+                raw = (uint16_t)(int16_t)lround(scaled);
+                break;
+            default:
+                raw = (uint64_t)llround(scaled);
+                break;
+            }
+
+            if (def.words == 2) {
+                payload.push_back(raw >> 32);
+            }
+            payload.push_back(raw);
+        } // end for(j
+    }     // end for(i
+
+    return VRTPacket::pack(buf, len);
+} // end pack
+
 /**
  * Decodes Payload block into context information
  */
 void ContextPacket::context_decode(void)
 {
-    if (payload.size() > 1) {
-        // grab CIF fields first
-        grab_cifs();
+    cursor = 0;
+    nfields = 0;
+    values.clear();
 
+    // grab CIF fields first
+    if (grab_cifs()) {
         unpack_cifs();
     } else {
         // payload isn't big enough
     }
 
+    // the payload has been consumed into values
+    payload.clear();
+    payload_data = NULL;
+    payload_words = 0;
+
     return;
 }
 
 
 /**
  * grabs CIF[0-7] from payload
+ *
+ * @return bool - false if the payload is too short
  */
-void ContextPacket::grab_cifs(void)
+bool ContextPacket::grab_cifs(void)
 {
     int i;
 
+    if (payload_left() < 1) {
+        return false;
+    }
     cif[0] = payload_pop();
 
     for (i = 1; i <= 7; i++) {
         if (cif[0] & (0x01 << i)) {
+            if (payload_left() < 1) {
+                return false;
+            }
             cif[i] = payload_pop();
         } else {
             cif[i] = 0;
@@ -155,7 +278,7 @@ void ContextPacket::grab_cifs(void)
 
     } // end for(i
 
-    return;
+    return true;
 } // end grab_cifs
 
 /**
@@ -166,11 +289,17 @@ void ContextPacket::unpack_cifs(void)
     int i, j;
     int stat = 1;
 
-    for (i = 0; i < 8 && stat; i++) // loop over cif[]
+    // CIF4-6 are undefined and CIF7 changes the size of every field, the
+    // fields can not be located with either present
+    if (cif[0] & 0xf0) {
+        printf("ContextPacket::unpack_cifs() unsupported CIF word in 0x%08x\n", cif[0]);
+        return;
+    }
+
+    for (i = 0; i < 4 && stat; i++) // loop over cif[]
     {
         for (j = 31; j >= 0 && stat; j--) {
-            if (cif[i] & (0x01 << j)) {
-                // printf("Detected CIF mask %d %d\n", i, j );
+            if (cif[i] & (0x01u << j)) {
                 if (i == 0 && j == 31) {
                     // special change bit
                     change = true;
@@ -190,16 +319,43 @@ void ContextPacket::unpack_cifs(void)
 }
 
 /**
- * Helper method to pop the front of the payload
+ * Returns the number of payload words left to decode
  *
- * @return uint32_t
+ * @return size_t - words after the cursor
  */
-uint32_t ContextPacket::payload_pop(void)
+size_t ContextPacket::payload_left(void) const
 {
-    uint32_t ans = 0;
+    size_t len = payload_data ? payload_words : payload.size();
+    return len > cursor ? len - cursor : 0;
+}
 
-    ans = payload.at(0);
-    payload.erase(payload.begin());
+/**
+ * Returns a payload word relative to the cursor, without moving it
+ *
+ * @param offset - words after the cursor
+ * @return uint32_t - payload word, host byte order
+ */
+uint32_t ContextPacket::payload_peek(size_t offset) const
+{
+    size_t idx = cursor + offset;
+
+    if (payload_data) {
+        const uint8_t* p = payload_data + 4 * idx;
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) |
+               (uint32_t)p[3];
+    }
+    return payload[idx];
+}
+
+/**
+ * Returns the payload word at the cursor and moves past it
+ *
+ * @return uint32_t - payload word, host byte order
+ */
+uint32_t ContextPacket::payload_pop(void)
+{
+    uint32_t ans = payload_peek();
+    cursor++;
 
     return ans;
 }
@@ -208,6 +364,58 @@ bool ContextPacket::isChange() const { return change; }
 
 void ContextPacket::setChange(bool change) { this->change = change; }
 
+/**
+ * Returns the size of a field at the cursor
+ *
+ * @param words - size from the field table, or a CIF_VAR_* rule
+ * @return long - size in words, -1 if unknown or beyond the payload
+ */
+long ContextPacket::field_words(int words) const
+{
+    long len = -1;
+    size_t left = payload_left();
+
+    switch (words) {
+    case CIF_VAR_GPS_ASCII:
+        // OUI word, then the number of ASCII words
+        if (left >= 2) {
+            len = 2 + (long)payload_peek(1);
+        }
+        break;
+    case CIF_VAR_ASSOC:
+        // source and system list sizes, then vector-component and
+        // asynchronous-channel list sizes, the latter doubled by the tag flag
+        if (left >= 2) {
+            uint32_t w1 = payload_peek(0);
+            uint32_t w2 = payload_peek(1);
+            long async = w2 & 0x7fff;
+            len = 2 + ((w1 >> 16) & 0x1ff) + (w1 & 0x1ff) + (w2 >> 16) +
+                  ((w2 & 0x8000) ? 2 * async : async);
+        }
+        break;
+    case CIF_VAR_ARRAY:
+        // the first word holds the size of the whole field
+        if (left >= 1) {
+            len = payload_peek(0);
+            if (len < 1) {
+                len = -1;
+            }
+        }
+        break;
+    case CIF_RESERVED:
+        break;
+    default:
+        len = words;
+        break;
+    }
+
+    if (len > (long)left) {
+        len = -1;
+    }
+
+    return len;
+}
+
 /**
  * Decodes a specific CIF value
  *
@@ -217,32 +425,37 @@ void ContextPacket::setChange(bool change) { this->change = change; }
  */
 int ContextPacket::decode_cif(int idx, int bit)
 {
-    int ans = 0;
-    uint64_t raw;
-    //double rawf;
-    //int stat;
-
-    struct cif_decode_ring_type* def = NULL;
+    const cif_field_def& def = cif_defs[idx][bit];
+    uint64_t raw = 0;
 
-    def = cif_find_def(idx, bit);
-    if (def) {
-        raw = 0;
-        for (int i = 0; i < def->word_len; i++) {
-            raw = raw << 32;
-            raw |= payload_pop();
-        } // end for(i
+    long len = field_words(def.words);
+    if (len < 0) {
+        return 0;
+    }
 
-        // printf(" CIF raw 0x%16lx\n", raw );
+    if (def.format != CIF_SKIP && nfields < CONTEXT_MAX_VALUES) {
+        for (long i = 0; i < len; i++) {
+            raw = (raw << 32) | payload_peek(i);
+        }
 
-        if (def->double_type) {
-            CifValue* cv = new CifValue(def->idx, def->bit, def->radix_pt, raw);
-            values.push_back(cv);
+        CifValue& cv = fields[nfields++];
+        switch (def.format) {
+        case CIF_FIXED64:
+            cv = CifValue(idx, bit, def.radix, raw);
+            break;
+        case CIF_SFIXED64:
+            cv = CifValue(100 * idx + bit, (double)(int64_t)raw / (double)(1ULL << def.radix));
+            break;
+        case CIF_SFIXED16:
+            cv = CifValue(100 * idx + bit, (double)(int16_t)(raw & 0xffff) / (double)(1 << def.radix));
+            break;
         }
+        values.push_back(&cv);
+    }
 
-        ans = 1;
-    } // end if( def
+    cursor += len;
 
-    return ans;
+    return 1;
 }
 } /* namespace sandia_utils */
 } /* namespace gr */
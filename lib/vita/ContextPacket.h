@@ -12,6 +12,9 @@
 #include "VRTPacket.h"
 #include <vector>
 
+// most values decoded from one packet
+#define CONTEXT_MAX_VALUES 32
+
 namespace gr {
 namespace sandia_utils {
 
@@ -19,13 +22,24 @@ class SANDIA_UTILS_API ContextPacket : public VRTPacket
 {
 private:
     uint32_t cif[8];
+
+    // decoded values are stored in the packet, values points into it
+    CifValue fields[CONTEXT_MAX_VALUES];
+    size_t nfields;
     std::vector<CifValue*> values;
     bool change;
 
+    // payload read position of the decoder
+    size_t cursor;
+
 public:
     ContextPacket();
     virtual ~ContextPacket();
 
+    // values point into the packet's own storage
+    ContextPacket(const ContextPacket&) = delete;
+    ContextPacket& operator=(const ContextPacket&) = delete;
+
     /**
      * Unpacks a 32byte word.
      *
@@ -48,12 +62,36 @@ public:
     virtual void reset(void);
 
     /**
-     * Returns all decoded values
+     * Returns all decoded values. The values decoded from a packet are
+     * owned by the packet and valid until the next reset or unpack.
      *
      * @return
      */
     std::vector<CifValue*>* getValues(void);
 
+    /**
+     * Adds a value to encode with pack(). Only fields reported as a
+     * CifValue when decoding can be encoded.
+     *
+     * @param id - field id, 100 * CIF index + bit
+     * @param value - field value
+     * @return bool - false if the field can not be encoded or the packet
+     * is full
+     */
+    bool addValue(int id, double value);
+
+    using VRTPacket::pack;
+
+    /**
+     * Encodes the CIF words and the added values into the payload, then
+     * packs the packet into a buffer in network byte order
+     *
+     * @param buf - destination buffer
+     * @param len - size of buf in bytes
+     * @return size_t - packet size in bytes, 0 if it does not fit
+     */
+    virtual size_t pack(uint8_t* buf, size_t len);
+
     bool isChange() const;
     void setChange(bool change);
 
@@ -66,8 +104,10 @@ private:
 
     /**
      * grabs CIF[0-7] from payload
+     *
+     * @return bool - false if the payload is too short
      */
-    void grab_cifs(void);
+    bool grab_cifs(void);
 
     /**
      * Unpacks cifs based off cif[]
@@ -75,12 +115,35 @@ private:
     void unpack_cifs(void);
 
     /**
-     * Helper method to pop the front of the payload
+     * Returns the number of payload words left to decode
      *
-     * @return uint32_t
+     * @return size_t - words after the cursor
+     */
+    size_t payload_left(void) const;
+
+    /**
+     * Returns a payload word relative to the cursor, without moving it
+     *
+     * @param offset - words after the cursor
+     * @return uint32_t - payload word, host byte order
+     */
+    uint32_t payload_peek(size_t offset = 0) const;
+
+    /**
+     * Returns the payload word at the cursor and moves past it
+     *
+     * @return uint32_t - payload word, host byte order
      */
     uint32_t payload_pop(void);
 
+    /**
+     * Returns the size of a field at the cursor
+     *
+     * @param words - size from the field table, or a CIF_VAR_* rule
+     * @return long - size in words, -1 if unknown or beyond the payload
+     */
+    long field_words(int words) const;
+
     /**
      * Decodes a specific CIF value
      *
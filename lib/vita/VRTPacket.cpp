@@ -7,17 +7,37 @@
 
 #include "VRTPacket.h"
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 namespace gr {
 namespace sandia_utils {
 
+namespace {
+inline uint32_t be_word(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) |
+           (uint32_t)p[3];
+}
+
+inline void put_be_word(uint8_t* p, uint32_t word)
+{
+    p[0] = word >> 24;
+    p[1] = word >> 16;
+    p[2] = word >> 8;
+    p[3] = word;
+}
+} // namespace
+
 VRTPacket::VRTPacket()
 {
     stream_id = 0;
     ts_epoch = 0;
     ts_frac = 0;
     word_cnt = 0;
+    payload_data = NULL;
+    payload_words = 0;
+    host_time_ns = 0;
 
     state = BLANK;
 
@@ -43,6 +63,9 @@ void VRTPacket::copy(const VRTPacket& rhs)
     word_cnt = rhs.word_cnt;
     state = rhs.state;
     payload = rhs.payload;
+    payload_data = rhs.payload_data;
+    payload_words = rhs.payload_words;
+    host_time_ns = rhs.host_time_ns;
 
     header.copy(rhs.header);
     class_id.copy(rhs.class_id);
@@ -71,6 +94,8 @@ int VRTPacket::unpack(uint32_t word_in)
 
             state = GOT_HEADER;
             payload.clear();
+            payload_data = NULL;
+            payload_words = 0;
             word_cnt = 1;
 
             ans = 2;
@@ -230,6 +255,198 @@ int VRTPacket::unpack(uint32_t word_in)
     return ans;
 } // end unpack
 
+/**
+ * Unpacks a complete packet from a buffer in network byte order.
+ *
+ * @param buf - start of the packet, aligned to the header word
+ * @param len - number of bytes available in buf
+ * @return int - 0 = fail, 1 = done, 2 = need more
+ */
+int VRTPacket::unpack(const uint8_t* buf, size_t len)
+{
+    if (len < 4) {
+        return 2;
+    }
+
+    reset();
+    if (header.unpack(be_word(buf)) != 1) {
+        return 0;
+    }
+
+    size_t nwords = header.getPacketSize();
+    if (len < nwords * 4) {
+        // header is valid, wait for the rest of the packet
+        return 2;
+    }
+
+    bool has_sid = header.getType() != PacketType::SIGNAL_DATA &&
+                   header.getType() != PacketType::EXT_DATA;
+    size_t prologue_sz = 1 + (has_sid ? 1 : 0) + (header.isC() ? 2 : 0) +
+                         (header.getTsi() != TSI::NO_TSI ? 1 : 0) +
+                         (header.getTsf() != TSF::NO_TSF ? 2 : 0);
+    size_t trailer_sz = 0;
+    if (header.getType() == PacketType::SIGNAL_DATA ||
+        header.getType() == PacketType::SIGNAL_DATA_ID) {
+        if (header.getIndicators() & 0x04) {
+            trailer_sz = 1;
+        }
+    }
+    if (prologue_sz + trailer_sz > nwords) {
+        // prologue does not fit in the packet size, checked before any of
+        // it is read
+        return 0;
+    }
+
+    size_t idx = 1;
+    if (has_sid) {
+        stream_id = be_word(buf + 4 * idx++);
+    }
+    if (header.isC()) {
+        class_id.unpack(be_word(buf + 4 * idx++));
+        class_id.unpack(be_word(buf + 4 * idx++));
+    }
+    if (header.getTsi() != TSI::NO_TSI) {
+        ts_epoch = be_word(buf + 4 * idx++);
+    }
+    if (header.getTsf() != TSF::NO_TSF) {
+        ts_frac = ((uint64_t)be_word(buf + 4 * idx) << 32) | be_word(buf + 4 * idx + 4);
+        idx += 2;
+    }
+
+    payload_data = buf + 4 * idx;
+    payload_words = nwords - idx - trailer_sz;
+    if (trailer_sz) {
+        trailer.unpack(be_word(buf + 4 * (nwords - 1)));
+    }
+
+    word_cnt = nwords;
+    state = DONE;
+
+    return 1;
+} // end unpack
+
+/**
+ * Returns the number of words before the payload, from the fields the header
+ * enables
+ *
+ * @return size_t - header, stream ID, class ID and timestamp words
+ */
+size_t VRTPacket::getPrologueWords(void)
+{
+    size_t ans = 1;
+
+    if (header.getType() != PacketType::SIGNAL_DATA &&
+        header.getType() != PacketType::EXT_DATA) {
+        ans += 1;
+    }
+    if (header.isC()) {
+        ans += 2;
+    }
+    if (header.getTsi() != TSI::NO_TSI) {
+        ans += 1;
+    }
+    if (header.getTsf() != TSF::NO_TSF) {
+        ans += 2;
+    }
+
+    return ans;
+}
+
+/**
+ * References a payload to pack, instead of the payload vector
+ *
+ * @param data - payload words in network byte order
+ * @param words - number of payload words
+ */
+void VRTPacket::setPayloadData(const uint8_t* data, size_t words)
+{
+    payload_data = data;
+    payload_words = words;
+
+    return;
+}
+
+/**
+ * Packs the packet into a buffer in network byte order
+ *
+ * @param buf - destination buffer
+ * @param len - size of buf in bytes
+ * @return size_t - packet size in bytes, 0 if it does not fit
+ */
+size_t VRTPacket::pack(uint8_t* buf, size_t len)
+{
+    size_t idx = getPrologueWords();
+    size_t nwords = payload_data ? payload_words : payload.size();
+    size_t trailer_sz = 0;
+
+    if (header.getType() == PacketType::SIGNAL_DATA ||
+        header.getType() == PacketType::SIGNAL_DATA_ID) {
+        if (header.getIndicators() & 0x04) {
+            trailer_sz = 1;
+        }
+    }
+
+    size_t total = idx + nwords + trailer_sz;
+    if (total > 0xffff || 4 * total > len) {
+        return 0;
+    }
+
+    // payload first, a referenced payload may sit anywhere in buf
+    uint8_t* dest = buf + 4 * idx;
+    if (payload_data) {
+        if (payload_data != dest) {
+            memmove(dest, payload_data, 4 * nwords);
+        }
+    } else {
+        for (size_t i = 0; i < nwords; i++) {
+            put_be_word(dest + 4 * i, payload[i]);
+        }
+    }
+
+    header.setPacketSize(total);
+    idx = 0;
+    put_be_word(buf + 4 * idx++, header.pack());
+    if (header.getType() != PacketType::SIGNAL_DATA &&
+        header.getType() != PacketType::EXT_DATA) {
+        put_be_word(buf + 4 * idx++, stream_id);
+    }
+    if (header.isC()) {
+        uint32_t words[2];
+        class_id.pack(words);
+        put_be_word(buf + 4 * idx++, words[0]);
+        put_be_word(buf + 4 * idx++, words[1]);
+    }
+    if (header.getTsi() != TSI::NO_TSI) {
+        put_be_word(buf + 4 * idx++, ts_epoch);
+    }
+    if (header.getTsf() != TSF::NO_TSF) {
+        put_be_word(buf + 4 * idx++, ts_frac >> 32);
+        put_be_word(buf + 4 * idx++, ts_frac);
+    }
+    if (trailer_sz) {
+        put_be_word(buf + 4 * (total - 1), trailer.pack());
+    }
+
+    return 4 * total;
+} // end pack
+
+size_t VRTPacket::getPacketBytes(void) const { return 4 * (size_t)header.getPacketSize(); }
+
+/**
+ * Copies a referenced payload into the payload vector
+ */
+void VRTPacket::fill_payload(void)
+{
+    if (payload_data && payload.empty()) {
+        payload.resize(payload_words);
+        for (size_t i = 0; i < payload_words; i++) {
+            payload[i] = be_word(payload_data + 4 * i);
+        }
+    }
+
+    return;
+}
+
 /**
  * Debug tool, print out to STDOUT
  */
@@ -266,7 +483,7 @@ void VRTPacket::debug_print(void)
         }
     }
 
-    printf("\tPayload Size: %lu\n", payload.size());
+    printf("\tPayload Size: %lu\n", payload_data ? payload_words : payload.size());
 
     if (header.getType() == PacketType::SIGNAL_DATA ||
         header.getType() == PacketType::SIGNAL_DATA_ID) {
@@ -287,6 +504,9 @@ void VRTPacket::reset(void)
     state = BLANK;
     word_cnt = 0;
     payload.clear();
+    payload_data = NULL;
+    payload_words = 0;
+    host_time_ns = 0;
 
     class_id.reset();
 
@@ -313,6 +533,10 @@ void VRTPacket::setStreamId(uint32_t streamId) { stream_id = streamId; }
 
 const vita_trailer& VRTPacket::getTrailer() const { return trailer; }
 
+void VRTPacket::setTrailer(const vita_trailer& trailer) { this->trailer.copy(trailer); }
+
+void VRTPacket::setClassId(const vita_class_id& classId) { class_id.copy(classId); }
+
 uint32_t VRTPacket::getTsEpoch() const { return ts_epoch; }
 
 void VRTPacket::setTsEpoch(uint32_t tsEpoch) { ts_epoch = tsEpoch; }
@@ -321,12 +545,27 @@ uint64_t VRTPacket::getTsFrac() const { return ts_frac; }
 
 void VRTPacket::setTsFrac(uint64_t tsFrac) { ts_frac = tsFrac; }
 
+uint64_t VRTPacket::getHostTimeNs() const { return host_time_ns; }
+
+void VRTPacket::setHostTimeNs(uint64_t hostTimeNs) { host_time_ns = hostTimeNs; }
+
 /**
  * Returns pointer to payload vectory
  *
  * @return *vector<uint32_t>
  */
-std::vector<uint32_t>* VRTPacket::getPayload(void) { return &payload; }
+std::vector<uint32_t>* VRTPacket::getPayload(void)
+{
+    fill_payload();
+    return &payload;
+}
+
+const uint8_t* VRTPacket::getPayloadData(void) const { return payload_data; }
+
+size_t VRTPacket::getPayloadWords(void) const
+{
+    return payload_data ? payload_words : payload.size();
+}
 
 } // namespace sandia_utils
 } /* namespace gr */
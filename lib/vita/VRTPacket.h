@@ -8,6 +8,7 @@
 #ifndef LIB_VITA_VRTPACKET_H_
 #define LIB_VITA_VRTPACKET_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <vector>
 
@@ -49,9 +50,24 @@ protected:
     std::vector<uint32_t> payload;
     vita_trailer trailer;
 
+    // payload words in network byte order within the buffer given to the
+    // framed unpack, NULL when unpacked a word at a time
+    const uint8_t* payload_data;
+    size_t payload_words;
+
+    // host receive time from the socket, ns since the unix epoch, 0 when
+    // unknown
+    uint64_t host_time_ns;
+
     UnpackState state;
     uint16_t word_cnt;
 
+    /**
+     * Copies a referenced payload into the payload vector, so the vector
+     * accessors work for packets unpacked from a buffer
+     */
+    void fill_payload(void);
+
 public:
     VRTPacket();
     VRTPacket(const VRTPacket& rhs);
@@ -68,6 +84,57 @@ public:
      */
     virtual int unpack(uint32_t word_in);
 
+    /**
+     * Unpacks a complete packet from a buffer in network byte order.
+     * The header is decoded first and its packet size used to locate the
+     * remaining fields directly. The payload is not copied, it is
+     * referenced in \p buf until the next unpack or reset.
+     *
+     * @param buf - start of the packet, aligned to the header word
+     * @param len - number of bytes available in buf
+     * @return int - 0 = fail, 1 = done, 2 = need more
+     */
+    int unpack(const uint8_t* buf, size_t len);
+
+    using vita_base_abs::pack;
+
+    /**
+     * Packs the packet into a buffer in network byte order. The header
+     * packet size is set from the fields the header enables and the
+     * payload. A payload referenced with setPayloadData() is used if set,
+     * it may already be in place at getPrologueWords() in \p buf. Otherwise
+     * the payload vector is packed.
+     *
+     * @param buf - destination buffer
+     * @param len - size of buf in bytes
+     * @return size_t - packet size in bytes, 0 if it does not fit
+     */
+    virtual size_t pack(uint8_t* buf, size_t len);
+
+    /**
+     * Returns the number of words before the payload, from the fields the
+     * header enables
+     *
+     * @return size_t - header, stream ID, class ID and timestamp words
+     */
+    size_t getPrologueWords(void);
+
+    /**
+     * References a payload to pack, instead of the payload vector. The
+     * payload is not copied until pack().
+     *
+     * @param data - payload words in network byte order
+     * @param words - number of payload words
+     */
+    void setPayloadData(const uint8_t* data, size_t words);
+
+    /**
+     * Returns the size of the packet in bytes, from the header
+     *
+     * @return size_t - packet size in bytes
+     */
+    size_t getPacketBytes(void) const;
+
 
     /**
      * Debug tool, print out to STDOUT
@@ -95,6 +162,22 @@ public:
      */
     std::vector<uint32_t>* getPayload(void);
 
+    /**
+     * Returns the payload of a packet unpacked from a buffer, without
+     * copying it. Words are in network byte order.
+     *
+     * @return const uint8_t* - first payload byte, NULL when the packet was
+     * unpacked a word at a time
+     */
+    const uint8_t* getPayloadData(void) const;
+
+    /**
+     * Returns the number of 32 bit payload words
+     *
+     * @return size_t - payload words
+     */
+    size_t getPayloadWords(void) const;
+
 
     // uint64_t getClassId() const;
     const vita_class_id& getClassId() const;
@@ -104,10 +187,14 @@ public:
     uint32_t getStreamId() const;
     void setStreamId(uint32_t streamId);
     const vita_trailer& getTrailer() const;
+    void setTrailer(const vita_trailer& trailer);
+    void setClassId(const vita_class_id& classId);
     uint32_t getTsEpoch() const;
     void setTsEpoch(uint32_t tsEpoch);
     uint64_t getTsFrac() const;
     void setTsFrac(uint64_t tsFrac);
+    uint64_t getHostTimeNs() const;
+    void setHostTimeNs(uint64_t hostTimeNs);
 };
 // end class VRTPacket
 
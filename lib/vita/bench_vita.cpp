@@ -0,0 +1,423 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * VITA 49 receive path benchmark. Synthetic packet streams are run through
+ * the receiver parsing (vita_rx_base::processData() and processDatagram()),
+ * Context packet decoding and listener dispatch, directly and through the
+ * publisher queue, reporting packets/s, bytes/s and heap allocations per
+ * packet.
+ *
+ * usage: bench_vita [seconds per case]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "ContextPacket.h"
+#include "VRTPacket.h"
+#include "vitarxbase.h"
+
+using namespace gr::sandia_utils;
+
+// every heap allocation of the process, counted while a case runs
+static std::atomic<uint64_t> allocs(0);
+
+void* operator new(size_t size)
+{
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// read size of the stream cases, as a busy TCP client would return
+#define BENCH_READ_BYTES (64 * 1024)
+
+// payload words of the data packet sizes
+static const size_t payloadWords[] = { 16, 90, 360, 1024, 2000, 8000 };
+#define BENCH_NUM_SIZES (sizeof(payloadWords) / sizeof(payloadWords[0]))
+
+/**
+ * Counts the packets the receiver dispatches and touches their fields like
+ * a real listener would
+ */
+class bench_listener : public vita_rx_listener
+{
+public:
+    uint64_t packets;
+    uint64_t sum;
+
+    bench_listener() : packets(0), sum(0) {}
+
+    virtual void received_packet(PacketType type, VRTPacket* pkt)
+    {
+        packets++;
+        sum += pkt->getStreamId() + pkt->getTsFrac() + pkt->getPayloadWords();
+        if (type == PacketType::CONTEXT) {
+            sum += ((ContextPacket*)pkt)->getValues()->size();
+        }
+        return;
+    }
+};
+
+/**
+ * Receiver without a transport, the benchmark hands it the bytes a socket
+ * would
+ */
+class bench_rx : public vita_rx_base
+{
+public:
+    vita_rx_client client;
+    VRTPacket dgram;
+
+    bench_rx() : vita_rx_base(0)
+    {
+        client.fd = -1;
+        client.buf.resize(4 * 1024 * 1024);
+        client.len = 0;
+        client.lost = false;
+    }
+
+    int start(void)
+    {
+        start_publisher();
+        return 1;
+    }
+    int stop(void)
+    {
+        stop_publisher();
+        return 1;
+    }
+
+    /**
+     * Feeds a stream through processData() a read at a time
+     *
+     * @param stream - packed packets
+     */
+    void feed_stream(const std::vector<uint8_t>& stream)
+    {
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            size_t n = std::min(stream.size() - pos, client.buf.size() - client.len);
+            n = std::min(n, (size_t)BENCH_READ_BYTES);
+            memcpy(client.buf.data() + client.len, stream.data() + pos, n);
+            cnt_rx_byte += n;
+            client.len += n;
+            processData(&client);
+            pos += n;
+        }
+    }
+
+    /**
+     * Feeds each packet through processDatagram()
+     *
+     * @param stream - packed packets
+     * @param offsets - start of each packet, and the end of the stream
+     */
+    void feed_datagrams(std::vector<uint8_t>& stream, const std::vector<size_t>& offsets)
+    {
+        for (size_t i = 0; i + 1 < offsets.size(); i++) {
+            processDatagram(
+                stream.data() + offsets[i], offsets[i + 1] - offsets[i], 0, &dgram);
+        }
+    }
+};
+
+/**
+ * Synthetic packet stream
+ */
+struct bench_stream {
+    const char* name;
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> offsets;
+    uint64_t packets;
+};
+
+static uint32_t lcg = 12345;
+static uint32_t next_rand(void)
+{
+    lcg = lcg * 1664525 + 1013904223;
+    return lcg >> 8;
+}
+
+/**
+ * Appends a data packet
+ *
+ * @param s - stream
+ * @param words - payload words
+ * @param trailer - true to add a class ID and trailer
+ */
+static void add_data(bench_stream& s, size_t words, bool trailer)
+{
+    VRTPacket pkt;
+    std::vector<uint32_t> payload(words);
+
+    for (size_t i = 0; i < words; i++) {
+        payload[i] = next_rand();
+    }
+    pkt.getHeader()->setType(PacketType::SIGNAL_DATA_ID);
+    pkt.getHeader()->setTsi(TSI::UTC);
+    pkt.getHeader()->setTsf(TSF::REAL_TIME);
+    pkt.getHeader()->setPktCount(s.packets & 0xf);
+    if (trailer) {
+        vita_class_id cid;
+        cid.setOui(0x123456);
+        cid.setInfoClassCode(1);
+        cid.setPacketClassCode(2);
+        pkt.getHeader()->setC(true);
+        pkt.getHeader()->setIndicators(0x04);
+        pkt.setClassId(cid);
+    }
+    pkt.setStreamId(0x100 + (s.packets & 3));
+    pkt.setTsEpoch(1700000000 + s.packets / 1000);
+    pkt.setTsFrac((s.packets % 1000) * 1000000000ULL);
+    pkt.setPayloadData((const uint8_t*)payload.data(), words);
+
+    size_t at = s.bytes.size();
+    s.bytes.resize(at + VITA_RX_MAX_PACKET_BYTES);
+    s.bytes.resize(at + pkt.pack(s.bytes.data() + at, VITA_RX_MAX_PACKET_BYTES));
+    s.offsets.push_back(at);
+    s.packets++;
+
+    return;
+}
+
+/**
+ * Appends a context packet with frequency, rate, bandwidth and levels
+ *
+ * @param s - stream
+ */
+static void add_context(bench_stream& s)
+{
+    ContextPacket pkt;
+
+    pkt.getHeader()->setType(PacketType::CONTEXT);
+    pkt.getHeader()->setTsi(TSI::UTC);
+    pkt.getHeader()->setTsf(TSF::REAL_TIME);
+    pkt.getHeader()->setPktCount(s.packets & 0xf);
+    pkt.setStreamId(0x100 + (s.packets & 3));
+    pkt.setTsEpoch(1700000000);
+    pkt.setChange(true);
+    pkt.addValue(29, 20e6);
+    pkt.addValue(28, 70e6);
+    pkt.addValue(27, 2.4e9 + (s.packets & 0xff) * 1e3);
+    pkt.addValue(24, -10.0);
+    pkt.addValue(21, 25e6);
+    pkt.addValue(18, 41.5);
+
+    size_t at = s.bytes.size();
+    s.bytes.resize(at + VITA_RX_MAX_PACKET_BYTES);
+    s.bytes.resize(at + pkt.pack(s.bytes.data() + at, VITA_RX_MAX_PACKET_BYTES));
+    s.offsets.push_back(at);
+    s.packets++;
+
+    return;
+}
+
+/**
+ * Builds the benchmark streams, each around 32 MB
+ *
+ * @return vector<bench_stream> - streams
+ */
+static std::vector<bench_stream> make_streams(void)
+{
+    const size_t target = 32 * 1024 * 1024;
+    std::vector<bench_stream> streams(5);
+
+    streams[0].name = "data 360";
+    streams[1].name = "data sizes";
+    streams[2].name = "data trailer";
+    streams[3].name = "context";
+    streams[4].name = "mixed";
+    for (bench_stream& s : streams) {
+        s.packets = 0;
+    }
+
+    while (streams[0].bytes.size() < target) {
+        add_data(streams[0], 360, false);
+    }
+    while (streams[1].bytes.size() < target) {
+        add_data(streams[1], payloadWords[next_rand() % BENCH_NUM_SIZES], false);
+    }
+    while (streams[2].bytes.size() < target) {
+        add_data(streams[2], payloadWords[next_rand() % BENCH_NUM_SIZES], true);
+    }
+    while (streams[3].bytes.size() < target / 16) {
+        add_context(streams[3]);
+    }
+    while (streams[4].bytes.size() < target) {
+        if (streams[4].packets % 10 == 0) {
+            add_context(streams[4]);
+        } else {
+            add_data(streams[4], payloadWords[next_rand() % BENCH_NUM_SIZES],
+                     next_rand() & 1);
+        }
+    }
+
+    for (bench_stream& s : streams) {
+        s.offsets.push_back(s.bytes.size());
+    }
+
+    return streams;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char* path,
+                   const char* name,
+                   uint64_t packets,
+                   uint64_t bytes,
+                   uint64_t nalloc,
+                   double elapsed)
+{
+    printf("%-10s %-13s %10.0f %10.1f %12.2f\n",
+           path,
+           name,
+           packets / elapsed,
+           bytes / elapsed / 1e6,
+           packets ? (double)nalloc / packets : 0.0);
+    return;
+}
+
+/**
+ * main entry point
+ *
+ * @param argc -
+ * @param argv -
+ * @return int
+ */
+int main(int argc, char** argv)
+{
+    double seconds = 1.0;
+    if (argc > 1) {
+        seconds = atof(argv[1]);
+    }
+
+    std::vector<bench_stream> streams = make_streams();
+
+    printf("%-10s %-13s %10s %10s %12s\n", "path", "stream", "pkt/s", "MB/s", "allocs/pkt");
+
+    for (bench_stream& s : streams) {
+        // stream parse, as a TCP client
+        {
+            bench_rx rx;
+            bench_listener l;
+            rx.add_listener(&l);
+            uint64_t a0 = allocs.load();
+            double t0 = now(), t;
+            do {
+                rx.feed_stream(s.bytes);
+                t = now() - t0;
+            } while (t < seconds);
+            report("stream",
+                   s.name,
+                   l.packets,
+                   rx.get_byte_count(),
+                   allocs.load() - a0,
+                   t);
+            if (rx.get_resync_count() != 0) {
+                printf("  %lu resyncs\n", (unsigned long)rx.get_resync_count());
+            }
+        }
+
+        // stream parse with the listeners on the publisher thread
+        {
+            bench_rx rx;
+            bench_listener l;
+            rx.add_listener(&l);
+            rx.set_queue_size(4096);
+            uint64_t a0 = allocs.load();
+            double t0 = now(), t;
+            rx.start();
+            do {
+                rx.feed_stream(s.bytes);
+                t = now() - t0;
+            } while (t < seconds);
+            rx.stop();
+            t = now() - t0;
+            report("queued",
+                   s.name,
+                   l.packets,
+                   rx.get_byte_count(),
+                   allocs.load() - a0,
+                   t);
+            if (rx.get_queue_drop_count() != 0) {
+                printf("  %lu queue drops\n", (unsigned long)rx.get_queue_drop_count());
+            }
+        }
+
+        // datagram parse, as UDP
+        {
+            bench_rx rx;
+            bench_listener l;
+            rx.add_listener(&l);
+            uint64_t a0 = allocs.load();
+            double t0 = now(), t;
+            do {
+                rx.feed_datagrams(s.bytes, s.offsets);
+                t = now() - t0;
+            } while (t < seconds);
+            report("datagram",
+                   s.name,
+                   l.packets,
+                   rx.get_byte_count(),
+                   allocs.load() - a0,
+                   t);
+        }
+    }
+
+    // Context packet decode alone, without the receiver
+    {
+        const bench_stream& s = streams[3];
+        VRTPacket pkt;
+        ContextPacket ctx;
+        uint64_t packets = 0, values = 0;
+        uint64_t a0 = allocs.load();
+        double t0 = now(), t;
+        do {
+            for (size_t i = 0; i + 1 < s.offsets.size(); i++) {
+                pkt.unpack(s.bytes.data() + s.offsets[i], s.offsets[i + 1] - s.offsets[i]);
+                ctx.unpack(pkt);
+                values += ctx.getValues()->size();
+                ctx.reset();
+                pkt.reset();
+                packets++;
+            }
+            t = now() - t0;
+        } while (t < seconds);
+        report("ctx unpack", s.name, packets, s.bytes.size() * (packets / s.packets),
+               allocs.load() - a0, t);
+        if (values != packets * 6) {
+            printf("  decoded %lu values, expected %lu\n",
+                   (unsigned long)values,
+                   (unsigned long)(packets * 6));
+        }
+    }
+
+    return 0;
+} // end main
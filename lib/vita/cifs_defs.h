@@ -8,26 +8,172 @@
 #ifndef LIB_VITA_CIFS_DEFS_H_
 #define LIB_VITA_CIFS_DEFS_H_
 
-#include <string>
-
-struct cif_decode_ring_type {
-    int idx;
-    int bit;
-    std::string cif_name;
-    int word_len;
-    bool double_type;
-    int radix_pt;
+#include <stdint.h>
+
+// field sizes that are read from the field itself
+#define CIF_VAR_GPS_ASCII -1 // 2 words + the word count in word 2
+#define CIF_VAR_ASSOC -2     // 2 words + the list sizes in words 1 and 2
+#define CIF_VAR_ARRAY -3     // total size in word 1 (array of records, index list)
+#define CIF_RESERVED -4      // undefined, the packet can not be decoded past it
+
+/**
+ * How a field is reported as a CifValue
+ */
+enum cif_value_format {
+    CIF_SKIP = 0,   // not reported
+    CIF_FIXED64,    // 64 bit fixed point, unsigned
+    CIF_SFIXED64,   // 64 bit fixed point, two's complement
+    CIF_SFIXED16    // 16 bit fixed point in the low half word, two's complement
 };
 
 /**
- * Finds a cif decode ring definintion in the decoder ring
- *
- * @param idx - CIF index
- * @param bit - CIF bit position
- * @return struct cif_decode_ring_type - found entry or NULL on not found
+ * Definition of a context field
  */
-struct cif_decode_ring_type* cif_find_def(int idx, int bit);
+struct cif_field_def {
+    int8_t words;   // size in words, 0 for flags, or a CIF_VAR_* rule
+    uint8_t format; // cif_value_format
+    int8_t radix;   // radix point of fixed point values
+};
+
+/**
+ * Field definitions of CIF0 - CIF3 (VITA 49.2), indexed by [cif][bit]
+ */
+constexpr cif_field_def cif_defs[4][32] = {
+    // CIF0
+    { { CIF_RESERVED, CIF_SKIP, 0 }, // 0 reserved
+      { 0, CIF_SKIP, 0 },            // 1 CIF1 enable
+      { 0, CIF_SKIP, 0 },            // 2 CIF2 enable
+      { 0, CIF_SKIP, 0 },            // 3 CIF3 enable
+      { 0, CIF_SKIP, 0 },            // 4 reserved (CIF4)
+      { 0, CIF_SKIP, 0 },            // 5 reserved (CIF5)
+      { 0, CIF_SKIP, 0 },            // 6 reserved (CIF6)
+      { 0, CIF_SKIP, 0 },            // 7 CIF7 enable
+      { CIF_VAR_ASSOC, CIF_SKIP, 0 },     // 8 context association lists
+      { CIF_VAR_GPS_ASCII, CIF_SKIP, 0 }, // 9 GPS ASCII
+      { 1, CIF_SKIP, 0 },                 // 10 ephemeris reference id
+      { 13, CIF_SKIP, 0 },                // 11 relative ephemeris
+      { 13, CIF_SKIP, 0 },                // 12 ECEF ephemeris
+      { 11, CIF_SKIP, 0 },                // 13 formatted INS
+      { 11, CIF_SKIP, 0 },                // 14 formatted GPS
+      { 2, CIF_SKIP, 0 },                 // 15 data payload format
+      { 1, CIF_SKIP, 0 },                 // 16 state and event indicators
+      { 2, CIF_SKIP, 0 },                 // 17 device identifier
+      { 1, CIF_SFIXED16, 6 },             // 18 temperature
+      { 1, CIF_SKIP, 0 },                 // 19 timestamp calibration time
+      { 2, CIF_SKIP, 0 },                 // 20 timestamp adjustment
+      { 2, CIF_FIXED64, 20 },             // 21 sample rate
+      { 1, CIF_SKIP, 0 },                 // 22 over-range count
+      { 1, CIF_SKIP, 0 },                 // 23 gain
+      { 1, CIF_SFIXED16, 7 },             // 24 reference level
+      { 2, CIF_SFIXED64, 20 },            // 25 IF band offset
+      { 2, CIF_SFIXED64, 20 },            // 26 RF reference frequency offset
+      { 2, CIF_FIXED64, 20 },             // 27 RF reference frequency
+      { 2, CIF_FIXED64, 20 },             // 28 IF reference frequency
+      { 2, CIF_FIXED64, 20 },             // 29 bandwidth
+      { 1, CIF_SKIP, 0 },                 // 30 reference point id
+      { 0, CIF_SKIP, 0 } },               // 31 change indicator
+    // CIF1
+    { { CIF_RESERVED, CIF_SKIP, 0 }, // 0 reserved
+      { 2, CIF_SKIP, 0 },            // 1 buffer size
+      { 1, CIF_SKIP, 0 },            // 2 version and build code
+      { 1, CIF_SKIP, 0 },            // 3 V49 spec compliance
+      { 1, CIF_SKIP, 0 },            // 4 health status
+      { 2, CIF_SKIP, 0 },            // 5 discrete I/O 64 bit
+      { 1, CIF_SKIP, 0 },            // 6 discrete I/O 32 bit
+      { CIF_VAR_ARRAY, CIF_SKIP, 0 }, // 7 index list
+      { CIF_RESERVED, CIF_SKIP, 0 },  // 8 reserved
+      { CIF_VAR_ARRAY, CIF_SKIP, 0 }, // 9 sector scan/step
+      { 13, CIF_SKIP, 0 },            // 10 spectrum
+      { CIF_VAR_ARRAY, CIF_SKIP, 0 }, // 11 array of CIFs
+      { CIF_RESERVED, CIF_SKIP, 0 },  // 12 reserved
+      { 2, CIF_FIXED64, 20 },         // 13 aux bandwidth
+      { 1, CIF_SKIP, 0 },             // 14 aux gain
+      { 2, CIF_FIXED64, 20 },         // 15 aux frequency
+      { 1, CIF_SKIP, 0 },             // 16 SNR/noise figure
+      { 1, CIF_SKIP, 0 },             // 17 2nd and 3rd order intercept points
+      { 1, CIF_SKIP, 0 },             // 18 compression point
+      { 1, CIF_SKIP, 0 },             // 19 threshold
+      { 1, CIF_SKIP, 0 },             // 20 Eb/No BER
+      { CIF_RESERVED, CIF_SKIP, 0 },  // 21 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 },  // 22 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 },  // 23 reserved
+      { 1, CIF_SKIP, 0 },             // 24 range
+      { 1, CIF_SKIP, 0 },             // 25 beam widths
+      { 1, CIF_SKIP, 0 },             // 26 spatial reference type
+      { 1, CIF_SKIP, 0 },             // 27 spatial scan type
+      { CIF_VAR_ARRAY, CIF_SKIP, 0 }, // 28 3-D pointing vector structure
+      { 1, CIF_SKIP, 0 },             // 29 3-D pointing vector
+      { 1, CIF_SKIP, 0 },             // 30 polarization
+      { 1, CIF_SKIP, 0 } },           // 31 phase offset
+    // CIF2
+    { { CIF_RESERVED, CIF_SKIP, 0 }, // 0 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 1 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 2 reserved
+      { 1, CIF_SKIP, 0 },            // 3 RF footprint range
+      { 1, CIF_SKIP, 0 },            // 4 RF footprint
+      { 1, CIF_SKIP, 0 },            // 5 communication priority id
+      { 1, CIF_SKIP, 0 },            // 6 function priority id
+      { 1, CIF_SKIP, 0 },            // 7 event id
+      { 1, CIF_SKIP, 0 },            // 8 mode id
+      { 1, CIF_SKIP, 0 },            // 9 function id
+      { 1, CIF_SKIP, 0 },            // 10 modulation type
+      { 1, CIF_SKIP, 0 },            // 11 modulation class
+      { 1, CIF_SKIP, 0 },            // 12 EMS device instance
+      { 1, CIF_SKIP, 0 },            // 13 EMS device type
+      { 1, CIF_SKIP, 0 },            // 14 EMS device class
+      { 1, CIF_SKIP, 0 },            // 15 platform display
+      { 1, CIF_SKIP, 0 },            // 16 platform instance
+      { 1, CIF_SKIP, 0 },            // 17 platform class
+      { 1, CIF_SKIP, 0 },            // 18 operator
+      { 1, CIF_SKIP, 0 },            // 19 country code
+      { 1, CIF_SKIP, 0 },            // 20 track id
+      { 1, CIF_SKIP, 0 },            // 21 information source
+      { 4, CIF_SKIP, 0 },            // 22 controller UUID
+      { 1, CIF_SKIP, 0 },            // 23 controller id
+      { 4, CIF_SKIP, 0 },            // 24 controllee UUID
+      { 1, CIF_SKIP, 0 },            // 25 controllee id
+      { 1, CIF_SKIP, 0 },            // 26 cited message id
+      { 1, CIF_SKIP, 0 },            // 27 child stream id
+      { 1, CIF_SKIP, 0 },            // 28 parent stream id
+      { 1, CIF_SKIP, 0 },            // 29 sibling stream id
+      { 1, CIF_SKIP, 0 },            // 30 cited stream id
+      { 1, CIF_SKIP, 0 } },          // 31 bind
+    // CIF3
+    { { CIF_RESERVED, CIF_SKIP, 0 }, // 0 reserved
+      { 1, CIF_SKIP, 0 },            // 1 network id
+      { 1, CIF_SKIP, 0 },            // 2 tropospheric state
+      { 1, CIF_SKIP, 0 },            // 3 sea and swell state
+      { 1, CIF_SKIP, 0 },            // 4 barometric pressure
+      { 1, CIF_SKIP, 0 },            // 5 humidity
+      { 1, CIF_SKIP, 0 },            // 6 sea/ground temperature
+      { 1, CIF_SKIP, 0 },            // 7 air temperature
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 8 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 9 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 10 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 11 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 12 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 13 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 14 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 15 reserved
+      { 1, CIF_SKIP, 0 },            // 16 shelf life
+      { 1, CIF_SKIP, 0 },            // 17 age
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 18 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 19 reserved
+      { 2, CIF_SKIP, 0 },            // 20 jitter
+      { 2, CIF_SKIP, 0 },            // 21 dwell
+      { 2, CIF_SKIP, 0 },            // 22 duration
+      { 2, CIF_SKIP, 0 },            // 23 period
+      { 2, CIF_SKIP, 0 },            // 24 pulse width
+      { 2, CIF_SKIP, 0 },            // 25 offset time
+      { 2, CIF_SKIP, 0 },            // 26 fall time
+      { 2, CIF_SKIP, 0 },            // 27 rise time
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 28 reserved
+      { CIF_RESERVED, CIF_SKIP, 0 }, // 29 reserved
+      { 2, CIF_SKIP, 0 },            // 30 timestamp skew
+      { 2, CIF_SKIP, 0 } }           // 31 timestamp details
+};
 
-extern struct cif_decode_ring_type cif_decode_ring[];
+static_assert(cif_defs[0][29].words == 2 && cif_defs[0][29].radix == 20,
+              "CIF0 table is indexed by bit");
 
 #endif /* LIB_VITA_CIFS_DEFS_H_ */
@@ -0,0 +1,131 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * libFuzzer target for the VITA 49 receive path. Each input is parsed as a
+ * single packet, as a Context packet, as a TCP byte stream split into two
+ * reads and as a UDP datagram, with a listener reading every decoded field.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ContextPacket.h"
+#include "VRTPacket.h"
+#include "vitarxbase.h"
+
+using namespace gr::sandia_utils;
+
+/**
+ * Reads every field of the dispatched packets, so decoded sizes and
+ * offsets are checked by the sanitizers
+ */
+class fuzz_listener : public vita_rx_listener
+{
+public:
+    uint64_t sum;
+
+    fuzz_listener() : sum(0) {}
+
+    virtual void received_packet(PacketType type, VRTPacket* pkt)
+    {
+        const uint8_t* data = pkt->getPayloadData();
+        size_t words = pkt->getPayloadWords();
+
+        sum += pkt->getStreamId() + pkt->getTsEpoch() + pkt->getTsFrac();
+        sum += pkt->getTrailer().getContextCount();
+        for (size_t i = 0; data != NULL && i < words * 4; i++) {
+            sum += data[i];
+        }
+        if (type == PacketType::CONTEXT) {
+            for (CifValue* v : *((ContextPacket*)pkt)->getValues()) {
+                sum += v->getValue() != 0.0;
+            }
+        }
+        return;
+    }
+};
+
+/**
+ * Receiver without a transport, inputs are fed in directly
+ */
+class fuzz_rx : public vita_rx_base
+{
+public:
+    vita_rx_client client;
+    VRTPacket dgram;
+
+    fuzz_rx() : vita_rx_base(0)
+    {
+        client.fd = -1;
+        client.len = 0;
+        client.lost = false;
+    }
+
+    int start(void) { return 1; }
+    int stop(void) { return 1; }
+
+    void feed_stream(const uint8_t* data, size_t size, size_t split)
+    {
+        client.buf.assign(data, data + split);
+        client.buf.resize(size);
+        client.len = split;
+        processData(&client);
+
+        // second read appended after whatever the first left behind
+        if (size > split) {
+            memcpy(client.buf.data() + client.len, data + split, size - split);
+            client.len += size - split;
+        }
+        processData(&client);
+    }
+
+    void feed_datagram(uint8_t* data, size_t size)
+    {
+        processDatagram(data, size, 0, &dgram);
+    }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    // an exact size copy, so reads past the input are caught
+    std::vector<uint8_t> buf(data, data + size);
+    VRTPacket pkt;
+    fuzz_listener listener;
+
+    if (pkt.unpack(buf.data(), buf.size()) == 1) {
+        if (pkt.getType() == PacketType::CONTEXT) {
+            ContextPacket ctx;
+            ctx.unpack(pkt);
+            listener.received_packet(PacketType::CONTEXT, &ctx);
+        } else {
+            listener.received_packet(pkt.getType(), &pkt);
+        }
+    }
+
+    // the word at a time parser is a separate decoder of the same bytes
+    VRTPacket words;
+    for (size_t i = 0; i + 4 <= size; i += 4) {
+        uint32_t w = ((uint32_t)buf[i] << 24) | ((uint32_t)buf[i + 1] << 16) |
+                     ((uint32_t)buf[i + 2] << 8) | buf[i + 3];
+        if (words.unpack(w) != 2) {
+            words.reset();
+        }
+    }
+
+    fuzz_rx rx;
+    rx.set_sample_bytes(4);
+    rx.add_listener(&listener);
+    rx.feed_stream(buf.data(), buf.size(), size ? buf[0] % (size + 1) : 0);
+    rx.feed_datagram(buf.data(), buf.size());
+
+    return 0;
+}
@@ -165,6 +165,136 @@ namespace gr
 
     } //end test_decode2
 
+    /**
+     * Feeds a context packet with a stream id and no time stamps
+     *
+     * @return int - status of the last unpack
+     */
+    int feed_context( ContextPacket *dut, const std::vector<uint32_t> &payload )
+    {
+      int stat = dut->unpack( 0x40000000 | ( 2 + payload.size() ) );
+      stat = dut->unpack( 0x00000001 ); //stream
+      for( uint32_t w : payload )
+      {
+        stat = dut->unpack( w );
+      }
+      return stat;
+    }
+
+    void push_fixed( std::vector<uint32_t> &payload, int64_t value )
+    {
+      uint64_t raw = (uint64_t)( value * ( 1 << 20 ) );
+      payload.push_back( raw >> 32 );
+      payload.push_back( raw & 0xffffffff );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_decode_skip_fields )
+    {
+      std::vector<uint32_t> payload;
+
+      // CIF0: bandwidth, RF offset, sample rate, formatted GPS, GPS ASCII,
+      // association lists, CIF1 enable. CIF1: aux frequency, index list
+      payload.push_back( ( 1u << 29 ) | ( 1u << 26 ) | ( 1u << 21 ) | ( 1u << 14 ) |
+          ( 1u << 9 ) | ( 1u << 8 ) | ( 1u << 1 ) );
+      payload.push_back( ( 1u << 15 ) | ( 1u << 7 ) );
+
+      push_fixed( payload, 1000000 );
+      push_fixed( payload, -1000 );
+      push_fixed( payload, 2000000 );
+      payload.insert( payload.end(), 11, 0xdeadbeef );           // formatted GPS
+      payload.insert( payload.end(), { 0, 3, 1, 2, 3 } );        // 3 ASCII words
+      payload.insert( payload.end(), { ( 1 << 16 ) | 2, ( 1 << 16 ) | 0x8000 | 1,
+          9, 9, 9, 9, 9, 9 } );                                  // 1 + 2 + 1 + 2 x 1
+      push_fixed( payload, 5000000 );
+      payload.insert( payload.end(), { 3, 7, 7 } );              // index list
+
+      BOOST_REQUIRE_EQUAL( 1, feed_context( dut, payload ) );
+
+      std::vector<CifValue*> *values = dut->getValues();
+      BOOST_REQUIRE_EQUAL( 4, values->size() );
+      BOOST_REQUIRE_EQUAL( 29, values->at(0)->getId() );
+      BOOST_REQUIRE_CLOSE( 1000000, values->at(0)->getValue(), 1e-6 );
+      BOOST_REQUIRE_EQUAL( 26, values->at(1)->getId() );
+      BOOST_REQUIRE_CLOSE( -1000, values->at(1)->getValue(), 1e-6 );
+      BOOST_REQUIRE_EQUAL( 21, values->at(2)->getId() );
+      BOOST_REQUIRE_CLOSE( 2000000, values->at(2)->getValue(), 1e-6 );
+      BOOST_REQUIRE_EQUAL( 115, values->at(3)->getId() );
+      BOOST_REQUIRE_CLOSE( 5000000, values->at(3)->getValue(), 1e-6 );
+
+      // decoding again reuses the packet storage
+      dut->reset();
+      BOOST_REQUIRE_EQUAL( 1, feed_context( dut, payload ) );
+      BOOST_REQUIRE_EQUAL( 4, dut->getValues()->size() );
+    } //end test_decode_skip_fields
+
+    BOOST_AUTO_TEST_CASE( test_decode_truncated )
+    {
+      std::vector<uint32_t> payload;
+
+      // bandwidth and RF reference, but the packet ends inside the second
+      payload.push_back( ( 1u << 29 ) | ( 1u << 27 ) );
+      push_fixed( payload, 1000000 );
+      payload.push_back( 0 );
+
+      BOOST_REQUIRE_EQUAL( 1, feed_context( dut, payload ) );
+      BOOST_REQUIRE_EQUAL( 1, dut->getValues()->size() );
+      BOOST_REQUIRE_EQUAL( 29, dut->getValues()->at(0)->getId() );
+
+      // a CIF word without its fields
+      dut->reset();
+      BOOST_REQUIRE_EQUAL( 1, feed_context( dut, { 1u << 1 } ) );
+      BOOST_REQUIRE_EQUAL( 0, dut->getValues()->size() );
+    } //end test_decode_truncated
+
+    BOOST_AUTO_TEST_CASE( test_pack )
+    {
+      uint8_t buf[256];
+      VRTPacket pkt;
+      ContextPacket rx;
+
+      dut->getHeader()->setType( PacketType::CONTEXT );
+      dut->getHeader()->setTsi( TSI::UTC );
+      dut->getHeader()->setTsf( TSF::REAL_TIME );
+      dut->setStreamId( 7 );
+      dut->setTsEpoch( 100 );
+      dut->setTsFrac( 5000 );
+      dut->setChange( true );
+
+      BOOST_REQUIRE( dut->addValue( 21, 1e6 ) );
+      BOOST_REQUIRE( dut->addValue( 27, 915.125e6 ) );
+      BOOST_REQUIRE( dut->addValue( 24, -10.5 ) );
+      BOOST_REQUIRE( dut->addValue( 26, -2500.0 ) );
+      // flags and fields not reported as values can not be encoded
+      BOOST_REQUIRE( !dut->addValue( 31, 1.0 ) );
+      BOOST_REQUIRE( !dut->addValue( 16, 1.0 ) );
+
+      // header, sid, tsi, 2 tsf, cif0, 2 + 2 + 1 + 2 field words
+      size_t len = dut->pack( buf, sizeof(buf) );
+      BOOST_REQUIRE_EQUAL( (size_t )( 4 * 13 ), len );
+      BOOST_REQUIRE_EQUAL( (uint8_t )0x8d, buf[20] );
+      BOOST_REQUIRE_EQUAL( (uint8_t )0x20, buf[21] );
+
+      BOOST_REQUIRE_EQUAL( 1, pkt.unpack( buf, len ) );
+      BOOST_REQUIRE_EQUAL( 1, rx.unpack( pkt ) );
+      BOOST_REQUIRE_EQUAL( PacketType::CONTEXT, rx.getType() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )7, rx.getStreamId() );
+      BOOST_REQUIRE_EQUAL( (uint64_t )5000, rx.getTsFrac() );
+      BOOST_REQUIRE_EQUAL( true, rx.isChange() );
+
+      std::vector<CifValue*>* values = rx.getValues();
+      BOOST_REQUIRE_EQUAL( 4, (int )values->size() );
+      BOOST_REQUIRE_EQUAL( 27, values->at(0)->getId() );
+      BOOST_REQUIRE_CLOSE( 915.125e6, values->at(0)->getValue(), 1e-9 );
+      BOOST_REQUIRE_EQUAL( 26, values->at(1)->getId() );
+      BOOST_REQUIRE_CLOSE( -2500.0, values->at(1)->getValue(), 1e-9 );
+      BOOST_REQUIRE_EQUAL( 24, values->at(2)->getId() );
+      BOOST_REQUIRE_CLOSE( -10.5, values->at(2)->getValue(), 1e-9 );
+      BOOST_REQUIRE_EQUAL( 21, values->at(3)->getId() );
+      BOOST_REQUIRE_CLOSE( 1e6, values->at(3)->getValue(), 1e-9 );
+
+      return;
+    } //end test_pack
+
     BOOST_AUTO_TEST_SUITE_END()
   } /* namespace sandia_utils */
 } /* namespace gr */
@@ -111,6 +111,30 @@ namespace gr
       return;
     } //end setType
 
+    BOOST_AUTO_TEST_CASE( test_pack )
+    {
+      const uint32_t words[] = { 0x4065000c, 0x1c688008, 0x00600007 };
+
+      // pack is the inverse of unpack
+      for( size_t i = 0; i < sizeof(words) / 4; i++ )
+      {
+        vita_header h1;
+        h1.unpack( words[i] );
+        BOOST_REQUIRE_EQUAL( words[i], h1.pack() );
+      } //end for(i
+
+      dut->setType( PacketType::SIGNAL_DATA_ID );
+      dut->setC( true );
+      dut->setIndicators( 0x04 );
+      dut->setTsi( TSI::UTC );
+      dut->setTsf( TSF::REAL_TIME );
+      dut->setPktCount( 8 );
+      dut->setPacketSize( 0x8008 );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x1c688008, dut->pack() );
+
+      return;
+    } //end test_pack
+
     BOOST_AUTO_TEST_SUITE_END()
   } /* namespace sandia_utils */
 } /* namespace gr */
@@ -0,0 +1,133 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <string.h>
+#include <thread>
+#include "vitaqueue.h"
+
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    class TestFixture
+    {
+      public:
+        vita_packet_queue *dut;
+        TestFixture()
+        {
+          dut = new vita_packet_queue();
+          dut->resize( 4 );
+        }
+        virtual ~TestFixture()
+        {
+          delete dut;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_SUITE( qa_vitaqueue, TestFixture )
+
+
+
+    BOOST_AUTO_TEST_CASE( test_full_empty )
+    {
+      BOOST_REQUIRE_EQUAL( 4, dut->capacity() );
+      BOOST_REQUIRE( dut->empty() );
+      BOOST_REQUIRE( dut->front() == NULL );
+
+      // fill it, the fifth packet has no slot
+      for( int i = 0; i < 4; i++ )
+      {
+        vita_queue_slot *s = dut->acquire();
+        BOOST_REQUIRE( s != NULL );
+        s->len = i;
+        dut->publish();
+      }
+      BOOST_REQUIRE_EQUAL( 4, dut->size() );
+      BOOST_REQUIRE( dut->acquire() == NULL );
+
+      // out in order, wrapping around the slots
+      for( int i = 0; i < 10; i++ )
+      {
+        vita_queue_slot *s = dut->front();
+        BOOST_REQUIRE( s != NULL );
+        BOOST_REQUIRE_EQUAL( i, (int )s->len );
+        dut->release();
+
+        s = dut->acquire();
+        BOOST_REQUIRE( s != NULL );
+        s->len = i + 4;
+        dut->publish();
+      }
+      BOOST_REQUIRE_EQUAL( 4, dut->size() );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_recycled )
+    {
+      // slot buffers keep their size once grown
+      vita_queue_slot *s = dut->acquire();
+      s->buf.resize( 1000 );
+      dut->publish();
+      dut->release();
+      for( int i = 0; i < 3; i++ )
+      {
+        dut->acquire();
+        dut->publish();
+        dut->release();
+      }
+      BOOST_REQUIRE_EQUAL( 1000, dut->acquire()->buf.size() );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_threads )
+    {
+      const uint32_t count = 200000;
+      uint32_t next = 0;
+      bool ordered = true;
+
+      dut->resize( 64 );
+      std::thread consumer( [&]() {
+        while( next < count )
+        {
+          vita_queue_slot *s = dut->front();
+          if( s == NULL )
+          {
+            continue;
+          }
+          uint32_t v;
+          memcpy( &v, s->buf.data(), 4 );
+          ordered = ordered && ( v == next );
+          next++;
+          dut->release();
+        }
+      } );
+
+      for( uint32_t i = 0; i < count; )
+      {
+        vita_queue_slot *s = dut->acquire();
+        if( s == NULL )
+        {
+          continue;
+        }
+        s->buf.resize( 4 );
+        memcpy( s->buf.data(), &i, 4 );
+        dut->publish();
+        i++;
+      }
+      consumer.join();
+
+      BOOST_REQUIRE( ordered );
+      BOOST_REQUIRE( dut->empty() );
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
@@ -0,0 +1,196 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+#include "vitarxbase.h"
+
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    // receiver without a transport, packets are fed in directly
+    class test_rx : public vita_rx_base
+    {
+      public:
+        VRTPacket pkt;
+
+        test_rx() : vita_rx_base( 0 )
+        {
+        }
+        int start( void )
+        {
+          return 1;
+        }
+        int stop( void )
+        {
+          return 1;
+        }
+
+        // data packet with a stream ID, UTC and sample count timestamps
+        void feed( uint32_t sid, int count, uint32_t epoch, uint64_t frac, int nwords )
+        {
+          std::vector<uint32_t> words;
+          words.push_back( 0x10500000 | ( ( count & 0xf ) << 16 ) | ( 5 + nwords ) );
+          words.push_back( sid );
+          words.push_back( epoch );
+          words.push_back( (uint32_t)( frac >> 32 ) );
+          words.push_back( (uint32_t)frac );
+          words.resize( 5 + nwords, 0 );
+          for( uint32_t &w : words )
+          {
+            w = htonl( w );
+          }
+
+          BOOST_REQUIRE_EQUAL( 1, pkt.unpack( (const uint8_t *)words.data(), words.size() * 4 ) );
+          processPacket( &pkt, (const uint8_t *)words.data() );
+        }
+
+        void resync( void )
+        {
+          count_resync();
+        }
+
+        void check( void )
+        {
+          checkStats();
+        }
+
+        int timeout( void )
+        {
+          return stats_timeout_ms();
+        }
+    };
+
+    class stats_listener : public vita_rx_listener
+    {
+      public:
+        int calls;
+        std::vector<vita_stream_stats> last;
+
+        stats_listener() : calls( 0 )
+        {
+        }
+        void received_packet( PacketType type, VRTPacket *pkt )
+        {
+        }
+        void received_stats( const std::vector<vita_stream_stats> &stats, uint64_t resyncs )
+        {
+          calls++;
+          last = stats;
+        }
+    };
+
+    class TestFixture
+    {
+      public:
+        test_rx *dut;
+        TestFixture()
+        {
+          dut = new test_rx();
+        }
+        virtual ~TestFixture()
+        {
+          delete dut;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_SUITE( qa_vitarxbase, TestFixture )
+
+
+
+    BOOST_AUTO_TEST_CASE( test_seq_gaps )
+    {
+      // two streams counted separately, 14 -> 15 -> 0 wraps without a gap
+      dut->feed( 1, 14, 0, 0, 8 );
+      dut->feed( 1, 15, 0, 8, 8 );
+      dut->feed( 1, 0, 0, 16, 8 );
+      dut->feed( 2, 5, 0, 0, 8 );
+      dut->feed( 1, 3, 0, 24, 8 );
+      dut->feed( 2, 6, 0, 8, 8 );
+      dut->resync();
+
+      std::vector<vita_stream_stats> stats = dut->get_stats();
+      BOOST_REQUIRE_EQUAL( 2, (int)stats.size() );
+
+      BOOST_REQUIRE_EQUAL( (uint32_t)1, stats[0].stream_id );
+      BOOST_REQUIRE_EQUAL( (uint64_t)4, stats[0].packets );
+      BOOST_REQUIRE_EQUAL( (uint64_t)( 4 * 13 * 4 ), stats[0].bytes );
+      BOOST_REQUIRE_EQUAL( (uint64_t)2, stats[0].seq_gaps );
+
+      BOOST_REQUIRE_EQUAL( (uint32_t)2, stats[1].stream_id );
+      BOOST_REQUIRE_EQUAL( (uint64_t)2, stats[1].packets );
+      BOOST_REQUIRE_EQUAL( (uint64_t)0, stats[1].seq_gaps );
+
+      BOOST_REQUIRE_EQUAL( (uint64_t)1, dut->get_resync_count() );
+
+      return;
+    } //end test_seq_gaps
+
+    BOOST_AUTO_TEST_CASE( test_time_discont )
+    {
+      // 8 samples per packet at 4 bytes per sample
+      dut->feed( 1, 0, 10, 0, 8 );
+      dut->feed( 1, 1, 10, 8, 8 );
+      dut->feed( 1, 2, 10, 16, 8 );
+      dut->feed( 1, 3, 10, 40, 8 );
+      dut->feed( 1, 4, 10, 48, 8 );
+
+      // new second, count restarts
+      dut->feed( 1, 5, 11, 0, 8 );
+      BOOST_REQUIRE_EQUAL( (uint64_t)1, dut->get_stats()[0].ts_discont );
+
+      // 2 bytes per sample, 16 samples per packet
+      dut->set_sample_bytes( 2 );
+      dut->feed( 1, 6, 11, 8, 8 );
+      dut->feed( 1, 7, 11, 24, 8 );
+      BOOST_REQUIRE_EQUAL( (uint64_t)1, dut->get_stats()[0].ts_discont );
+
+      dut->feed( 1, 8, 11, 32, 8 );
+      BOOST_REQUIRE_EQUAL( (uint64_t)2, dut->get_stats()[0].ts_discont );
+
+      return;
+    } //end test_time_discont
+
+    BOOST_AUTO_TEST_CASE( test_stats_period )
+    {
+      stats_listener listener;
+      dut->add_listener( &listener );
+
+      // disabled by default
+      BOOST_REQUIRE_EQUAL( -1, dut->timeout() );
+      dut->feed( 7, 0, 0, 0, 8 );
+      dut->check();
+      BOOST_REQUIRE_EQUAL( 0, listener.calls );
+
+      dut->set_stats_period( 0.01 );
+      BOOST_REQUIRE( dut->timeout() <= 10 );
+      dut->check();
+      BOOST_REQUIRE_EQUAL( 0, listener.calls );
+
+      dut->feed( 7, 1, 0, 8, 8 );
+      usleep( 20000 );
+      BOOST_REQUIRE_EQUAL( 0, dut->timeout() );
+      dut->check();
+      BOOST_REQUIRE_EQUAL( 1, listener.calls );
+      BOOST_REQUIRE_EQUAL( 1, (int)listener.last.size() );
+      BOOST_REQUIRE_EQUAL( (uint64_t)2, listener.last[0].packets );
+      BOOST_REQUIRE( listener.last[0].packet_rate > 0.0 );
+      BOOST_REQUIRE( listener.last[0].packet_rate < 2.0 / 0.02 );
+
+      return;
+    } //end test_stats_period
+
+    BOOST_AUTO_TEST_SUITE_END()
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
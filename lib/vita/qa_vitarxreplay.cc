@@ -0,0 +1,291 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+#include "vitacapture.h"
+#include "vitarx.h"
+#include "vitarxreplay.h"
+
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    class count_listener : public vita_rx_listener
+    {
+      public:
+        int data;
+        int context;
+        std::vector<uint32_t> sids;
+        std::vector<uint64_t> hostNs;
+        std::vector<uint32_t> payload;
+        std::thread::id thread;
+        int delay_us;
+
+        count_listener() : data( 0 ), context( 0 ), delay_us( 0 )
+        {
+        }
+        void received_packet( PacketType type, VRTPacket *pkt )
+        {
+          thread = std::this_thread::get_id();
+          if( delay_us )
+          {
+            usleep( delay_us );
+          }
+          if( pkt->getPayloadWords() )
+          {
+            payload.push_back( pkt->getPayload()->back() );
+          }
+          if( type == PacketType::CONTEXT )
+          {
+            context++;
+          }
+          else
+          {
+            data++;
+          }
+          sids.push_back( pkt->getStreamId() );
+          hostNs.push_back( pkt->getHostTimeNs() );
+        }
+    };
+
+    // data packet with a stream ID, UTC and sample count timestamps
+    std::vector<uint8_t> make_packet( uint32_t sid, int count, int nwords )
+    {
+      std::vector<uint32_t> words;
+      words.push_back( 0x10500000 | ( ( count & 0xf ) << 16 ) | ( 5 + nwords ) );
+      words.push_back( sid );
+      words.push_back( 100 );
+      words.push_back( 0 );
+      words.push_back( count * nwords );
+      words.resize( 5 + nwords, 0 );
+      for( uint32_t &w : words )
+      {
+        w = htonl( w );
+      }
+      return std::vector<uint8_t>( (uint8_t *)words.data(), (uint8_t *)( words.data() + words.size() ) );
+    }
+
+    class TestFixture
+    {
+      public:
+        std::string path;
+        count_listener listener;
+
+        TestFixture()
+        {
+          char name[] = "/tmp/qa_vitarxreplayXXXXXX";
+          int fd = mkstemp( name );
+          close( fd );
+          path = name;
+        }
+        virtual ~TestFixture()
+        {
+          unlink( path.c_str() );
+          unlink( ( path + VITA_CAPTURE_INDEX_EXT ).c_str() );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_SUITE( qa_vitarxreplay, TestFixture )
+
+
+
+    BOOST_AUTO_TEST_CASE( test_stream_reads )
+    {
+      std::vector<uint8_t> a = make_packet( 1, 0, 16 );
+      std::vector<uint8_t> b = make_packet( 2, 1, 16 );
+      std::vector<uint8_t> c = make_packet( 1, 2, 16 );
+      uint8_t junk[4] = { 0xff, 0xff, 0xff, 0xff };
+
+      // a packet split over reads and a bad word between packets
+      vita_capture cap;
+      BOOST_REQUIRE_EQUAL( 1, cap.open( path, false ) );
+      cap.write( a.data(), 30, 1000 );
+      cap.write( a.data() + 30, a.size() - 30, 2000 );
+      cap.write( junk, 4, 3000 );
+      cap.write( b.data(), b.size(), 4000 );
+      cap.write( c.data(), c.size() - 8, 5000 );
+      cap.write( c.data() + c.size() - 8, 8, 6000 );
+      BOOST_CHECK_EQUAL( 6, cap.get_record_count() );
+      cap.close();
+
+      vita_rx_replay dut( path );
+      dut.add_listener( &listener );
+      BOOST_REQUIRE_EQUAL( 1, dut.run() );
+
+      BOOST_CHECK_EQUAL( 6, dut.get_record_count() );
+      BOOST_CHECK_EQUAL( 3, listener.data );
+      BOOST_REQUIRE_EQUAL( 3, listener.sids.size() );
+      BOOST_CHECK_EQUAL( 1, listener.sids[0] );
+      BOOST_CHECK_EQUAL( 2, listener.sids[1] );
+      BOOST_CHECK_EQUAL( 1, listener.sids[2] );
+      BOOST_CHECK_EQUAL( 1, dut.get_resync_count() );
+      BOOST_CHECK_EQUAL( a.size() + b.size() + c.size() + 4, dut.get_byte_count() );
+
+      // replaying again starts from a clean stream
+      BOOST_REQUIRE_EQUAL( 1, dut.run() );
+      BOOST_CHECK_EQUAL( 6, listener.data );
+      BOOST_CHECK_EQUAL( 2, dut.get_resync_count() );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_datagrams )
+    {
+      std::vector<uint8_t> a = make_packet( 7, 0, 8 );
+      std::vector<uint8_t> b = make_packet( 7, 1, 8 );
+
+      // a datagram with a trailing word is not a packet
+      vita_capture cap;
+      BOOST_REQUIRE_EQUAL( 1, cap.open( path, true ) );
+      cap.write( a.data(), a.size(), 1000000 );
+      b.resize( b.size() + 4, 0 );
+      cap.write( b.data(), b.size(), 2000000 );
+      cap.write( a.data(), a.size(), 3000000 );
+      cap.close();
+
+      vita_rx_replay dut( path );
+      dut.add_listener( &listener );
+      BOOST_REQUIRE_EQUAL( 1, dut.run() );
+
+      BOOST_CHECK_EQUAL( 2, listener.data );
+      BOOST_CHECK_EQUAL( 1, dut.get_resync_count() );
+      BOOST_REQUIRE_EQUAL( 2, listener.hostNs.size() );
+      BOOST_CHECK_EQUAL( 1000000, listener.hostNs[0] );
+      BOOST_CHECK_EQUAL( 3000000, listener.hostNs[1] );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_paced )
+    {
+      std::vector<uint8_t> a = make_packet( 3, 0, 8 );
+      struct timespec start, end;
+
+      vita_capture cap;
+      BOOST_REQUIRE_EQUAL( 1, cap.open( path, false ) );
+      for( int i = 0; i < 5; i++ )
+      {
+        cap.write( a.data(), a.size(), 5000000000ULL + i * 25000000ULL );
+      }
+      cap.close();
+
+      // 100 ms of recorded arrivals
+      vita_rx_replay dut( path, true );
+      dut.add_listener( &listener );
+      clock_gettime( CLOCK_MONOTONIC, &start );
+      BOOST_REQUIRE_EQUAL( 1, dut.start() );
+      while( !dut.is_done() )
+      {
+        usleep( 1000 );
+      }
+      clock_gettime( CLOCK_MONOTONIC, &end );
+      dut.stop();
+
+      double elapsed = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+      BOOST_CHECK_EQUAL( 5, listener.data );
+      BOOST_CHECK( elapsed >= 0.099 );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_capture_tcp )
+    {
+      int port = 8112;
+      std::vector<uint8_t> stream;
+      for( int i = 0; i < 50; i++ )
+      {
+        std::vector<uint8_t> p = make_packet( 9, i, 32 );
+        stream.insert( stream.end(), p.begin(), p.end() );
+      }
+
+      vita_rx rx( port );
+      count_listener live;
+      rx.add_listener( &live );
+      rx.set_capture( path );
+      BOOST_REQUIRE_EQUAL( 1, rx.start() );
+
+      int fd = socket( AF_INET, SOCK_STREAM, 0 );
+      struct sockaddr_in addr;
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons( port );
+      addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+      BOOST_REQUIRE_EQUAL( 0, connect( fd, (struct sockaddr *)&addr, sizeof(addr) ) );
+      BOOST_REQUIRE_EQUAL( (ssize_t)stream.size(), write( fd, stream.data(), stream.size() ) );
+      for( int i = 0; i < 200 && live.data < 50; i++ )
+      {
+        usleep( 10000 );
+      }
+      close( fd );
+      rx.stop();
+      BOOST_REQUIRE_EQUAL( 50, live.data );
+      BOOST_CHECK( rx.get_capture_count() > 0 );
+
+      // the replay sees what the receiver saw
+      vita_rx_replay dut( path );
+      dut.add_listener( &listener );
+      BOOST_REQUIRE_EQUAL( 1, dut.run() );
+      BOOST_CHECK_EQUAL( 50, listener.data );
+      BOOST_CHECK_EQUAL( rx.get_byte_count(), dut.get_byte_count() );
+      BOOST_CHECK_EQUAL( 0, dut.get_resync_count() );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_queue )
+    {
+      vita_capture cap;
+      BOOST_REQUIRE_EQUAL( 1, cap.open( path, true ) );
+      for( int i = 0; i < 40; i++ )
+      {
+        std::vector<uint8_t> p = make_packet( 5, i, 8 );
+        p[p.size() - 1] = i;
+        cap.write( p.data(), p.size(), 1000 + i );
+      }
+      cap.close();
+
+      // listeners run on the publisher thread, with the packet intact
+      vita_rx_replay dut( path );
+      dut.add_listener( &listener );
+      dut.set_queue_size( 64 );
+      BOOST_REQUIRE_EQUAL( 1, dut.run() );
+      BOOST_CHECK( listener.thread != std::this_thread::get_id() );
+      BOOST_REQUIRE_EQUAL( 40, listener.data );
+      BOOST_CHECK_EQUAL( 0, dut.get_queue_drop_count() );
+      BOOST_CHECK_EQUAL( 0, dut.get_queue_depth() );
+      for( int i = 0; i < 40; i++ )
+      {
+        BOOST_CHECK_EQUAL( (uint32_t )i, listener.payload[i] );
+        BOOST_CHECK_EQUAL( (uint64_t )( 1000 + i ), listener.hostNs[i] );
+      }
+
+      // a slow listener and a small queue drop packets, statistics still
+      // count every packet received
+      count_listener slow;
+      slow.delay_us = 2000;
+      vita_rx_replay dut2( path );
+      dut2.add_listener( &slow );
+      dut2.set_queue_size( 4 );
+      BOOST_REQUIRE_EQUAL( 1, dut2.run() );
+      BOOST_CHECK( dut2.get_queue_drop_count() > 0 );
+      BOOST_CHECK_EQUAL( 40, slow.data + (int )dut2.get_queue_drop_count() );
+      BOOST_CHECK_EQUAL( 4, dut2.get_queue_high_water() );
+      BOOST_CHECK_EQUAL( 40, dut2.get_totals().packets );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_missing )
+    {
+      vita_rx_replay dut( path + ".missing" );
+      BOOST_CHECK_EQUAL( 0, dut.run() );
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
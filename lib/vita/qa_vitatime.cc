@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "vitatime.h"
+
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    BOOST_AUTO_TEST_SUITE( qa_vitatime )
+
+
+
+    BOOST_AUTO_TEST_CASE( test_normalize )
+    {
+      vita_time t( 10, 2 * VITA_PS_PER_SEC + 5 );
+      BOOST_REQUIRE_EQUAL( (uint64_t )12, t.sec );
+      BOOST_REQUIRE_EQUAL( (uint64_t )5, t.ps );
+
+      // the fraction is the double nearest the picoseconds
+      BOOST_REQUIRE_EQUAL( 0.0000003, vita_time( 50, 300000 ).frac() );
+      BOOST_REQUIRE_EQUAL( 0.1, vita_time( 50, 100000000000ULL ).frac() );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_rate )
+    {
+      BOOST_REQUIRE_EQUAL( (uint64_t )0, vita_time::rate_fixed( 0.0 ) );
+      BOOST_REQUIRE_EQUAL( (uint64_t )0, vita_time::rate_fixed( -1.0 ) );
+      BOOST_REQUIRE_EQUAL( (uint64_t )1, vita_time::rate_fixed( 1e-9 ) );
+      BOOST_REQUIRE_EQUAL( 30720000ULL << VITA_RATE_RADIX, vita_time::rate_fixed( 30.72e6 ) );
+
+      // a fractional rate as a Context packet carries it
+      BOOST_REQUIRE_EQUAL( ( 1000000ULL << VITA_RATE_RADIX ) + 1,
+          vita_time::rate_fixed( 1e6 + 1.0 / 1048576.0 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_after )
+    {
+      uint64_t rate = vita_time::rate_fixed( 30.72e6 );
+      vita_time t0( 1000, 0 );
+
+      // 360 samples, not a whole number of ps
+      vita_time t1 = t0.after( 360, rate );
+      BOOST_REQUIRE_EQUAL( (uint64_t )1000, t1.sec );
+      BOOST_REQUIRE_EQUAL( (uint64_t )11718750, t1.ps );
+
+      // a day of packets lands exactly on the second, where summing the
+      // per packet duration would not
+      uint64_t day = 86400ULL * 30720000ULL;
+      BOOST_REQUIRE( vita_time( 87400, 0 ) == t0.after( day, rate ) );
+      BOOST_REQUIRE( vita_time( 87400, 11718750 ) == t0.after( day + 360, rate ) );
+
+      // 1/3 MHz is not a whole number of fixed point units, 3 s of samples
+      // is off by the rate's rounding, not by an accumulated error
+      uint64_t third = vita_time::rate_fixed( 1e6 / 3.0 );
+      vita_time t2 = t0.after( 1000000, third );
+      BOOST_REQUIRE_EQUAL( (uint64_t )1003, t2.sec );
+      BOOST_REQUIRE( t2.ps < 10000 );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_from_count )
+    {
+      uint64_t rate = vita_time::rate_fixed( 1e6 );
+      vita_time t = vita_time::from_count( 7, 250000, rate );
+      BOOST_REQUIRE_EQUAL( (uint64_t )7, t.sec );
+      BOOST_REQUIRE_EQUAL( 250000000000ULL, t.ps );
+      BOOST_REQUIRE_EQUAL( 1000000ULL, vita_time::samples_ps( 1, rate ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( test_same_sample )
+    {
+      // 1 us samples
+      uint64_t rate = vita_time::rate_fixed( 1e6 );
+      vita_time t( 100, VITA_PS_PER_SEC - 200000 );
+
+      BOOST_REQUIRE( t.same_sample( t, rate ) );
+      BOOST_REQUIRE( t.same_sample( vita_time( 100, VITA_PS_PER_SEC - 700000 ), rate ) );
+      BOOST_REQUIRE( t.same_sample( vita_time( 101, 300000 ), rate ) );
+      BOOST_REQUIRE( !t.same_sample( vita_time( 101, 300001 ), rate ) );
+      BOOST_REQUIRE( !vita_time( 101, 300001 ).same_sample( t, rate ) );
+      BOOST_REQUIRE( !t.same_sample( vita_time( 0, 0 ), rate ) );
+      BOOST_REQUIRE( !t.same_sample( vita_time( 1ULL << 40, 0 ), 1 ) );
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
@@ -220,6 +220,26 @@ namespace gr
       return;
     }
 
+    BOOST_AUTO_TEST_CASE( test_pack )
+    {
+      const uint32_t words[] = { 0x00000000, 0x00000081, 0xc0080000, 0x00c0038a };
+
+      // pack is the inverse of unpack
+      for( size_t i = 0; i < sizeof(words) / 4; i++ )
+      {
+        vita_trailer t1;
+        t1.unpack( words[i] );
+        BOOST_REQUIRE_EQUAL( words[i], t1.pack() );
+      } //end for(i
+
+      dut->setIndicator( 0, 1 );
+      dut->setIndicator( 1, 0 );
+      dut->setContextCount( 1 );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0xc0080081, dut->pack() );
+
+      return;
+    } //end test_pack
+
     BOOST_AUTO_TEST_SUITE_END()
 
   } /* namespace sandia_utils */
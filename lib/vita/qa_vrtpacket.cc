@@ -9,6 +9,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "VRTPacket.h"
+#include <string.h>
 
 
 namespace gr
@@ -161,6 +162,132 @@ namespace gr
     } //end test_decode2
 
 
+    BOOST_AUTO_TEST_CASE( test_decode_framed )
+    {
+      // same context packet as test_decode1, network byte order
+      const uint32_t words[] = { 0x4065000c, 0x00000000, 0x5ef41da6, 0x000000e5,
+          0x844fcdd5, 0x28200000, 0x00001d4c, 0x00000000, 0x000916f7, 0x20000000,
+          0x00001d4c, 0x00000000 };
+      uint8_t buf[sizeof(words)];
+      for( size_t i = 0; i < sizeof(words) / 4; i++ )
+      {
+        buf[4*i] = words[i] >> 24;
+        buf[4*i+1] = words[i] >> 16;
+        buf[4*i+2] = words[i] >> 8;
+        buf[4*i+3] = words[i];
+      }
+
+      // partial packets need more data
+      BOOST_REQUIRE_EQUAL( 2, dut->unpack( buf, 2 ) );
+      BOOST_REQUIRE_EQUAL( 2, dut->unpack( buf, sizeof(buf) - 4 ) );
+
+      BOOST_REQUIRE_EQUAL( 1, dut->unpack( buf, sizeof(buf) ) );
+      BOOST_REQUIRE_EQUAL( PacketType::CONTEXT, dut->getType() );
+      BOOST_REQUIRE_EQUAL( sizeof(buf), dut->getPacketBytes() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x5ef41da6, dut->getTsEpoch() );
+      BOOST_REQUIRE_EQUAL( (uint64_t )0xe5844fcdd5, dut->getTsFrac() );
+
+      // payload is referenced in place
+      BOOST_REQUIRE( dut->getPayloadData() == buf + 20 );
+      BOOST_REQUIRE_EQUAL( 7, (int )dut->getPayloadWords() );
+      BOOST_REQUIRE_EQUAL( 7, (int )dut->getPayload()->size() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x28200000, dut->getPayload()->at(0) );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x000916f7, dut->getPayload()->at(3) );
+
+      // a word that is not a header fails
+      BOOST_REQUIRE_EQUAL( 0, dut->unpack( buf + 4, sizeof(buf) - 4 ) );
+    } //end test_decode_framed
+
+    BOOST_AUTO_TEST_CASE( test_decode_framed_trailer )
+    {
+      // signal data with stream id, class id, UTC + real time stamps, 2
+      // payload words and a trailer
+      const uint32_t words[] = { 0x1c61000a, 0x00001234, 0x00123456, 0x00010002,
+          0x5ef41da6, 0x00000000, 0x00000010, 0x00010002, 0x00030004, 0x00000081 };
+      uint8_t buf[sizeof(words)];
+      for( size_t i = 0; i < sizeof(words) / 4; i++ )
+      {
+        buf[4*i] = words[i] >> 24;
+        buf[4*i+1] = words[i] >> 16;
+        buf[4*i+2] = words[i] >> 8;
+        buf[4*i+3] = words[i];
+      }
+
+      BOOST_REQUIRE_EQUAL( 1, dut->unpack( buf, sizeof(buf) ) );
+      BOOST_REQUIRE_EQUAL( PacketType::SIGNAL_DATA_ID, dut->getType() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x1234, dut->getStreamId() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x123456, dut->getClassId().getOui() );
+      BOOST_REQUIRE_EQUAL( (uint16_t )1, dut->getClassId().getInfoClassCode() );
+      BOOST_REQUIRE_EQUAL( (uint16_t )2, dut->getClassId().getPacketClassCode() );
+      BOOST_REQUIRE_EQUAL( (uint64_t )0x10, dut->getTsFrac() );
+      BOOST_REQUIRE_EQUAL( 2, (int )dut->getPayloadWords() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x00030004, dut->getPayload()->at(1) );
+      BOOST_REQUIRE_EQUAL( true, dut->getTrailer().isE() );
+      BOOST_REQUIRE_EQUAL( 1, dut->getTrailer().getContextCount() );
+
+      // a packet size smaller than the fields the header enables fails
+      // without reading past the packet
+      std::vector<uint8_t> small( buf, buf + 12 );
+      small[3] = 0x03;
+      BOOST_REQUIRE_EQUAL( 0, dut->unpack( small.data(), small.size() ) );
+    } //end test_decode_framed_trailer
+
+    BOOST_AUTO_TEST_CASE( test_pack )
+    {
+      // same packet as test_decode_framed_trailer
+      const uint32_t words[] = { 0x1c61000a, 0x00001234, 0x00123456, 0x00010002,
+          0x5ef41da6, 0x00000000, 0x00000010, 0x00010002, 0x00030004, 0x00000081 };
+      uint8_t buf[sizeof(words)];
+      uint8_t out[sizeof(words) + 8];
+      for( size_t i = 0; i < sizeof(words) / 4; i++ )
+      {
+        buf[4*i] = words[i] >> 24;
+        buf[4*i+1] = words[i] >> 16;
+        buf[4*i+2] = words[i] >> 8;
+        buf[4*i+3] = words[i];
+      }
+
+      // repack the referenced payload
+      BOOST_REQUIRE_EQUAL( 1, dut->unpack( buf, sizeof(buf) ) );
+      BOOST_REQUIRE_EQUAL( 7, (int )dut->getPrologueWords() );
+      BOOST_REQUIRE_EQUAL( sizeof(buf), dut->pack( out, sizeof(out) ) );
+      BOOST_REQUIRE( memcmp( buf, out, sizeof(buf) ) == 0 );
+
+      // too small
+      BOOST_REQUIRE_EQUAL( 0, (int )dut->pack( out, sizeof(buf) - 1 ) );
+
+      // built from the setters, payload from the vector
+      VRTPacket pkt;
+      pkt.getHeader()->setType( PacketType::SIGNAL_DATA_ID );
+      pkt.getHeader()->setC( true );
+      pkt.getHeader()->setIndicators( 0x04 );
+      pkt.getHeader()->setTsi( TSI::UTC );
+      pkt.getHeader()->setTsf( TSF::REAL_TIME );
+      pkt.getHeader()->setPktCount( 1 );
+      pkt.setStreamId( 0x1234 );
+      pkt.setClassId( dut->getClassId() );
+      pkt.setTsEpoch( 0x5ef41da6 );
+      pkt.setTsFrac( 0x10 );
+      pkt.getPayload()->push_back( 0x00010002 );
+      pkt.getPayload()->push_back( 0x00030004 );
+      pkt.setTrailer( dut->getTrailer() );
+
+      memset( out, 0, sizeof(out) );
+      BOOST_REQUIRE_EQUAL( sizeof(buf), pkt.pack( out, sizeof(out) ) );
+      BOOST_REQUIRE( memcmp( buf, out, sizeof(buf) ) == 0 );
+
+      // payload already in place in the output buffer
+      VRTPacket inplace;
+      inplace.getHeader()->setType( PacketType::SIGNAL_DATA );
+      memcpy( out + 4, buf + 28, 8 );
+      inplace.setPayloadData( out + 4, 2 );
+      BOOST_REQUIRE_EQUAL( 12, (int )inplace.pack( out, sizeof(out) ) );
+      BOOST_REQUIRE_EQUAL( 1, pkt.unpack( out, 12 ) );
+      BOOST_REQUIRE_EQUAL( PacketType::SIGNAL_DATA, pkt.getType() );
+      BOOST_REQUIRE_EQUAL( (uint32_t )0x00030004, pkt.getPayload()->at(1) );
+    } //end test_pack
+
+
     BOOST_AUTO_TEST_SUITE_END()
   } /* namespace sandia_utils */
 } /* namespace gr */
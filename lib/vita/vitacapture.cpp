@@ -0,0 +1,126 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <string.h>
+
+#include "vitacapture.h"
+
+namespace gr {
+namespace sandia_utils {
+
+vita_capture::vita_capture()
+{
+    dataFile = NULL;
+    indexFile = NULL;
+    offset = 0;
+    cnt_record = 0;
+
+    return;
+}
+
+vita_capture::~vita_capture()
+{
+    close();
+
+    return;
+}
+
+/**
+ * Creates the data and index files, replacing any existing capture
+ *
+ * @param path - data file, the index is path + ".idx"
+ * @param datagrams - true when each receive is one datagram
+ * @return int - 0 on error, 1 on success
+ */
+int vita_capture::open(const std::string& path, bool datagrams)
+{
+    struct vita_capture_header hdr;
+    std::string indexPath = path + VITA_CAPTURE_INDEX_EXT;
+
+    close();
+
+    dataFile = fopen(path.c_str(), "wb");
+    if (dataFile == NULL) {
+        perror("vita_capture unable to create data file");
+        return 0;
+    }
+    indexFile = fopen(indexPath.c_str(), "wb");
+    if (indexFile == NULL) {
+        perror("vita_capture unable to create index file");
+        close();
+        return 0;
+    }
+
+    // receives are small, batch them into large writes
+    setvbuf(dataFile, NULL, _IOFBF, VITA_CAPTURE_BUF_BYTES);
+    setvbuf(indexFile, NULL, _IOFBF, VITA_CAPTURE_BUF_BYTES);
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "VRTCAP01", sizeof(hdr.magic));
+    hdr.datagrams = datagrams ? 1 : 0;
+    fwrite(&hdr, sizeof(hdr), 1, indexFile);
+
+    offset = 0;
+    cnt_record = 0;
+
+    return 1;
+} // end open
+
+/**
+ * Flushes and closes the files
+ */
+void vita_capture::close(void)
+{
+    if (dataFile != NULL) {
+        fclose(dataFile);
+        dataFile = NULL;
+    }
+    if (indexFile != NULL) {
+        fclose(indexFile);
+        indexFile = NULL;
+    }
+
+    return;
+}
+
+/**
+ * Records one receive
+ *
+ * @param buf - received bytes
+ * @param len - number of bytes
+ * @param time_ns - arrival time, ns since the epoch
+ */
+void vita_capture::write(const uint8_t* buf, size_t len, uint64_t time_ns)
+{
+    struct vita_capture_record rec;
+
+    if (dataFile == NULL) {
+        return;
+    }
+
+    rec.offset = offset;
+    rec.time_ns = time_ns;
+    rec.length = len;
+    rec.reserved = 0;
+
+    if (fwrite(buf, 1, len, dataFile) != len ||
+        fwrite(&rec, sizeof(rec), 1, indexFile) != 1) {
+        // a full disk ends the capture rather than the receiver
+        perror("vita_capture write");
+        close();
+        return;
+    }
+    offset += len;
+    cnt_record++;
+
+    return;
+} // end write
+
+} /* namespace sandia_utils */
+} /* namespace gr */
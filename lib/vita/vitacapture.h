@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITACAPTURE_H_
+#define LIB_VITA_VITACAPTURE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+
+// index file name suffix
+#define VITA_CAPTURE_INDEX_EXT ".idx"
+
+// stdio buffer of each capture file
+#define VITA_CAPTURE_BUF_BYTES (4 * 1024 * 1024)
+
+namespace gr {
+namespace sandia_utils {
+
+/**
+ * Index file header
+ */
+struct vita_capture_header {
+    // "VRTCAP01"
+    char magic[8];
+
+    // 1 when each record is one datagram, 0 for a byte stream
+    uint32_t datagrams;
+    uint32_t reserved;
+};
+
+/**
+ * Index record of one receive, a read() of a TCP client or a UDP datagram
+ */
+struct vita_capture_record {
+    // offset of the bytes in the data file
+    uint64_t offset;
+
+    // arrival time, ns since the epoch
+    uint64_t time_ns;
+
+    uint32_t length;
+    uint32_t reserved;
+};
+
+/**
+ * Raw VRT capture writer
+ *
+ * Records the bytes a receiver reads exactly as they arrived, before any
+ * parsing, so a receive session can be replayed through the same parser by
+ * vita_rx_replay. The bytes go to the data file and one vita_capture_record
+ * per receive to \<path\>.idx. Both files are written through large stdio
+ * buffers from the receive thread.
+ */
+class vita_capture
+{
+private:
+    FILE* dataFile;
+    FILE* indexFile;
+    uint64_t offset;
+    uint64_t cnt_record;
+
+public:
+    vita_capture();
+    virtual ~vita_capture();
+
+    /**
+     * Creates the data and index files, replacing any existing capture
+     *
+     * @param path - data file, the index is path + ".idx"
+     * @param datagrams - true when each receive is one datagram
+     * @return int - 0 on error, 1 on success
+     */
+    int open(const std::string& path, bool datagrams);
+
+    /**
+     * Flushes and closes the files
+     */
+    void close(void);
+
+    /**
+     * Returns true while a capture is open
+     *
+     * @return bool - true if open
+     */
+    bool is_open(void) const { return dataFile != NULL; }
+
+    /**
+     * Records one receive
+     *
+     * @param buf - received bytes
+     * @param len - number of bytes
+     * @param time_ns - arrival time, ns since the epoch
+     */
+    void write(const uint8_t* buf, size_t len, uint64_t time_ns);
+
+    /**
+     * Returns the number of receives recorded
+     *
+     * @return uint64_t - records
+     */
+    uint64_t get_record_count(void) const { return cnt_record; }
+
+}; // end class vita_capture
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITACAPTURE_H_ */
@@ -109,6 +109,19 @@ uint8_t vita_class_id::getPadBitCount() const { return pad_bit_count; }
 
 void vita_class_id::setPadBitCount(uint8_t padBitCount) { pad_bit_count = padBitCount; }
 
+/**
+ * Packs the two class ID words
+ *
+ * @param out - two words, host byte order
+ */
+void vita_class_id::pack(uint32_t* out) const
+{
+    out[0] = ((uint32_t)(pad_bit_count & 0x1f) << 27) | (oui & 0x00ffffff);
+    out[1] = ((uint32_t)info_class_code << 16) | packet_class_code;
+
+    return;
+}
+
 /**
  * Debug tool, print out to STDOUT
  */
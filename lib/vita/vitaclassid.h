@@ -44,6 +44,15 @@ public:
      */
     virtual int unpack(uint32_t word_in);
 
+    using vita_base_abs::pack;
+
+    /**
+     * Packs the two class ID words
+     *
+     * @param out - two words, host byte order
+     */
+    void pack(uint32_t* out) const;
+
     /**
      * Debug tool, print out to STDOUT
      */
@@ -113,11 +113,23 @@ int vita_header::calcMinSize(void)
 }
 
 /**
- * Packs
+ * Packs the header word
  *
- * @return uint32_t
+ * @return uint32_t - header word, host byte order
  */
-uint32_t vita_header::pack(void) { return 0; }
+uint32_t vita_header::pack(void)
+{
+    uint32_t ans = packet_size;
+
+    ans |= (uint32_t)(pkt_count & 0x0f) << 16;
+    ans |= (uint32_t)(tsf & 0x03) << 20;
+    ans |= (uint32_t)(tsi & 0x03) << 22;
+    ans |= (uint32_t)(indicators & 0x07) << 24;
+    ans |= (uint32_t)(c ? 1 : 0) << 27;
+    ans |= (uint32_t)(type & 0x0f) << 28;
+
+    return ans;
+} // end pack
 
 /**
  * Debug tool, print out to STDOUT
@@ -172,6 +184,18 @@ TSI vita_header::getTsi() const { return tsi; }
 PacketType vita_header::getType() const { return type; }
 void vita_header::setType(PacketType type) { this->type = type; }
 
+void vita_header::setC(bool c) { this->c = c; }
+
+void vita_header::setIndicators(uint8_t indicators) { this->indicators = indicators; }
+
+void vita_header::setPacketSize(uint16_t packetSize) { packet_size = packetSize; }
+
+void vita_header::setPktCount(uint8_t pktCount) { pkt_count = pktCount & 0x0f; }
+
+void vita_header::setTsf(TSF tsf) { this->tsf = tsf; }
+
+void vita_header::setTsi(TSI tsi) { this->tsi = tsi; }
+
 
 } // namespace sandia_utils
 } /* namespace gr */
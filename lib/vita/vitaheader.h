@@ -49,9 +49,9 @@ public:
     virtual int unpack(uint32_t word_in);
 
     /**
-     * Packs
+     * Packs the header word
      *
-     * @return uint32_t
+     * @return uint32_t - header word, host byte order
      */
     virtual uint32_t pack(void);
 
@@ -69,6 +69,12 @@ public:
     TSI getTsi() const;
     PacketType getType() const;
     void setType(PacketType type);
+    void setC(bool c);
+    void setIndicators(uint8_t indicators);
+    void setPacketSize(uint16_t packetSize);
+    void setPktCount(uint8_t pktCount);
+    void setTsf(TSF tsf);
+    void setTsi(TSI tsi);
 
 private:
     /**
@@ -0,0 +1,36 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "vitaqueue.h"
+
+namespace gr {
+namespace sandia_utils {
+
+vita_packet_queue::vita_packet_queue() : head(0), tail(0) { return; }
+
+/**
+ * Sets the number of slots, only while neither side is running
+ *
+ * @param n - queue size in packets
+ */
+void vita_packet_queue::resize(size_t n)
+{
+    slots.resize(n);
+    for (vita_queue_slot& s : slots) {
+        s.len = 0;
+        s.hostNs = 0;
+    }
+    head.store(0);
+    tail.store(0);
+
+    return;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITAQUEUE_H_
+#define LIB_VITA_VITAQUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+namespace gr {
+namespace sandia_utils {
+
+/**
+ * One queued packet, in network byte order
+ */
+struct vita_queue_slot {
+    // packet bytes, the capacity is kept so a slot is only allocated
+    // until it has held the largest packet
+    std::vector<uint8_t> buf;
+    size_t len;
+
+    // arrival time, ns since the epoch, 0 if not known
+    uint64_t hostNs;
+};
+
+/**
+ * Bounded lock-free single producer, single consumer packet queue
+ *
+ * The slots are a recycled pool of packet buffers. The producer fills the
+ * slot from acquire() and makes it visible with publish(), the consumer
+ * reads the slot from front() and hands it back with release(). Neither
+ * side blocks, a full queue is left to the producer to count as a drop.
+ */
+class vita_packet_queue
+{
+private:
+    std::vector<vita_queue_slot> slots;
+
+    // packets published and released, each written by one side only and
+    // kept on separate cache lines
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+
+public:
+    vita_packet_queue();
+
+    /**
+     * Sets the number of slots, only while neither side is running
+     *
+     * @param n - queue size in packets
+     */
+    void resize(size_t n);
+
+    size_t capacity(void) const { return slots.size(); }
+
+    /**
+     * Returns the number of packets waiting
+     *
+     * @return size_t - queue depth
+     */
+    size_t size(void) const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool empty(void) const { return size() == 0; }
+
+    /**
+     * Returns the next free slot, producer only
+     *
+     * @return vita_queue_slot* - slot to fill, NULL if the queue is full
+     */
+    vita_queue_slot* acquire(void)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= slots.size()) {
+            return NULL;
+        }
+        return &slots[h % slots.size()];
+    }
+
+    /**
+     * Queues the slot filled from acquire(), producer only
+     */
+    void publish(void) { head.fetch_add(1, std::memory_order_seq_cst); }
+
+    /**
+     * Returns the oldest queued slot, consumer only
+     *
+     * @return vita_queue_slot* - next packet, NULL if the queue is empty
+     */
+    vita_queue_slot* front(void)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_seq_cst) == t) {
+            return NULL;
+        }
+        return &slots[t % slots.size()];
+    }
+
+    /**
+     * Frees the slot from front(), consumer only
+     */
+    void release(void) { tail.fetch_add(1, std::memory_order_release); }
+
+}; // end class vita_packet_queue
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITAQUEUE_H_ */
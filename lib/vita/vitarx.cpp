@@ -7,33 +7,28 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
-#include "ContextPacket.h"
 #include "vitarx.h"
 
 namespace gr {
 namespace sandia_utils {
 
-vita_rx::vita_rx(int _port)
+vita_rx::vita_rx(int _port, int _rcvbuf) : vita_rx_base(_port, _rcvbuf)
 {
-    port = _port;
     sockFd = -1;
-    clientFd = -1;
-    running = false;
-    connected = false;
+    epollFd = -1;
+    wakeFd = -1;
     handle = 0;
 
-    packBuf = 0x00000000;
-    packBufState = 0;
-
-    cnt_rx_byte = 0;
-
     return;
 }
 
@@ -56,11 +51,16 @@ int vita_rx::start(void)
     if (!running) {
         // start up
         if (setup_socket()) {
+            open_capture(false);
+            start_publisher();
+
             // start thread
+            running = true;
             pthread_create(&handle, NULL, vita_rx_task_launch, this);
 
-            running = true;
             ans = 1;
+        } else {
+            close_socket();
         }
     } // end if( !running
 
@@ -75,14 +75,20 @@ int vita_rx::start(void)
 int vita_rx::stop(void)
 {
     int ans = 0;
+    uint64_t one = 1;
 
     if (running) {
         running = false;
 
-        // kill thread
+        // wake the thread out of epoll_wait
+        if (write(wakeFd, &one, sizeof(one)) != sizeof(one)) {
+            perror("Error waking vita_rx");
+        }
         pthread_join(handle, NULL);
 
         close_socket();
+        close_capture();
+        stop_publisher();
 
         ans = 1;
     }
@@ -91,7 +97,7 @@ int vita_rx::stop(void)
 }
 
 /**
- * Sets up the server socket
+ * Sets up the server socket and the epoll set
  *
  * @return int - 0 on fail, 1 on success
  */
@@ -100,31 +106,40 @@ int vita_rx::setup_socket(void)
     int ans = 0;
     int opt = 1;
     struct sockaddr_in address;
-    struct timeval timeout;
+    struct epoll_event ev;
 
-    timeout.tv_sec = 1;
-    timeout.tv_usec = 0;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        perror("epoll setup");
+        return 0;
+    }
 
-    sockFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (sockFd != -1) {
         if (setsockopt(sockFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == 0) {
             address.sin_family = AF_INET;
             address.sin_addr.s_addr = INADDR_ANY;
             address.sin_port = htons(port);
 
-
-            if (setsockopt(sockFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) <
-                0) {
-                perror("Error setting RX timeout");
-            }
-            if (setsockopt(sockFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) <
-                0) {
-                perror("Error setting TX timeout");
+            // accepted sockets inherit the receive buffer, it must be set
+            // before listen for the window to scale to it
+            if (rcvBuf > 0) {
+                if (setsockopt(sockFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf)) <
+                    0) {
+                    perror("Error setting receive buffer size");
+                }
             }
 
-
             if (bind(sockFd, (struct sockaddr*)&address, sizeof(address)) == 0) {
-                if (listen(sockFd, 1) == 0) {
+                if (listen(sockFd, SOMAXCONN) == 0) {
+                    memset(&ev, 0, sizeof(ev));
+                    ev.events = EPOLLIN;
+                    ev.data.fd = sockFd;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, sockFd, &ev);
+                    ev.data.fd = wakeFd;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
                     // we are good!
                     printf("vita_rx listening on port %d\n", port);
                     ans = 1;
@@ -147,7 +162,7 @@ int vita_rx::setup_socket(void)
 } // end setup_socket
 
 /**
- * Closes the server socket
+ * Closes the server socket and all clients
  *
  * @return int - 0 on fail, 1 on success
  */
@@ -155,14 +170,22 @@ int vita_rx::close_socket(void)
 {
     int ans = 0;
 
-    if (connected) {
-        close(clientFd);
-        connected = false;
+    while (!clients.empty()) {
+        closeClient(clients.begin()->second);
     }
 
-    close(sockFd);
-
-    rxPacket.reset();
+    if (sockFd != -1) {
+        close(sockFd);
+        sockFd = -1;
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+    if (epollFd != -1) {
+        close(epollFd);
+        epollFd = -1;
+    }
 
     return ans;
 }
@@ -187,35 +210,35 @@ void* vita_rx_task_launch(void* args)
  */
 void* vita_rx::rx_task(void* args)
 {
-    uint8_t readBuf[128];
-    int stat;
+    struct epoll_event events[VITA_RX_MAX_EVENTS];
+    int n, i;
 
     while (running) {
-        if (connected) {
-            stat = read(clientFd, readBuf, sizeof(readBuf));
-            // printf("vita_rx::rx_task() read %d\n", stat );
-            if (stat > 0) {
-                // got data
-                processData(readBuf, stat);
-            } else if (stat == 0) {
-                printf("vita_rx::rx_task() client disconnect\n");
-                close(clientFd);
-                connected = false;
+        n = epoll_wait(epollFd, events, VITA_RX_MAX_EVENTS, stats_timeout_ms());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("vita_rx epoll_wait");
+            break;
+        }
+
+        for (i = 0; i < n && running; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                // stop() requested
+                continue;
+            } else if (fd == sockFd) {
+                acceptClient();
             } else {
-                // printf("vita_rx::rx_task() errno %s\n", strerror(errno) );
-                if (errno == EAGAIN) {
-                    // ignore
-                } else {
-                    perror("Client read error");
-                    // client error, disconnect
-                    close(clientFd);
-                    connected = false;
+                auto it = clients.find(fd);
+                if (it != clients.end()) {
+                    readClient(it->second);
                 }
             }
-        } else {
-            acceptClient();
-        }
+        } // end for(i
 
+        checkStats();
     } // end while( running
 
     return NULL;
@@ -223,106 +246,76 @@ void* vita_rx::rx_task(void* args)
 
 
 /**
- * Processes read data
+ * Reads available data from a client
  *
- * @param buf - buffer with data
- * @param sz - size of buffer
+ * @param client - client to read
  */
-void vita_rx::processData(uint8_t* buf, int sz)
+void vita_rx::readClient(vita_rx_client* client)
 {
-    int i;
-    int stat;
-    //uint32_t raw;
-
-    for (i = 0; i < sz; i++) {
-        // printf("%2x ", buf[i] & 0xff );
-        cnt_rx_byte++;
-
-        packBuf = (packBuf << 8) | (buf[i] & 0xff);
-        packBufState++;
-
-        if (packBufState >= 4) {
-            packBufState = 0;
-
-            // process the word
-
-            // printf("\nRaw Word %08x\n", packBuf );
-            stat = rxPacket.unpack(packBuf);
-            if (stat == 1) {
-                processPacket();
-            } else if (stat == 0) {
-                // printf(" Error rxPacket.unpacket() \n");
-                // TODO how do we handle
-            }
-        }
-    } // end for(i
-
-    return;
-} // end processData
-
-
-/**
- * Handles processing of a fully received packet
- */
-void vita_rx::processPacket(void)
-{
-    switch (rxPacket.getType()) {
-    case (PacketType::CONTEXT): {
-        ContextPacket cp;
-        cp.unpack(rxPacket);
-
-        fireReceived(&cp);
-        break;
-    }
-    default: {
-        fireReceived(&rxPacket);
-        break;
+    // one read per wakeup keeps clients fair, the buffer holds many packets
+    ssize_t stat = read(client->fd, client->buf.data() + client->len,
+                        client->buf.size() - client->len);
+    if (stat > 0) {
+        // got data
+        cnt_rx_byte += stat;
+        capture_data(client->buf.data() + client->len, stat);
+        client->len += stat;
+        processData(client);
+    } else if (stat == 0) {
+        printf("vita_rx::rx_task() client disconnect\n");
+        closeClient(client);
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        perror("Client read error");
+        // client error, disconnect
+        closeClient(client);
     }
-    }
-
-    // reset it
-    rxPacket.reset();
 
     return;
-} // end processPacket
+}
 
 
 /**
- * trys to accept a client connection
+ * Accepts all pending client connections
  */
 void vita_rx::acceptClient(void)
 {
     struct sockaddr_in clientAddr;
-    int addrlen = sizeof(clientAddr);
-    struct timeval timeout;
-
-    timeout.tv_sec = 1;
-    timeout.tv_usec = 0;
-
+    socklen_t addrlen;
+    struct epoll_event ev;
+    int fd;
+
+    while (true) {
+        addrlen = sizeof(clientAddr);
+        fd = accept4(
+            sockFd, (struct sockaddr*)&clientAddr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror(" Socket Accept: ");
+                printf(" Error %d %s\n", errno, strerror(errno));
+            }
+            break;
+        }
 
-    // wait around for a connect
-    clientFd = accept(sockFd, (struct sockaddr*)&clientAddr, (socklen_t*)&addrlen);
-    if (clientFd >= 0) {
         // success, got a client
         printf("rx_task() client connected %s\n", inet_ntoa(clientAddr.sin_addr));
 
-        if (setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) <
-            0) {
-            perror("Error setting Client RX timeout");
-        }
-        if (setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) <
-            0) {
-            perror("Error setting Client TX timeout");
+        vita_rx_client* client = new vita_rx_client();
+        client->fd = fd;
+        client->buf.resize(VITA_RX_BUF_BYTES);
+        client->len = 0;
+        client->lost = false;
+
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            perror("Error adding client");
+            close(fd);
+            delete client;
+            continue;
         }
 
-        connected = true;
-    } else {
-        if (errno == EAGAIN) {
-            // ignore
-        } else {
-            perror(" Socket Accept: ");
-            printf(" Error %d %s\n", errno, strerror(errno));
-        }
+        clients[fd] = client;
     }
 
     return;
@@ -330,33 +323,19 @@ void vita_rx::acceptClient(void)
 
 
 /**
- * Adds a listener to the class
+ * Closes a client connection
  *
- * @param listener - listener implementation
+ * @param client - client to close
  */
-void vita_rx::add_listener(vita_rx_listener* listener)
-{
-    if (listener != NULL) {
-        listeners.push_back(listener);
-    }
-
-    return;
-}
-
-void vita_rx::fireReceived(VRTPacket* pkt)
+void vita_rx::closeClient(vita_rx_client* client)
 {
-    // printf("vita_rx::fireReceived() end pkt addr %lx\n", cnt_rx_byte );
-    for (vita_rx_listener* l : listeners) {
-        try {
-            l->received_packet(pkt->getType(), pkt);
-        } catch (...) {
-            printf("Exception thrown in listener\n");
-        }
-    } // end foreach( listener
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    clients.erase(client->fd);
+    delete client;
 
     return;
 }
 
-
 } /* namespace sandia_utils */
 } /* namespace gr */
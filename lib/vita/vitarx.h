@@ -10,10 +10,18 @@
 
 #include <pthread.h>
 
+#include <map>
+#include <stddef.h>
 #include <vector>
 
 #include "VRTPacket.h"
-#include "vitarxlistener.h"
+#include "vitarxbase.h"
+
+// per client receive buffer, many packets per read at high rates
+#define VITA_RX_BUF_BYTES (4 * 1024 * 1024)
+
+// epoll events handled per wakeup
+#define VITA_RX_MAX_EVENTS 64
 
 namespace gr {
 namespace sandia_utils {
@@ -21,33 +29,32 @@ void* vita_rx_task_launch(void* args);
 
 /**
  * VITA 49 TCP receiver
+ *
+ * A single thread serves the listening socket and any number of clients
+ * with epoll. Each client has its own receive buffer and parse state, so
+ * packets from different senders never interleave.
  */
-class vita_rx
+class vita_rx : public vita_rx_base
 {
 private:
-    int port;
     int sockFd;
-    int clientFd;
-    volatile bool running;
-    bool connected;
+    int epollFd;
+    int wakeFd;
 
     pthread_t handle;
 
-    VRTPacket rxPacket;
-    volatile uint32_t packBuf;
-    volatile int packBufState;
-
-    std::vector<vita_rx_listener*> listeners;
-
-    volatile uint64_t cnt_rx_byte;
+    // connected clients by socket
+    std::map<int, vita_rx_client*> clients;
 
 public:
     /**
      * Constructor
      *
      * @param _port = TCP port to listen on
+     * @param _rcvbuf = socket receive buffer size in bytes, 0 for the system
+     * default
      */
-    vita_rx(int _port);
+    vita_rx(int _port, int _rcvbuf = 0);
     virtual ~vita_rx();
 
     /**
@@ -73,49 +80,40 @@ public:
      */
     void* rx_task(void* args);
 
-    /**
-     * Adds a listener to the class
-     *
-     * @param listener - listener implementation
-     */
-    void add_listener(vita_rx_listener* listener);
-
 
 private:
     /**
-     * Sets up the server socket
+     * Sets up the server socket and the epoll set
      *
      * @return int - 0 on fail, 1 on success
      */
     int setup_socket(void);
 
     /**
-     * Closes the server socket
+     * Closes the server socket and all clients
      *
      * @return int - 0 on fail, 1 on success
      */
     int close_socket(void);
 
     /**
-     * Processes read data
-     *
-     * @param buf - buffer with data
-     * @param sz - size of buffer
+     * Accepts all pending client connections
      */
-    void processData(uint8_t* buf, int sz);
+    void acceptClient(void);
 
     /**
-     * Handles processing of a fully received packet
+     * Reads available data from a client
+     *
+     * @param client - client to read
      */
-    void processPacket(void);
+    void readClient(vita_rx_client* client);
 
     /**
-     * trys to accept a client connection
+     * Closes a client connection
+     *
+     * @param client - client to close
      */
-    void acceptClient(void);
-
-protected:
-    void fireReceived(VRTPacket* pkt);
+    void closeClient(vita_rx_client* client);
 
 
 }; // end class vita_rx
@@ -0,0 +1,659 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "vitarxbase.h"
+#include "vitatime.h"
+
+namespace gr {
+namespace sandia_utils {
+
+static uint64_t elapsed_ns(const struct timespec& start, const struct timespec& end)
+{
+    return (uint64_t)((int64_t)(end.tv_sec - start.tv_sec) * 1000000000LL +
+                      (end.tv_nsec - start.tv_nsec));
+}
+
+/**
+ * Checks that a data packet's timestamp follows on from the previous packet
+ * of the stream
+ *
+ * @param st - stream statistics holding the previous timestamp
+ * @param epoch - integer timestamp of the packet
+ * @param frac - fractional timestamp of the packet
+ * @return bool - false on a discontinuity
+ */
+static bool time_follows(const vita_stream_stats& st, uint32_t epoch, uint64_t frac)
+{
+    switch (st.last_tsf) {
+    case (TSF::SAMPLE_COUNT): {
+        // the count restarts every integer second
+        uint64_t expected = st.last_frac + st.last_samples;
+        if (epoch == st.last_epoch) {
+            return frac == expected;
+        }
+        if (epoch == st.last_epoch + 1) {
+            if (st.rate > 0.0) {
+                return frac + (uint64_t)llround(st.rate) == expected;
+            }
+            return frac < expected;
+        }
+        return false;
+    }
+    case (TSF::REAL_TIME): {
+        // picoseconds, only checked once the sample rate is known
+        if (st.rate <= 0.0) {
+            return true;
+        }
+        uint64_t rate = vita_time::rate_fixed(st.rate);
+        vita_time expected = vita_time(st.last_epoch, st.last_frac).after(st.last_samples, rate);
+        return expected.same_sample(vita_time(epoch, frac), rate);
+    }
+    default: {
+        return true;
+    }
+    }
+}
+
+vita_rx_base::vita_rx_base(int _port, int _rcvbuf)
+{
+    port = _port;
+    rcvBuf = _rcvbuf;
+    running = false;
+
+    cnt_rx_byte = 0;
+    cnt_resync = 0;
+    sampleBytes = 4;
+
+    statsPeriod = 0.0;
+    clock_gettime(CLOCK_MONOTONIC, &statsTime);
+
+    queueSize = 0;
+    pubHandle = 0;
+    publishing = false;
+    pubWaiting = false;
+    cnt_queue_drop = 0;
+    queueHighWater = 0;
+
+    return;
+}
+
+vita_rx_base::~vita_rx_base() { return; }
+
+/**
+ * Adds a listener to the class
+ *
+ * @param listener - listener implementation
+ */
+void vita_rx_base::add_listener(vita_rx_listener* listener)
+{
+    if (listener != NULL) {
+        listeners.push_back(listener);
+    }
+
+    return;
+}
+
+/**
+ * Sets the socket receive buffer size, applied on the next start
+ *
+ * @param bytes - receive buffer size in bytes, 0 for the system default
+ */
+void vita_rx_base::set_rcvbuf(int bytes)
+{
+    rcvBuf = bytes;
+
+    return;
+}
+
+/**
+ * Records the raw bytes received to a file, applied on the next start
+ *
+ * @param path - capture file, empty to stop capturing
+ */
+void vita_rx_base::set_capture(const std::string& path)
+{
+    capturePath = path;
+
+    return;
+}
+
+/**
+ * Sets the number of packets queued between the receive thread and the
+ * listeners, applied on the next start
+ *
+ * @param packets - queue size, 0 to call listeners from the receive thread
+ */
+void vita_rx_base::set_queue_size(size_t packets)
+{
+    queueSize = packets;
+
+    return;
+}
+
+/**
+ * Sets the size of one sample in data packet payloads, used to check
+ * timestamps against the samples in each packet
+ *
+ * @param bytes - bytes per sample
+ */
+void vita_rx_base::set_sample_bytes(int bytes)
+{
+    sampleBytes = bytes;
+
+    return;
+}
+
+/**
+ * Sets how often the rates are updated and the listeners are given the
+ * statistics. A change takes effect after the next packet is received.
+ *
+ * @param seconds - statistics period, 0 disables
+ */
+void vita_rx_base::set_stats_period(double seconds)
+{
+    std::lock_guard<std::mutex> lock(statsLock);
+    statsPeriod = seconds;
+    clock_gettime(CLOCK_MONOTONIC, &statsTime);
+
+    return;
+}
+
+/**
+ * Returns a copy of the statistics of every stream ID seen
+ *
+ * @return vector\<vita_stream_stats\> - stream statistics
+ */
+std::vector<vita_stream_stats> vita_rx_base::get_stats(void)
+{
+    std::vector<vita_stream_stats> out;
+
+    std::lock_guard<std::mutex> lock(statsLock);
+    out.reserve(stats.size());
+    for (auto& it : stats) {
+        out.push_back(it.second);
+    }
+
+    return out;
+}
+
+/**
+ * Returns the statistics summed over every stream ID
+ *
+ * @return vita_stream_stats - totals, the tracking fields are not set
+ */
+vita_stream_stats vita_rx_base::get_totals(void)
+{
+    vita_stream_stats out;
+
+    std::lock_guard<std::mutex> lock(statsLock);
+    for (auto& it : stats) {
+        out.packets += it.second.packets;
+        out.bytes += it.second.bytes;
+        out.seq_gaps += it.second.seq_gaps;
+        out.ts_discont += it.second.ts_discont;
+        out.callback_ns += it.second.callback_ns;
+        out.packet_rate += it.second.packet_rate;
+        out.byte_rate += it.second.byte_rate;
+    }
+
+    return out;
+}
+
+/**
+ * Handles processing of a fully received packet
+ *
+ * @param pkt - the packet
+ * @param raw - the packet bytes pkt was unpacked from
+ */
+void vita_rx_base::processPacket(VRTPacket* pkt, const uint8_t* raw)
+{
+    struct timespec start, end;
+    vita_stream_stats* st;
+
+    switch (pkt->getType()) {
+    case (PacketType::CONTEXT): {
+        if (publishing) {
+            // the publisher decodes the fields from its copy of the bytes
+            updateStats(pkt);
+            enqueue(pkt, raw);
+            break;
+        }
+
+        ctxPacket.unpack(*pkt);
+        st = updateStats(&ctxPacket);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        fireReceived(&ctxPacket);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ctxPacket.reset();
+        {
+            std::lock_guard<std::mutex> lock(statsLock);
+            st->callback_ns += elapsed_ns(start, end);
+        }
+        break;
+    }
+    default: {
+        st = updateStats(pkt);
+
+        if (publishing) {
+            enqueue(pkt, raw);
+            break;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        fireReceived(pkt);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        {
+            std::lock_guard<std::mutex> lock(statsLock);
+            st->callback_ns += elapsed_ns(start, end);
+        }
+        break;
+    }
+    }
+
+    // reset it
+    pkt->reset();
+
+    return;
+} // end processPacket
+
+/**
+ * Updates the statistics of the stream a packet belongs to
+ *
+ * @param pkt - the packet
+ * @return vita_stream_stats* - statistics of the stream
+ */
+vita_stream_stats* vita_rx_base::updateStats(VRTPacket* pkt)
+{
+    vita_header* hdr = pkt->getHeader();
+    uint32_t id = pkt->getStreamId();
+
+    std::lock_guard<std::mutex> lock(statsLock);
+    auto it = stats.find(id);
+    if (it == stats.end()) {
+        it = stats.emplace(id, vita_stream_stats(id)).first;
+    }
+    vita_stream_stats& st = it->second;
+
+    st.packets++;
+    st.bytes += pkt->getPacketBytes();
+
+    // the packet count runs separately for data and context packets
+    bool context = (hdr->getType() == PacketType::CONTEXT ||
+                    hdr->getType() == PacketType::EXT_CONTEX);
+    int& last = context ? st.last_ctx_count : st.last_data_count;
+    int count = hdr->getPktCount();
+    if (last >= 0) {
+        st.seq_gaps += (count - last - 1) & 0xf;
+    }
+    last = count;
+
+    if (context) {
+        for (CifValue* v : *ctxPacket.getValues()) {
+            if (v->getId() == 21) {
+                st.rate = v->getValue();
+            }
+        }
+    } else {
+        TSF tsf = hdr->getTsf();
+        if (st.have_time && tsf == st.last_tsf &&
+            !time_follows(st, pkt->getTsEpoch(), pkt->getTsFrac())) {
+            st.ts_discont++;
+        }
+
+        st.have_time = (tsf != TSF::NO_TSF);
+        st.last_tsf = tsf;
+        st.last_epoch = pkt->getTsEpoch();
+        st.last_frac = pkt->getTsFrac();
+        st.last_samples = (sampleBytes > 0) ? pkt->getPayloadWords() * 4 / sampleBytes : 0;
+    }
+
+    return &st;
+} // end updateStats
+
+/**
+ * Returns the time until the statistics are next due, for the receive
+ * thread's wait
+ *
+ * @return int - timeout in ms, -1 when disabled
+ */
+int vita_rx_base::stats_timeout_ms(void)
+{
+    struct timespec now;
+    double left;
+
+    std::lock_guard<std::mutex> lock(statsLock);
+    if (statsPeriod <= 0.0) {
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left = statsPeriod - elapsed_ns(statsTime, now) * 1e-9;
+
+    return (left > 0.0) ? (int)ceil(left * 1000.0) : 0;
+}
+
+/**
+ * Updates the rates and notifies the listeners once the statistics period
+ * has elapsed. Called by the receive thread after every wakeup.
+ */
+void vita_rx_base::checkStats(void)
+{
+    std::vector<vita_stream_stats> out;
+    struct timespec now;
+    double elapsed;
+
+    {
+        std::lock_guard<std::mutex> lock(statsLock);
+        if (statsPeriod <= 0.0) {
+            return;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = elapsed_ns(statsTime, now) * 1e-9;
+        if (elapsed < statsPeriod) {
+            return;
+        }
+        statsTime = now;
+
+        out.reserve(stats.size());
+        for (auto& it : stats) {
+            vita_stream_stats& st = it.second;
+            st.packet_rate = (st.packets - st.period_packets) / elapsed;
+            st.byte_rate = (st.bytes - st.period_bytes) / elapsed;
+            st.period_packets = st.packets;
+            st.period_bytes = st.bytes;
+            out.push_back(st);
+        }
+    }
+
+    for (vita_rx_listener* l : listeners) {
+        try {
+            l->received_stats(out, cnt_resync);
+        } catch (...) {
+            printf("Exception thrown in listener\n");
+        }
+    }
+
+    return;
+} // end checkStats
+
+/**
+ * Decodes every complete packet in a stream's receive buffer and keeps any
+ * partial packet at the start of the buffer for the next read
+ *
+ * @param client - stream to process
+ */
+void vita_rx_base::processData(vita_rx_client* client)
+{
+    size_t pos = 0;
+    int stat;
+
+    while (client->len - pos >= 4) {
+        stat = client->pkt.unpack(client->buf.data() + pos, client->len - pos);
+        if (stat == 1) {
+            size_t bytes = client->pkt.getPacketBytes();
+            client->lost = false;
+            processPacket(&client->pkt, client->buf.data() + pos);
+            pos += bytes;
+        } else if (stat == 2) {
+            // wait for the rest of the packet
+            break;
+        } else {
+            // not a header, resynchronize a word at a time like the word
+            // parser
+            if (!client->lost) {
+                client->lost = true;
+                count_resync();
+            }
+            client->pkt.reset();
+            pos += 4;
+        }
+    } // end while
+
+    // keep the partial packet at the front of the buffer
+    if (pos) {
+        memmove(client->buf.data(), client->buf.data() + pos, client->len - pos);
+        client->len -= pos;
+    }
+
+    return;
+} // end processData
+
+/**
+ * Decodes a datagram holding exactly one packet
+ *
+ * @param buf - datagram
+ * @param len - datagram size in bytes
+ * @param hostNs - arrival time in ns since the epoch, 0 if not known
+ * @param pkt - packet to decode into
+ * @return bool - false if the datagram is not a single valid packet
+ */
+bool vita_rx_base::processDatagram(uint8_t* buf,
+                                   size_t len,
+                                   uint64_t hostNs,
+                                   VRTPacket* pkt)
+{
+    cnt_rx_byte += len;
+    capture_data(buf, len, hostNs);
+
+    // a datagram is exactly one packet, anything else is dropped
+    if (pkt->unpack(buf, len) != 1 || pkt->getPacketBytes() != len) {
+        pkt->reset();
+        count_resync();
+        return false;
+    }
+
+    if (hostNs) {
+        pkt->setHostTimeNs(hostNs);
+    }
+    processPacket(pkt, buf);
+
+    return true;
+} // end processDatagram
+
+/**
+ * Opens the capture file when one is set, called on start
+ *
+ * @param datagrams - true when each receive is one datagram
+ */
+void vita_rx_base::open_capture(bool datagrams)
+{
+    if (!capturePath.empty()) {
+        capture.open(capturePath, datagrams);
+    }
+
+    return;
+}
+
+/**
+ * Records received bytes when capturing
+ *
+ * @param buf - received bytes
+ * @param len - number of bytes
+ * @param hostNs - arrival time in ns since the epoch, 0 for now
+ */
+void vita_rx_base::capture_data(const uint8_t* buf, size_t len, uint64_t hostNs)
+{
+    if (capture.is_open()) {
+        if (hostNs == 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            hostNs = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+        }
+        capture.write(buf, len, hostNs);
+    }
+
+    return;
+}
+
+/**
+ * Copies a packet into the queue for the publisher thread
+ *
+ * @param pkt - the packet
+ * @param raw - the packet bytes, copied as received
+ */
+void vita_rx_base::enqueue(VRTPacket* pkt, const uint8_t* raw)
+{
+    vita_queue_slot* slot = queue.acquire();
+    if (slot == NULL) {
+        cnt_queue_drop++;
+        return;
+    }
+
+    // the slot keeps its buffer, so this only allocates for a new largest
+    // packet
+    size_t bytes = pkt->getPacketBytes();
+    if (slot->buf.size() < bytes) {
+        slot->buf.resize(bytes);
+    }
+    memcpy(slot->buf.data(), raw, bytes);
+    slot->len = bytes;
+    slot->hostNs = pkt->getHostTimeNs();
+    queue.publish();
+
+    // only the receive thread raises the mark, readers just load it
+    size_t depth = queue.size();
+    if (depth > queueHighWater.load(std::memory_order_relaxed)) {
+        queueHighWater.store(depth, std::memory_order_relaxed);
+    }
+
+    // only wake the publisher when it has gone to sleep
+    if (pubWaiting.load()) {
+        std::lock_guard<std::mutex> lock(pubLock);
+        pubCond.notify_one();
+    }
+
+    return;
+} // end enqueue
+
+/**
+ * Starts the publisher thread when the queue size is set
+ */
+void vita_rx_base::start_publisher(void)
+{
+    if (queueSize > 0 && !publishing) {
+        queue.resize(queueSize);
+        queueHighWater = 0;
+        publishing = true;
+        pthread_create(&pubHandle, NULL, vita_rx_pub_task_launch, this);
+    }
+
+    return;
+}
+
+/**
+ * Stops the publisher thread once it has published the queued packets
+ */
+void vita_rx_base::stop_publisher(void)
+{
+    if (publishing) {
+        {
+            std::lock_guard<std::mutex> lock(pubLock);
+            publishing = false;
+            pubCond.notify_one();
+        }
+        pthread_join(pubHandle, NULL);
+    }
+
+    return;
+}
+
+void* vita_rx_pub_task_launch(void* args)
+{
+    vita_rx_base* me;
+
+    me = (vita_rx_base*)args;
+
+    me->pub_task(NULL);
+
+    return NULL;
+}
+
+/**
+ * Thread task for publishing queued packets in
+ *
+ * @param args -
+ * @return void*
+ */
+void* vita_rx_base::pub_task(void* args)
+{
+    struct timespec start, end;
+    vita_queue_slot* slot;
+    VRTPacket* out;
+
+    while (true) {
+        slot = queue.front();
+        if (slot == NULL) {
+            if (!publishing) {
+                break;
+            }
+
+            // sleep until the receive thread queues a packet, the timeout
+            // covers a wakeup racing the flag
+            std::unique_lock<std::mutex> lock(pubLock);
+            pubWaiting = true;
+            pubCond.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return !queue.empty() || !publishing;
+            });
+            pubWaiting = false;
+            continue;
+        }
+
+        out = NULL;
+        if (pubPacket.unpack(slot->buf.data(), slot->len) == 1) {
+            pubPacket.setHostTimeNs(slot->hostNs);
+            out = &pubPacket;
+            if (pubPacket.getType() == PacketType::CONTEXT) {
+                pubContext.unpack(pubPacket);
+                out = &pubContext;
+            }
+        }
+
+        if (out != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            fireReceived(out);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            std::lock_guard<std::mutex> lock(statsLock);
+            auto it = stats.find(out->getStreamId());
+            if (it != stats.end()) {
+                it->second.callback_ns += elapsed_ns(start, end);
+            }
+        }
+        pubContext.reset();
+        pubPacket.reset();
+
+        // the payload is referenced in the slot until here
+        queue.release();
+    } // end while
+
+    return NULL;
+} // end pub_task
+
+void vita_rx_base::fireReceived(VRTPacket* pkt)
+{
+    for (vita_rx_listener* l : listeners) {
+        try {
+            l->received_packet(pkt->getType(), pkt);
+        } catch (...) {
+            printf("Exception thrown in listener\n");
+        }
+    } // end foreach( listener
+
+    return;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
@@ -0,0 +1,353 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITARXBASE_H_
+#define LIB_VITA_VITARXBASE_H_
+
+#include <pthread.h>
+#include <time.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ContextPacket.h"
+#include "VRTPacket.h"
+#include "vitacapture.h"
+#include "vitaqueue.h"
+#include "vitarxlistener.h"
+#include "vitastats.h"
+
+// largest VRT packet, 65535 words
+#define VITA_RX_MAX_PACKET_BYTES (65535 * 4)
+
+// default publisher queue size for the message sources, in packets
+#define VITA_RX_QUEUE_PACKETS 256
+
+namespace gr {
+namespace sandia_utils {
+void* vita_rx_pub_task_launch(void* args);
+
+/**
+ * Receive state of one byte stream, such as a connected TCP client
+ */
+struct vita_rx_client {
+    int fd;
+
+    // contiguous receive buffer, packets are decoded in place once all of
+    // their words have arrived
+    std::vector<uint8_t> buf;
+    size_t len;
+
+    VRTPacket pkt;
+
+    // true while searching for a header after a bad one
+    bool lost;
+};
+
+/**
+ * Base class of the VITA 49 receivers. Transports receive packets and hand
+ * them to processPacket(), which notifies the listeners.
+ */
+class vita_rx_base
+{
+protected:
+    int port;
+    int rcvBuf;
+    volatile bool running;
+
+    std::vector<vita_rx_listener*> listeners;
+
+    // context packets are decoded into this packet, reused for each one
+    ContextPacket ctxPacket;
+
+    volatile uint64_t cnt_rx_byte;
+
+    // per stream statistics, updated by the receive thread
+    std::mutex statsLock;
+    std::map<uint32_t, vita_stream_stats> stats;
+    uint64_t cnt_resync;
+    int sampleBytes;
+
+    // statistics period, 0 when listeners are not notified
+    double statsPeriod;
+    struct timespec statsTime;
+
+    // raw capture of the received bytes, empty path when off
+    std::string capturePath;
+    vita_capture capture;
+
+    // packets handed to the publisher thread, listeners are called from
+    // the receive thread when the queue size is 0
+    size_t queueSize;
+    vita_packet_queue queue;
+    pthread_t pubHandle;
+    volatile bool publishing;
+    std::atomic<bool> pubWaiting;
+    std::mutex pubLock;
+    std::condition_variable pubCond;
+    std::atomic<uint64_t> cnt_queue_drop;
+    std::atomic<size_t> queueHighWater;
+
+    // publisher thread packets, reused for each one
+    VRTPacket pubPacket;
+    ContextPacket pubContext;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param _port = port to listen on
+     * @param _rcvbuf = socket receive buffer size in bytes, 0 for the system
+     * default
+     */
+    vita_rx_base(int _port, int _rcvbuf = 0);
+    virtual ~vita_rx_base();
+
+    /**
+     * start receiver
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    virtual int start(void) = 0;
+
+    /**
+     * Stop receiver
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    virtual int stop(void) = 0;
+
+    /**
+     * Adds a listener to the class
+     *
+     * @param listener - listener implementation
+     */
+    void add_listener(vita_rx_listener* listener);
+
+    /**
+     * Sets the socket receive buffer size, applied on the next start
+     *
+     * @param bytes - receive buffer size in bytes, 0 for the system default
+     */
+    void set_rcvbuf(int bytes);
+
+    /**
+     * Sets the size of one sample in data packet payloads, used to check
+     * timestamps against the samples in each packet
+     *
+     * @param bytes - bytes per sample
+     */
+    void set_sample_bytes(int bytes);
+
+    /**
+     * Sets how often the rates are updated and the listeners are given the
+     * statistics
+     *
+     * @param seconds - statistics period, 0 disables
+     */
+    void set_stats_period(double seconds);
+
+    /**
+     * Records the raw bytes received to a file, with an index of the
+     * arrival time and size of every receive, for replay by
+     * vita_rx_replay. Applied on the next start, each start replaces the
+     * file.
+     *
+     * @param path - capture file, empty to stop capturing
+     */
+    void set_capture(const std::string& path);
+
+    /**
+     * Sets the number of packets queued between the receive thread and the
+     * listeners. Above 0, the receive thread copies each packet into a
+     * recycled slot of a lock-free queue and a publisher thread calls the
+     * listeners, so slow listeners do not hold up the socket. Packets
+     * arriving to a full queue are dropped and counted. Applied on the next
+     * start.
+     *
+     * @param packets - queue size, 0 to call listeners from the receive
+     * thread
+     */
+    void set_queue_size(size_t packets);
+
+    /**
+     * Returns the number of packets waiting for the publisher thread
+     *
+     * @return size_t - queue depth
+     */
+    size_t get_queue_depth(void) const { return queue.size(); }
+
+    /**
+     * Returns the largest queue depth seen since the last start
+     *
+     * @return size_t - queue high water mark
+     */
+    size_t get_queue_high_water(void) const { return queueHighWater.load(); }
+
+    /**
+     * Returns the number of packets dropped on a full queue
+     *
+     * @return uint64_t - queue drops
+     */
+    uint64_t get_queue_drop_count(void) const { return cnt_queue_drop; }
+
+    /**
+     * Returns the number of receives recorded by the current capture
+     *
+     * @return uint64_t - capture records
+     */
+    uint64_t get_capture_count(void) const { return capture.get_record_count(); }
+
+    /**
+     * Returns a copy of the statistics of every stream ID seen
+     *
+     * @return vector\<vita_stream_stats\> - stream statistics
+     */
+    std::vector<vita_stream_stats> get_stats(void);
+
+    /**
+     * Returns the statistics summed over every stream ID
+     *
+     * @return vita_stream_stats - totals, the tracking fields are not set
+     */
+    vita_stream_stats get_totals(void);
+
+    /**
+     * Returns the number of times the receiver lost packet alignment, from
+     * bad headers or malformed datagrams
+     *
+     * @return uint64_t - resync events
+     */
+    uint64_t get_resync_count(void) const { return cnt_resync; }
+
+    /**
+     * Returns the number of bytes received, including any discarded
+     *
+     * @return uint64_t - bytes received
+     */
+    uint64_t get_byte_count(void) const { return cnt_rx_byte; }
+
+protected:
+    /**
+     * Handles processing of a fully received packet
+     *
+     * @param pkt - the packet
+     * @param raw - the packet bytes pkt was unpacked from
+     */
+    void processPacket(VRTPacket* pkt, const uint8_t* raw);
+
+    void fireReceived(VRTPacket* pkt);
+
+    /**
+     * Copies a packet into the queue for the publisher thread
+     *
+     * @param pkt - the packet
+     * @param raw - the packet bytes, copied as received
+     */
+    void enqueue(VRTPacket* pkt, const uint8_t* raw);
+
+    /**
+     * Starts the publisher thread when the queue size is set, called on
+     * start before any packet is received
+     */
+    void start_publisher(void);
+
+    /**
+     * Stops the publisher thread once it has published the queued packets,
+     * called on stop after the receive thread has ended
+     */
+    void stop_publisher(void);
+
+public:
+    /**
+     * Thread task for publishing queued packets in
+     *
+     * @param args -
+     * @return void*
+     */
+    void* pub_task(void* args);
+
+protected:
+
+    /**
+     * Decodes every complete packet in a stream's receive buffer and keeps
+     * any partial packet at the start of the buffer for the next read
+     *
+     * @param client - stream to process
+     */
+    void processData(vita_rx_client* client);
+
+    /**
+     * Decodes a datagram holding exactly one packet
+     *
+     * @param buf - datagram
+     * @param len - datagram size in bytes
+     * @param hostNs - arrival time in ns since the epoch, 0 if not known
+     * @param pkt - packet to decode into
+     * @return bool - false if the datagram is not a single valid packet
+     */
+    bool processDatagram(uint8_t* buf, size_t len, uint64_t hostNs, VRTPacket* pkt);
+
+    /**
+     * Opens the capture file when one is set, called on start
+     *
+     * @param datagrams - true when each receive is one datagram
+     */
+    void open_capture(bool datagrams);
+
+    /**
+     * Closes the capture file, called on stop
+     */
+    void close_capture(void) { capture.close(); }
+
+    /**
+     * Records received bytes when capturing
+     *
+     * @param buf - received bytes
+     * @param len - number of bytes
+     * @param hostNs - arrival time in ns since the epoch, 0 for now
+     */
+    void capture_data(const uint8_t* buf, size_t len, uint64_t hostNs = 0);
+
+    /**
+     * Counts a loss of packet alignment
+     */
+    void count_resync(void) { cnt_resync++; }
+
+    /**
+     * Updates the statistics of the stream a packet belongs to
+     *
+     * @param pkt - the packet
+     * @return vita_stream_stats* - statistics of the stream
+     */
+    vita_stream_stats* updateStats(VRTPacket* pkt);
+
+    /**
+     * Returns the time until the statistics are next due, for the receive
+     * thread's wait
+     *
+     * @return int - timeout in ms, -1 when disabled
+     */
+    int stats_timeout_ms(void);
+
+    /**
+     * Updates the rates and notifies the listeners once the statistics
+     * period has elapsed. Called by the receive thread after every wakeup.
+     */
+    void checkStats(void);
+
+}; // end class vita_rx_base
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITARXBASE_H_ */
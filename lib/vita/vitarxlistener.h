@@ -8,7 +8,10 @@
 #ifndef LIB_VITA_VITARXLISTENER_H_
 #define LIB_VITA_VITARXLISTENER_H_
 
+#include <vector>
+
 #include "VRTPacket.h"
+#include "vitastats.h"
 
 namespace gr {
 namespace sandia_utils {
@@ -24,13 +27,27 @@ public:
 
 
     /**
-     * Called when a packet is received
+     * Called when a packet is received. The packet, and a payload
+     * referenced through getPayloadData(), are only valid during the call
      *
      * @param type - type of packet received
      * @param pkt - the packet received
      */
     virtual void received_packet(PacketType type, VRTPacket* pkt) = 0;
 
+    /**
+     * Called once every statistics period with the statistics of every
+     * stream ID seen
+     *
+     * @param stats - stream statistics
+     * @param resyncs - number of times the receiver lost packet alignment
+     */
+    virtual void received_stats(const std::vector<vita_stream_stats>& /*stats*/,
+                                uint64_t /*resyncs*/)
+    {
+        return;
+    }
+
 
 }; // end class vita_rx_listener
 
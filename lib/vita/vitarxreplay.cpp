@@ -0,0 +1,246 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "vitarx.h"
+#include "vitarxreplay.h"
+
+namespace gr {
+namespace sandia_utils {
+
+vita_rx_replay::vita_rx_replay(const std::string& _path, bool _paced)
+    : vita_rx_base(0, 0)
+{
+    path = _path;
+    paced = _paced;
+    handle = 0;
+    done = false;
+    cnt_record = 0;
+
+    client.fd = -1;
+    client.len = 0;
+    client.lost = false;
+
+    return;
+}
+
+vita_rx_replay::~vita_rx_replay()
+{
+    stop();
+
+    return;
+}
+
+/**
+ * Starts replaying in a thread
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_replay::start(void)
+{
+    int ans = 0;
+
+    if (!running) {
+        running = true;
+        done = false;
+        start_publisher();
+        pthread_create(&handle, NULL, vita_rx_replay_task_launch, this);
+
+        ans = 1;
+    }
+
+    return ans;
+}
+
+/**
+ * Stops the replay, waiting for the thread
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_replay::stop(void)
+{
+    int ans = 0;
+
+    if (running) {
+        running = false;
+        pthread_join(handle, NULL);
+        stop_publisher();
+
+        ans = 1;
+    }
+
+    return ans;
+}
+
+/**
+ * Replays the whole capture in the caller's thread
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_replay::run(void)
+{
+    int ans = 0;
+
+    if (!running) {
+        running = true;
+        start_publisher();
+        ans = replay();
+        stop_publisher();
+        running = false;
+    }
+
+    return ans;
+}
+
+void* vita_rx_replay_task_launch(void* args)
+{
+    vita_rx_replay* me;
+
+    me = (vita_rx_replay*)args;
+
+    me->rx_task(NULL);
+
+    return NULL;
+}
+
+/**
+ * Thread task for running the replay in
+ *
+ * @param args -
+ * @return void*
+ */
+void* vita_rx_replay::rx_task(void* args)
+{
+    replay();
+    done = true;
+
+    return NULL;
+}
+
+/**
+ * Replays the capture until it ends or the replay is stopped
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_replay::replay(void)
+{
+    struct vita_capture_header hdr;
+    struct vita_capture_record rec;
+    struct timespec start, due;
+    uint64_t firstNs = 0;
+    std::string indexPath = path + VITA_CAPTURE_INDEX_EXT;
+    int ans = 1;
+
+    FILE* data = fopen(path.c_str(), "rb");
+    FILE* index = fopen(indexPath.c_str(), "rb");
+    if (data == NULL || index == NULL) {
+        fprintf(stderr, "vita_rx_replay unable to open %s\n", path.c_str());
+        ans = 0;
+    } else if (fread(&hdr, sizeof(hdr), 1, index) != 1 ||
+               memcmp(hdr.magic, "VRTCAP01", sizeof(hdr.magic)) != 0) {
+        fprintf(stderr, "vita_rx_replay %s is not a capture index\n", indexPath.c_str());
+        ans = 0;
+    }
+
+    if (ans) {
+        // every replay starts from an empty stream
+        client.buf.resize(VITA_RX_BUF_BYTES);
+        client.len = 0;
+        client.lost = false;
+        client.pkt.reset();
+        cnt_record = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        while (running && fread(&rec, sizeof(rec), 1, index) == 1) {
+            if (paced) {
+                // wait until the record is due relative to the first one
+                if (cnt_record == 0) {
+                    firstNs = rec.time_ns;
+                }
+                uint64_t ns = start.tv_nsec + (rec.time_ns - firstNs);
+                due.tv_sec = start.tv_sec + ns / 1000000000ULL;
+                due.tv_nsec = ns % 1000000000ULL;
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) ==
+                       EINTR) {
+                }
+            }
+
+            if (!replayRecord(data, rec, hdr.datagrams != 0)) {
+                fprintf(stderr, "vita_rx_replay %s is truncated\n", path.c_str());
+                ans = 0;
+                break;
+            }
+            cnt_record++;
+
+            checkStats();
+        } // end while( running
+    }
+
+    if (data != NULL) {
+        fclose(data);
+    }
+    if (index != NULL) {
+        fclose(index);
+    }
+
+    return ans;
+} // end replay
+
+/**
+ * Hands one recorded receive to the parser
+ *
+ * @param data - capture data file
+ * @param rec - index record
+ * @param datagrams - true for a datagram capture
+ * @return int - 0 on a short data file, 1 on success
+ */
+int vita_rx_replay::replayRecord(FILE* data,
+                                 const vita_capture_record& rec,
+                                 bool datagrams)
+{
+    // records are written back to back, only seek for an edited index
+    if (ftello(data) != (off_t)rec.offset && fseeko(data, rec.offset, SEEK_SET) != 0) {
+        return 0;
+    }
+
+    if (datagrams) {
+        if (dgramBuf.size() < rec.length) {
+            dgramBuf.resize(rec.length);
+        }
+        if (fread(dgramBuf.data(), 1, rec.length, data) != rec.length) {
+            return 0;
+        }
+        processDatagram(dgramBuf.data(), rec.length, rec.time_ns, &rxPacket);
+    } else {
+        // a live read never exceeds the free space, the parse state is the
+        // same here, so this only trips on a capture from a larger buffer
+        if (rec.length > client.buf.size() - client.len) {
+            client.len = 0;
+            client.pkt.reset();
+            count_resync();
+            if (rec.length > client.buf.size()) {
+                client.buf.resize(rec.length);
+            }
+        }
+        if (fread(client.buf.data() + client.len, 1, rec.length, data) != rec.length) {
+            return 0;
+        }
+        cnt_rx_byte += rec.length;
+        client.len += rec.length;
+        processData(&client);
+    }
+
+    return 1;
+} // end replayRecord
+
+} /* namespace sandia_utils */
+} /* namespace gr */
@@ -0,0 +1,130 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITARXREPLAY_H_
+#define LIB_VITA_VITARXREPLAY_H_
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "VRTPacket.h"
+#include "vitacapture.h"
+#include "vitarxbase.h"
+
+namespace gr {
+namespace sandia_utils {
+void* vita_rx_replay_task_launch(void* args);
+
+/**
+ * VITA 49 capture replay
+ *
+ * Replays a capture recorded with vita_rx_base::set_capture() through the
+ * same parsing as the live receivers. Stream captures are fed read by read
+ * through processData(), datagram captures datagram by datagram with their
+ * recorded arrival times, so listeners and statistics see what the live
+ * receiver saw. Replay runs as fast as possible, or paced at the recorded
+ * arrival times.
+ */
+class vita_rx_replay : public vita_rx_base
+{
+private:
+    std::string path;
+    bool paced;
+
+    pthread_t handle;
+    volatile bool done;
+
+    // replay state, one stream or one datagram packet
+    vita_rx_client client;
+    VRTPacket rxPacket;
+    std::vector<uint8_t> dgramBuf;
+
+    uint64_t cnt_record;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param _path - capture file, the index is _path + ".idx"
+     * @param _paced - true to replay at the recorded arrival times, false
+     * as fast as possible
+     */
+    vita_rx_replay(const std::string& _path, bool _paced = false);
+    virtual ~vita_rx_replay();
+
+    /**
+     * Starts replaying in a thread
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int start(void);
+
+    /**
+     * Stops the replay, waiting for the thread
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int stop(void);
+
+    /**
+     * Replays the whole capture in the caller's thread
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int run(void);
+
+    /**
+     * Returns true once a replay started with start() has finished
+     *
+     * @return bool - true when done
+     */
+    bool is_done(void) const { return done; }
+
+    /**
+     * Returns the number of receives replayed
+     *
+     * @return uint64_t - capture records
+     */
+    uint64_t get_record_count(void) const { return cnt_record; }
+
+    /**
+     * Thread task for running the replay in
+     *
+     * @param args -
+     * @return void*
+     */
+    void* rx_task(void* args);
+
+private:
+    /**
+     * Replays the capture until it ends or the replay is stopped
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int replay(void);
+
+    /**
+     * Hands one recorded receive to the parser
+     *
+     * @param data - capture data file
+     * @param rec - index record
+     * @param datagrams - true for a datagram capture
+     * @return int - 0 on a short data file, 1 on success
+     */
+    int replayRecord(FILE* data, const vita_capture_record& rec, bool datagrams);
+
+}; // end class vita_rx_replay
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITARXREPLAY_H_ */
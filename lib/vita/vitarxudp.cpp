@@ -0,0 +1,308 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "vitarxudp.h"
+
+namespace gr {
+namespace sandia_utils {
+
+vita_rx_udp::vita_rx_udp(int _port, int _rcvbuf) : vita_rx_base(_port, _rcvbuf)
+{
+    sockFd = -1;
+    wakeFd = -1;
+    timestamps = false;
+    handle = 0;
+
+    cnt_rx_pkt = 0;
+    cnt_drop = 0;
+
+    // the ring is set up once, recvmmsg refills it in place
+    rxBuf.resize(VITA_UDP_BATCH * VITA_UDP_MAX_DATAGRAM);
+    cmsgBuf.resize(VITA_UDP_BATCH * VITA_UDP_CMSG_BYTES);
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < VITA_UDP_BATCH; i++) {
+        iovecs[i].iov_base = rxBuf.data() + i * VITA_UDP_MAX_DATAGRAM;
+        iovecs[i].iov_len = VITA_UDP_MAX_DATAGRAM;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return;
+}
+
+vita_rx_udp::~vita_rx_udp()
+{
+    stop();
+
+    return;
+}
+
+/**
+ * start receiver
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_udp::start(void)
+{
+    int ans = 0;
+
+    if (!running) {
+        if (setup_socket()) {
+            open_capture(true);
+            start_publisher();
+
+            running = true;
+            pthread_create(&handle, NULL, vita_rx_udp_task_launch, this);
+
+            ans = 1;
+        } else {
+            close_socket();
+        }
+    }
+
+    return ans;
+}
+
+/**
+ * Stop receiver
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_rx_udp::stop(void)
+{
+    int ans = 0;
+    uint64_t one = 1;
+
+    if (running) {
+        running = false;
+
+        // wake the thread out of poll
+        if (write(wakeFd, &one, sizeof(one)) != sizeof(one)) {
+            perror("Error waking vita_rx_udp");
+        }
+        pthread_join(handle, NULL);
+
+        close_socket();
+        close_capture();
+        stop_publisher();
+
+        ans = 1;
+    }
+
+    return ans;
+}
+
+/**
+ * Enables kernel receive timestamps
+ *
+ * @param enable - true to timestamp datagrams
+ */
+void vita_rx_udp::set_timestamps(bool enable)
+{
+    timestamps = enable;
+
+    return;
+}
+
+/**
+ * Sets up the UDP socket
+ *
+ * @return int - 0 on fail, 1 on success
+ */
+int vita_rx_udp::setup_socket(void)
+{
+    int ans = 0;
+    int opt = 1;
+    struct sockaddr_in address;
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        perror("eventfd");
+        return 0;
+    }
+
+    sockFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sockFd != -1) {
+        if (setsockopt(sockFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) != 0) {
+            perror("setsockopt");
+        }
+        if (rcvBuf > 0) {
+            if (setsockopt(sockFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf)) < 0) {
+                perror("Error setting receive buffer size");
+            }
+        }
+        if (timestamps) {
+            if (setsockopt(sockFd, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(opt)) < 0) {
+                perror("Error enabling receive timestamps");
+            }
+        }
+
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = INADDR_ANY;
+        address.sin_port = htons(port);
+        if (bind(sockFd, (struct sockaddr*)&address, sizeof(address)) == 0) {
+            printf("vita_rx_udp listening on port %d\n", port);
+            ans = 1;
+        } else {
+            perror("bind error");
+        }
+    } else {
+        perror("Socket Error");
+    }
+
+    return ans;
+} // end setup_socket
+
+/**
+ * Closes the UDP socket
+ *
+ * @return int - 0 on fail, 1 on success
+ */
+int vita_rx_udp::close_socket(void)
+{
+    int ans = 0;
+
+    if (sockFd != -1) {
+        close(sockFd);
+        sockFd = -1;
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+
+    rxPacket.reset();
+
+    return ans;
+}
+
+
+void* vita_rx_udp_task_launch(void* args)
+{
+    vita_rx_udp* me;
+
+    me = (vita_rx_udp*)args;
+
+    me->rx_task(NULL);
+
+    return NULL;
+}
+
+/**
+ * Thread task for running UDP receive in
+ *
+ * @param args -
+ * @return void*
+ */
+void* vita_rx_udp::rx_task(void* args)
+{
+    struct pollfd fds[2];
+    int n, i;
+
+    fds[0].fd = sockFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd;
+    fds[1].events = POLLIN;
+
+    while (running) {
+        if (poll(fds, 2, stats_timeout_ms()) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("vita_rx_udp poll");
+            break;
+        }
+        if (fds[1].revents) {
+            // stop() requested
+            break;
+        }
+
+        // drain the socket a batch at a time
+        while (running) {
+            for (i = 0; i < VITA_UDP_BATCH; i++) {
+                msgs[i].msg_hdr.msg_control =
+                    timestamps ? cmsgBuf.data() + i * VITA_UDP_CMSG_BYTES : NULL;
+                msgs[i].msg_hdr.msg_controllen = timestamps ? VITA_UDP_CMSG_BYTES : 0;
+                msgs[i].msg_hdr.msg_flags = 0;
+            }
+
+            n = recvmmsg(sockFd, msgs, VITA_UDP_BATCH, MSG_DONTWAIT, NULL);
+            if (n <= 0) {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    perror("vita_rx_udp recvmmsg");
+                }
+                break;
+            }
+
+            for (i = 0; i < n; i++) {
+                processDatagram(&msgs[i], rxBuf.data() + i * VITA_UDP_MAX_DATAGRAM);
+            }
+
+            if (n < VITA_UDP_BATCH) {
+                break;
+            }
+        }
+
+        checkStats();
+    } // end while( running
+
+    return NULL;
+} // end rx_task
+
+/**
+ * Decodes one received datagram
+ *
+ * @param msg - received message header
+ * @param buf - datagram buffer
+ */
+void vita_rx_udp::processDatagram(struct mmsghdr* msg, uint8_t* buf)
+{
+    size_t len = msg->msg_len;
+    uint64_t hostNs = 0;
+
+    if (msg->msg_hdr.msg_flags & MSG_TRUNC) {
+        cnt_rx_byte += len;
+        cnt_drop++;
+        count_resync();
+        return;
+    }
+
+    if (timestamps) {
+        struct cmsghdr* cmsg;
+        for (cmsg = CMSG_FIRSTHDR(&msg->msg_hdr); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg->msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                hostNs = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+            }
+        }
+    }
+
+    if (processDatagram(buf, len, hostNs, &rxPacket)) {
+        cnt_rx_pkt++;
+    } else {
+        cnt_drop++;
+    }
+
+    return;
+} // end processDatagram
+
+} /* namespace sandia_utils */
+} /* namespace gr */
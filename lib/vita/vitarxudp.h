@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITARXUDP_H_
+#define LIB_VITA_VITARXUDP_H_
+
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <vector>
+
+#include "VRTPacket.h"
+#include "vitarxbase.h"
+
+// datagrams received per recvmmsg call
+#define VITA_UDP_BATCH 64
+
+// largest UDP payload
+#define VITA_UDP_MAX_DATAGRAM 65536
+
+// control buffer per datagram, room for a timespec cmsg
+#define VITA_UDP_CMSG_BYTES 64
+
+namespace gr {
+namespace sandia_utils {
+void* vita_rx_udp_task_launch(void* args);
+
+/**
+ * VITA 49 UDP receiver
+ *
+ * Each datagram carries one packet, which is decoded in place in a
+ * preallocated ring of datagram buffers filled a batch at a time with
+ * recvmmsg.
+ */
+class vita_rx_udp : public vita_rx_base
+{
+private:
+    int sockFd;
+    int wakeFd;
+    bool timestamps;
+
+    pthread_t handle;
+
+    VRTPacket rxPacket;
+
+    // datagram ring, one buffer, iovec and header per batch slot
+    std::vector<uint8_t> rxBuf;
+    std::vector<uint8_t> cmsgBuf;
+    struct iovec iovecs[VITA_UDP_BATCH];
+    struct mmsghdr msgs[VITA_UDP_BATCH];
+
+    volatile uint64_t cnt_rx_pkt;
+    volatile uint64_t cnt_drop;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param _port = UDP port to listen on
+     * @param _rcvbuf = socket receive buffer size in bytes, 0 for the system
+     * default
+     */
+    vita_rx_udp(int _port, int _rcvbuf = 0);
+    virtual ~vita_rx_udp();
+
+    /**
+     * start receiver
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    virtual int start(void);
+
+    /**
+     * Stop receiver
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    virtual int stop(void);
+
+    /**
+     * Thread task for running UDP receive in
+     *
+     * @param args -
+     * @return void*
+     */
+    void* rx_task(void* args);
+
+    /**
+     * Enables kernel receive timestamps (SO_TIMESTAMPNS), reported through
+     * VRTPacket::getHostTimeNs(). Applied on the next start.
+     *
+     * @param enable - true to timestamp datagrams
+     */
+    void set_timestamps(bool enable);
+
+    /**
+     * Returns the number of datagrams that were not a valid packet
+     *
+     * @return uint64_t - dropped datagrams
+     */
+    uint64_t get_drop_count(void) const { return cnt_drop; }
+
+private:
+    /**
+     * Sets up the UDP socket
+     *
+     * @return int - 0 on fail, 1 on success
+     */
+    int setup_socket(void);
+
+    /**
+     * Closes the UDP socket
+     *
+     * @return int - 0 on fail, 1 on success
+     */
+    int close_socket(void);
+
+    /**
+     * Decodes one received datagram
+     *
+     * @param msg - received message header
+     * @param buf - datagram buffer
+     */
+    void processDatagram(struct mmsghdr* msg, uint8_t* buf);
+    using vita_rx_base::processDatagram;
+
+}; // end class vita_rx_udp
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITARXUDP_H_ */
@@ -0,0 +1,87 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITASTATS_H_
+#define LIB_VITA_VITASTATS_H_
+
+#include <stdint.h>
+
+#include "vitatypes.h"
+
+namespace gr {
+namespace sandia_utils {
+
+/**
+ * Receive statistics of one stream ID
+ */
+struct vita_stream_stats {
+    uint32_t stream_id;
+
+    // packets and bytes received, headers included
+    uint64_t packets;
+    uint64_t bytes;
+
+    // packets missing from the 4 bit packet count
+    uint64_t seq_gaps;
+
+    // data packets whose timestamp did not follow on from the previous one
+    uint64_t ts_discont;
+
+    // time spent in listener callbacks
+    uint64_t callback_ns;
+
+    // rates over the last stats period
+    double packet_rate;
+    double byte_rate;
+
+    // sequence tracking, -1 until the first packet of each class
+    int last_data_count;
+    int last_ctx_count;
+
+    // timestamp of the last data packet and the samples it carried
+    bool have_time;
+    TSF last_tsf;
+    uint32_t last_epoch;
+    uint64_t last_frac;
+    uint64_t last_samples;
+
+    // sample rate from context CIF 21, 0 when unknown
+    double rate;
+
+    // counters at the start of the current stats period
+    uint64_t period_packets;
+    uint64_t period_bytes;
+
+    vita_stream_stats(uint32_t id = 0)
+        : stream_id(id),
+          packets(0),
+          bytes(0),
+          seq_gaps(0),
+          ts_discont(0),
+          callback_ns(0),
+          packet_rate(0.0),
+          byte_rate(0.0),
+          last_data_count(-1),
+          last_ctx_count(-1),
+          have_time(false),
+          last_tsf(NO_TSF),
+          last_epoch(0),
+          last_frac(0),
+          last_samples(0),
+          rate(0.0),
+          period_packets(0),
+          period_bytes(0)
+    {
+    }
+};
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITASTATS_H_ */
@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "vitatime.h"
+
+#include <math.h>
+
+namespace gr {
+namespace sandia_utils {
+
+typedef unsigned __int128 uint128_t;
+
+/**
+ * Returns the duration of a number of samples to the nearest ps, in 128
+ * bits so any sample count fits
+ */
+static uint128_t duration_ps(uint64_t nsamples, uint64_t rate)
+{
+    uint128_t num = ((uint128_t)nsamples * VITA_PS_PER_SEC) << VITA_RATE_RADIX;
+
+    return (num + rate / 2) / rate;
+}
+
+vita_time::vita_time(uint64_t _sec, uint64_t _ps)
+{
+    sec = _sec + _ps / VITA_PS_PER_SEC;
+    ps = _ps % VITA_PS_PER_SEC;
+
+    return;
+}
+
+/**
+ * Returns a sample rate as 44.20 fixed point Hz, exact for any rate
+ * decoded from a Context packet
+ *
+ * @param rate - sample rate in Hz
+ * @return uint64_t - fixed point rate, 0 if rate is not positive
+ */
+uint64_t vita_time::rate_fixed(double rate)
+{
+    if (!(rate > 0.0)) {
+        return 0;
+    }
+
+    uint64_t fixed = (uint64_t)llround(ldexp(rate, VITA_RATE_RADIX));
+
+    return (fixed > 0) ? fixed : 1;
+}
+
+/**
+ * Returns the duration of a number of samples, which must be under
+ * about 200 days
+ *
+ * @param nsamples - number of samples
+ * @param rate - fixed point sample rate, non zero
+ * @return uint64_t - duration, to the nearest ps
+ */
+uint64_t vita_time::samples_ps(uint64_t nsamples, uint64_t rate)
+{
+    return (uint64_t)duration_ps(nsamples, rate);
+}
+
+/**
+ * Returns the time of a Sample Count timestamp
+ *
+ * @param sec - integer seconds
+ * @param count - samples since the start of the second
+ * @param rate - fixed point sample rate, non zero
+ * @return vita_time - time of the sample, to the nearest ps
+ */
+vita_time vita_time::from_count(uint64_t sec, uint64_t count, uint64_t rate)
+{
+    return vita_time(sec, samples_ps(count, rate));
+}
+
+/**
+ * Returns the time a number of samples after this one
+ *
+ * @param nsamples - samples since this time
+ * @param rate - fixed point sample rate, non zero
+ * @return vita_time - later time, to the nearest ps
+ */
+vita_time vita_time::after(uint64_t nsamples, uint64_t rate) const
+{
+    uint128_t dt = duration_ps(nsamples, rate) + ps;
+
+    return vita_time(sec + (uint64_t)(dt / VITA_PS_PER_SEC), (uint64_t)(dt % VITA_PS_PER_SEC));
+}
+
+/**
+ * Returns true if this time is within half a sample of another
+ *
+ * @param t - time to compare
+ * @param rate - fixed point sample rate, non zero
+ * @return bool - true if the times land on the same sample
+ */
+bool vita_time::same_sample(const vita_time& t, uint64_t rate) const
+{
+    const vita_time& hi = (*this < t) ? t : *this;
+    const vita_time& lo = (*this < t) ? *this : t;
+
+    // |difference| <= half a period, i.e. 2 * diff * rate <= 1 s. Rates
+    // are at least one fixed point unit, which bounds the difference and
+    // keeps the product in 128 bits
+    uint128_t diff = (uint128_t)(hi.sec - lo.sec) * VITA_PS_PER_SEC + hi.ps - lo.ps;
+    uint128_t one = (uint128_t)VITA_PS_PER_SEC << VITA_RATE_RADIX;
+    if (diff > one / 2) {
+        return false;
+    }
+
+    return ((uint128_t)2 * diff * rate) <= one;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
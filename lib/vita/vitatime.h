@@ -0,0 +1,114 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITATIME_H_
+#define LIB_VITA_VITATIME_H_
+
+#include <stdint.h>
+
+// picoseconds per second, the unit of a Real Time fractional timestamp
+#define VITA_PS_PER_SEC 1000000000000ULL
+
+// fractional bits of a VITA 49 sample rate (CIF 21), 44.20 fixed point Hz
+#define VITA_RATE_RADIX 20
+
+namespace gr {
+namespace sandia_utils {
+
+/**
+ * Exact VITA 49 time, integer seconds and picoseconds
+ *
+ * Sample rates are carried as the 44.20 fixed point Hz of the Context
+ * packet, so the time of any sample after a reference is computed in
+ * integer arithmetic from the sample offset rather than accumulated
+ * packet by packet.
+ */
+class vita_time
+{
+public:
+    uint64_t sec;
+
+    // picoseconds into the second, always below VITA_PS_PER_SEC
+    uint64_t ps;
+
+    vita_time() : sec(0), ps(0) {}
+
+    /**
+     * @param _sec - integer seconds
+     * @param _ps - picoseconds, whole seconds are carried into sec
+     */
+    vita_time(uint64_t _sec, uint64_t _ps);
+
+    /**
+     * Returns a sample rate as 44.20 fixed point Hz, exact for any rate
+     * decoded from a Context packet
+     *
+     * @param rate - sample rate in Hz
+     * @return uint64_t - fixed point rate, 0 if rate is not positive
+     */
+    static uint64_t rate_fixed(double rate);
+
+    /**
+     * Returns the time of a Sample Count timestamp
+     *
+     * @param sec - integer seconds
+     * @param count - samples since the start of the second
+     * @param rate - fixed point sample rate, non zero
+     * @return vita_time - time of the sample, to the nearest ps
+     */
+    static vita_time from_count(uint64_t sec, uint64_t count, uint64_t rate);
+
+    /**
+     * Returns the duration of a number of samples, which must be under
+     * about 200 days
+     *
+     * @param nsamples - number of samples
+     * @param rate - fixed point sample rate, non zero
+     * @return uint64_t - duration, to the nearest ps
+     */
+    static uint64_t samples_ps(uint64_t nsamples, uint64_t rate);
+
+    /**
+     * Returns the time a number of samples after this one
+     *
+     * @param nsamples - samples since this time
+     * @param rate - fixed point sample rate, non zero
+     * @return vita_time - later time, to the nearest ps
+     */
+    vita_time after(uint64_t nsamples, uint64_t rate) const;
+
+    /**
+     * Returns true if this time is within half a sample of another
+     *
+     * @param t - time to compare
+     * @param rate - fixed point sample rate, non zero
+     * @return bool - true if the times land on the same sample
+     */
+    bool same_sample(const vita_time& t, uint64_t rate) const;
+
+    /**
+     * Returns the fractional second, the double nearest to ps / 1e12
+     *
+     * @return double - fractional seconds
+     */
+    double frac(void) const { return (double)ps / (double)VITA_PS_PER_SEC; }
+
+    bool operator==(const vita_time& t) const { return sec == t.sec && ps == t.ps; }
+    bool operator!=(const vita_time& t) const { return !(*this == t); }
+    bool operator<(const vita_time& t) const
+    {
+        return sec < t.sec || (sec == t.sec && ps < t.ps);
+    }
+
+}; // end class vita_time
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITATIME_H_ */
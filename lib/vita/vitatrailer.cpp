@@ -60,6 +60,53 @@ const uint8_t vita_trailer::getIndicators(int idx) const
     return ans;
 }
 
+/**
+ * Sets an indicator and its enable bit
+ *
+ * @param idx - indicator index, 0 for the calibrated time indicator
+ * @param value - indicator value
+ */
+void vita_trailer::setIndicator(int idx, bool value)
+{
+    if (0 <= idx && idx < 12) {
+        enables[idx] = 1;
+        indicators[idx] = value ? 1 : 0;
+    }
+
+    return;
+}
+
+/**
+ * Sets the associated context packet count, enabling it
+ *
+ * @param count - context packet count, 0 - 127
+ */
+void vita_trailer::setContextCount(int count)
+{
+    e = true;
+    context_count = count & 0x7f;
+
+    return;
+}
+
+/**
+ * Sets the Sample Frame indicators
+ *
+ * @param ind - sample frame state, SF_NONE disables the indicators
+ */
+void vita_trailer::setSampleFrameIndicator(SampleFrameInd ind)
+{
+    if (ind == SF_NONE) {
+        enables[8] = enables[9] = 0;
+        indicators[8] = indicators[9] = 0;
+    } else {
+        setIndicator(8, (ind >> 1) & 0x01);
+        setIndicator(9, ind & 0x01);
+    }
+
+    return;
+}
+
 /**
  * Unpacks a 32byte word.
  *
@@ -93,6 +140,32 @@ int vita_trailer::unpack(uint32_t word_in)
 } // end unpack
 
 
+/**
+ * Packs the trailer word
+ *
+ * @return uint32_t - trailer word, host byte order
+ */
+uint32_t vita_trailer::pack(void)
+{
+    uint32_t ans = 0;
+    int i;
+
+    for (i = 0; i < 12; i++) {
+        if (enables[i]) {
+            ans |= 0x01u << (31 - i);
+        }
+        if (indicators[i]) {
+            ans |= 0x01u << (19 - i);
+        }
+    }
+
+    if (e) {
+        ans |= 0x80 | (context_count & 0x7f);
+    }
+
+    return ans;
+} // end pack
+
 /**
  * Debug tool, print out to STDOUT
  */
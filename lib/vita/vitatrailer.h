@@ -38,6 +38,28 @@ public:
 
     const uint8_t getIndicators(int idx) const;
 
+    /**
+     * Sets an indicator and its enable bit
+     *
+     * @param idx - indicator index, 0 for the calibrated time indicator
+     * @param value - indicator value
+     */
+    void setIndicator(int idx, bool value);
+
+    /**
+     * Sets the associated context packet count, enabling it
+     *
+     * @param count - context packet count, 0 - 127
+     */
+    void setContextCount(int count);
+
+    /**
+     * Sets the Sample Frame indicators
+     *
+     * @param ind - sample frame state, SF_NONE disables the indicators
+     */
+    void setSampleFrameIndicator(SampleFrameInd ind);
+
     /**
      * Unpacks a 32byte word.
      *
@@ -46,6 +68,13 @@ public:
      */
     virtual int unpack(uint32_t word_in);
 
+    /**
+     * Packs the trailer word
+     *
+     * @return uint32_t - trailer word, host byte order
+     */
+    virtual uint32_t pack(void);
+
     /**
      * Debug tool, print out to STDOUT
      */
@@ -0,0 +1,392 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "vitatx.h"
+
+// time allowed for a TCP connect
+#define VITA_TX_CONNECT_MS 100
+
+namespace gr {
+namespace sandia_utils {
+
+namespace {
+double monotonic_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+} // namespace
+
+vita_tx::vita_tx(
+    const std::string& _host, int _port, bool _udp, size_t _maxPacket, int _sndbuf)
+{
+    host = _host;
+    port = _port;
+    udp = _udp;
+    sndBuf = _sndbuf;
+    maxPacket = _maxPacket;
+
+    sockFd = -1;
+    running = false;
+    lastConnect = -1e9;
+    first = 0;
+    queued = 0;
+
+    cnt_tx_pkt = 0;
+    cnt_tx_byte = 0;
+    cnt_drop = 0;
+
+    // the ring is set up once, packets are packed into it in place
+    txBuf.resize(VITA_TX_BATCH * maxPacket);
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < VITA_TX_BATCH; i++) {
+        iovecs[i].iov_base = txBuf.data() + i * maxPacket;
+        iovecs[i].iov_len = 0;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return;
+}
+
+vita_tx::~vita_tx()
+{
+    stop();
+
+    return;
+}
+
+/**
+ * Start transmitter
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_tx::start(void)
+{
+    int ans = 0;
+
+    if (!running) {
+        first = 0;
+        queued = 0;
+        lastConnect = -1e9;
+
+        // TCP connects as packets are sent when the receiver is not up yet
+        if (setup_socket() || !udp) {
+            running = true;
+            ans = 1;
+        }
+    }
+
+    return ans;
+}
+
+/**
+ * Stop transmitter, sending any queued packets first
+ *
+ * @return int - 0 on error, 1 on success
+ */
+int vita_tx::stop(void)
+{
+    int ans = 0;
+
+    if (running) {
+        flush();
+        running = false;
+        close_socket();
+
+        ans = 1;
+    }
+
+    return ans;
+}
+
+/**
+ * Returns the buffer of the next packet to send
+ *
+ * @return uint8_t* - buffer of getMaxPacket() bytes
+ */
+uint8_t* vita_tx::getBuffer(void)
+{
+    if (queued >= VITA_TX_BATCH) {
+        flush();
+    }
+
+    return (uint8_t*)iovecs[(first + queued) % VITA_TX_BATCH].iov_base;
+}
+
+/**
+ * Queues the packet packed into the buffer from getBuffer()
+ *
+ * @param len - packet size in bytes
+ */
+void vita_tx::commit(size_t len)
+{
+    if (len == 0 || len > maxPacket) {
+        cnt_drop++;
+        return;
+    }
+
+    iovecs[(first + queued) % VITA_TX_BATCH].iov_len = len;
+    queued++;
+
+    if (queued >= VITA_TX_BATCH) {
+        flush();
+    }
+
+    return;
+}
+
+/**
+ * Sends the queued packets
+ *
+ * @return int - number of packets sent
+ */
+int vita_tx::flush(void)
+{
+    int ans = 0;
+
+    if (queued == 0) {
+        return 0;
+    }
+
+    // at most two runs around the end of the ring
+    int run = std::min(queued, VITA_TX_BATCH - first);
+    if (!running) {
+        cnt_drop += queued;
+    } else if (udp) {
+        ans = send_udp(first, run);
+        ans += send_udp(0, queued - run);
+    } else {
+        ans = send_tcp(first, run);
+        ans += send_tcp(0, queued - run);
+    }
+    first = (first + queued) % VITA_TX_BATCH;
+    queued = 0;
+
+    return ans;
+}
+
+/**
+ * Sets up the socket and connects it to the destination
+ *
+ * @return int - 0 on fail, 1 on success
+ */
+int vita_tx::setup_socket(void)
+{
+    int ans = 0;
+    int opt = 1;
+    struct addrinfo hints;
+    struct addrinfo* res = NULL;
+    char service[16];
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = udp ? SOCK_DGRAM : SOCK_STREAM;
+    snprintf(service, sizeof(service), "%d", port);
+    if (getaddrinfo(host.c_str(), service, &hints, &res) != 0 || res == NULL) {
+        fprintf(stderr, "vita_tx unable to resolve %s\n", host.c_str());
+        return 0;
+    }
+
+    sockFd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, 0);
+    if (sockFd != -1) {
+        if (sndBuf > 0) {
+            if (setsockopt(sockFd, SOL_SOCKET, SO_SNDBUF, &sndBuf, sizeof(sndBuf)) < 0) {
+                perror("Error setting send buffer size");
+            }
+        }
+
+        if (udp) {
+            // connected, so sendmmsg needs no addresses
+            if (connect(sockFd, res->ai_addr, res->ai_addrlen) == 0) {
+                ans = 1;
+            } else {
+                perror("vita_tx connect");
+            }
+        } else {
+            // connect without blocking the caller for long
+            struct pollfd pfd;
+            int err = 0;
+            socklen_t errlen = sizeof(err);
+            int flags = fcntl(sockFd, F_GETFL, 0);
+
+            fcntl(sockFd, F_SETFL, flags | O_NONBLOCK);
+            if (connect(sockFd, res->ai_addr, res->ai_addrlen) == 0) {
+                ans = 1;
+            } else if (errno == EINPROGRESS) {
+                pfd.fd = sockFd;
+                pfd.events = POLLOUT;
+                if (poll(&pfd, 1, VITA_TX_CONNECT_MS) == 1 &&
+                    getsockopt(sockFd, SOL_SOCKET, SO_ERROR, &err, &errlen) == 0 &&
+                    err == 0) {
+                    ans = 1;
+                }
+            }
+            fcntl(sockFd, F_SETFL, flags);
+
+            if (ans) {
+                if (setsockopt(sockFd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) !=
+                    0) {
+                    perror("setsockopt");
+                }
+                printf("vita_tx connected to %s:%d\n", host.c_str(), port);
+            }
+        }
+    } else {
+        perror("Socket Error");
+    }
+
+    freeaddrinfo(res);
+    if (!ans) {
+        close_socket();
+    }
+
+    return ans;
+} // end setup_socket
+
+/**
+ * Closes the socket
+ */
+void vita_tx::close_socket(void)
+{
+    if (sockFd != -1) {
+        close(sockFd);
+        sockFd = -1;
+    }
+
+    return;
+}
+
+/**
+ * Sends a run of queued packets over UDP
+ *
+ * @param start - first slot
+ * @param count - number of slots
+ * @return int - number of packets sent
+ */
+int vita_tx::send_udp(int start, int count)
+{
+    int sent = 0;
+    int n, i;
+
+    while (sent < count) {
+        n = sendmmsg(sockFd, msgs + start + sent, count - sent, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // ICMP errors of a connected socket (no listener) fail one
+            // datagram, the rest are still sent
+            cnt_drop++;
+            sent++;
+            continue;
+        }
+
+        for (i = start + sent; i < start + sent + n; i++) {
+            cnt_tx_byte += iovecs[i].iov_len;
+        }
+        cnt_tx_pkt += n;
+        sent += n;
+    }
+
+    return sent;
+} // end send_udp
+
+/**
+ * Sends a run of queued packets over TCP, reconnecting if needed
+ *
+ * @param start - first slot
+ * @param count - number of slots
+ * @return int - number of packets sent
+ */
+int vita_tx::send_tcp(int start, int count)
+{
+    struct iovec iov[VITA_TX_BATCH];
+    struct msghdr msg;
+    size_t total = 0;
+    int done = 0;
+    ssize_t n;
+    int i;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (sockFd == -1) {
+        double now = monotonic_seconds();
+        if (now - lastConnect < 1.0) {
+            cnt_drop += count;
+            return 0;
+        }
+        lastConnect = now;
+        if (!setup_socket()) {
+            cnt_drop += count;
+            return 0;
+        }
+    }
+
+    // one gathered write of the whole run, continued on partial writes
+    for (i = 0; i < count; i++) {
+        iov[i] = iovecs[start + i];
+        total += iov[i].iov_len;
+    }
+    memset(&msg, 0, sizeof(msg));
+
+    while (total > 0) {
+        msg.msg_iov = iov + done;
+        msg.msg_iovlen = count - done;
+        n = sendmsg(sockFd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("vita_tx send");
+            close_socket();
+            break;
+        }
+
+        total -= n;
+        while (n > 0 && done < count) {
+            if ((size_t)n >= iov[done].iov_len) {
+                n -= iov[done].iov_len;
+                iov[done].iov_len = 0;
+                done++;
+            } else {
+                iov[done].iov_base = (uint8_t*)iov[done].iov_base + n;
+                iov[done].iov_len -= n;
+                n = 0;
+            }
+        }
+    }
+
+    // packets not fully written are lost with the connection
+    for (i = 0; i < done; i++) {
+        cnt_tx_byte += iovecs[start + i].iov_len;
+    }
+    cnt_tx_pkt += done;
+    cnt_drop += count - done;
+
+    return done;
+} // end send_tcp
+
+} /* namespace sandia_utils */
+} /* namespace gr */
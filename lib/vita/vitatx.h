@@ -0,0 +1,173 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIB_VITA_VITATX_H_
+#define LIB_VITA_VITATX_H_
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/sandia_utils/api.h>
+
+// packets sent per sendmmsg call
+#define VITA_TX_BATCH 64
+
+namespace gr {
+namespace sandia_utils {
+
+/**
+ * VITA 49 UDP / TCP transmitter
+ *
+ * Packets are packed in place into a preallocated ring of packet buffers
+ * and sent a batch at a time, with sendmmsg for UDP or one gathered write
+ * for TCP. Each UDP datagram carries one packet. Sending is done in the
+ * caller's thread. A buffer taken with getBuffer() stays valid across
+ * flush() until it is committed, so a packet can be filled over several
+ * calls.
+ */
+class SANDIA_UTILS_API vita_tx
+{
+private:
+    std::string host;
+    int port;
+    bool udp;
+    int sndBuf;
+    size_t maxPacket;
+
+    int sockFd;
+    bool running;
+
+    // last TCP connect attempt, reconnects are rate limited
+    double lastConnect;
+
+    // packet ring, one buffer, iovec and header per batch slot. Queued
+    // packets are the queued slots from first, wrapping
+    std::vector<uint8_t> txBuf;
+    struct iovec iovecs[VITA_TX_BATCH];
+    struct mmsghdr msgs[VITA_TX_BATCH];
+    int first;
+    int queued;
+
+    uint64_t cnt_tx_pkt;
+    uint64_t cnt_tx_byte;
+    uint64_t cnt_drop;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param _host - destination host name or address
+     * @param _port - destination port
+     * @param _udp - true for UDP, false for TCP
+     * @param _maxPacket - largest packet in bytes
+     * @param _sndbuf - socket send buffer size in bytes, 0 for the system
+     * default
+     */
+    vita_tx(const std::string& _host,
+            int _port,
+            bool _udp,
+            size_t _maxPacket = 65536,
+            int _sndbuf = 0);
+    virtual ~vita_tx();
+
+    /**
+     * Start transmitter. A TCP transmitter that can not connect keeps
+     * retrying, once a second, as packets are sent.
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int start(void);
+
+    /**
+     * Stop transmitter, sending any queued packets first
+     *
+     * @return int - 0 on error, 1 on success
+     */
+    int stop(void);
+
+    /**
+     * Returns the buffer of the next packet to send
+     *
+     * @return uint8_t* - buffer of getMaxPacket() bytes
+     */
+    uint8_t* getBuffer(void);
+
+    /**
+     * Queues the packet packed into the buffer from getBuffer(), sending
+     * the batch once it is full
+     *
+     * @param len - packet size in bytes
+     */
+    void commit(size_t len);
+
+    /**
+     * Sends the queued packets
+     *
+     * @return int - number of packets sent
+     */
+    int flush(void);
+
+    /**
+     * Returns the number of packets queued and not yet sent
+     *
+     * @return int - queued packets
+     */
+    int getQueued(void) const { return queued; }
+
+    size_t getMaxPacket(void) const { return maxPacket; }
+    uint64_t get_packet_count(void) const { return cnt_tx_pkt; }
+    uint64_t get_byte_count(void) const { return cnt_tx_byte; }
+
+    /**
+     * Returns the number of packets that could not be sent
+     *
+     * @return uint64_t - dropped packets
+     */
+    uint64_t get_drop_count(void) const { return cnt_drop; }
+
+private:
+    /**
+     * Sets up the socket and connects it to the destination
+     *
+     * @return int - 0 on fail, 1 on success
+     */
+    int setup_socket(void);
+
+    /**
+     * Closes the socket
+     */
+    void close_socket(void);
+
+    /**
+     * Sends a run of queued packets over UDP
+     *
+     * @param start - first slot
+     * @param count - number of slots
+     * @return int - number of packets sent
+     */
+    int send_udp(int start, int count);
+
+    /**
+     * Sends a run of queued packets over TCP, reconnecting if needed
+     *
+     * @param start - first slot
+     * @param count - number of slots
+     * @return int - number of packets sent
+     */
+    int send_tcp(int start, int count);
+
+}; // end class vita_tx
+
+} /* namespace sandia_utils */
+} /* namespace gr */
+
+#endif /* LIB_VITA_VITATX_H_ */
@@ -0,0 +1,373 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vita49_payload.h"
+#include <volk/volk.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    vita49_payload::vita49_payload( format fmt ) : d_format( fmt )
+    {
+    }
+
+    vita49_payload::vita49_payload( const std::string &fmt )
+    {
+      if( fmt == "sc16" )
+      {
+        d_format = SC16;
+      }
+      else if( fmt == "sc8" )
+      {
+        d_format = SC8;
+      }
+      else if( fmt == "sc12" )
+      {
+        d_format = SC12;
+      }
+      else if( fmt == "fc32" )
+      {
+        d_format = FC32;
+      }
+      else
+      {
+        throw std::invalid_argument(
+          str( boost::format( "Unknown VITA 49 payload format %s" ) % fmt ) );
+      }
+    }
+
+    size_t vita49_payload::sample_bytes() const
+    {
+      switch( d_format )
+      {
+        case SC8:
+          return 2;
+        case SC12:
+          return 3;
+        case FC32:
+          return 8;
+        case SC16:
+        default:
+          return 4;
+      }
+    }
+
+    namespace
+    {
+      // big endian loads and stores. 32 bit words are built from 16 bit
+      // halves, a plain byte reversal would be turned into a bswap that
+      // SSE2 cannot vectorize
+      inline uint16_t load16( const uint8_t *p )
+      {
+        return (uint16_t)( ( p[0] << 8 ) | p[1] );
+      }
+
+      inline void store16( uint8_t *p, uint16_t v )
+      {
+        p[0] = v >> 8;
+        p[1] = v & 0xff;
+      }
+
+      inline void store_float( uint8_t *p, float f )
+      {
+        uint32_t w;
+        memcpy( &w, &f, sizeof( w ) );
+        store16( p, w >> 16 );
+        store16( p + 2, w & 0xffff );
+      }
+
+      // rounds to nearest even and saturates like volk_32f_s32f_convert_16i.
+      // Adding and removing 1.5 * 2^23 rounds without a libm call, rounding
+      // before clipping keeps the loops branch free
+      inline int16_t round_clip( float v, float lo, float hi )
+      {
+        v = v + 12582912.0f - 12582912.0f;
+        return (int16_t)(int32_t)std::min( std::max( v, lo ), hi );
+      }
+
+      inline int16_t clip( int16_t v, int16_t lo, int16_t hi )
+      {
+        return std::min( std::max( v, lo ), hi );
+      }
+
+      // the low 12 bits of v as a signed value
+      inline int16_t sign_extend12( uint32_t v )
+      {
+        return (int16_t)( v << 4 ) >> 4;
+      }
+
+      /*
+       * Conversion kernels, one pass each. Payload words are byte swapped
+       * as they are read or written. The restrict pointers tell the
+       * compiler the payload and samples do not overlap so the loops
+       * vectorize without a runtime check.
+       */
+      void be16_to_sc16( const uint8_t *__restrict in, int16_t *__restrict out, size_t n )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          out[i] = (int16_t)load16( in + 2 * i );
+        }
+      }
+
+      void be16_to_fc32( const uint8_t *__restrict in, float *__restrict out, size_t n,
+          float r )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          out[i] = (int16_t)load16( in + 2 * i ) * r;
+        }
+      }
+
+      void sc16_to_be16( const int16_t *__restrict in, uint8_t *__restrict out, size_t n )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          store16( out + 2 * i, (uint16_t)in[i] );
+        }
+      }
+
+      void fc32_to_be16( const float *__restrict in, uint8_t *__restrict out, size_t n,
+          float scale )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          store16( out + 2 * i, (uint16_t)round_clip( in[i] * scale, -32768.0f, 32767.0f ) );
+        }
+      }
+
+      // float payloads are copied with the bytes of each word reversed
+      void swap32( const uint8_t *__restrict in, uint8_t *__restrict out, size_t n )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          out[4 * i] = in[4 * i + 3];
+          out[4 * i + 1] = in[4 * i + 2];
+          out[4 * i + 2] = in[4 * i + 1];
+          out[4 * i + 3] = in[4 * i];
+        }
+      }
+
+      void be32_to_sc16( const uint8_t *__restrict in, int16_t *__restrict out, size_t n,
+          float scale )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          uint32_t w = ( (uint32_t)load16( in + 4 * i ) << 16 ) | load16( in + 4 * i + 2 );
+          float f;
+          memcpy( &f, &w, sizeof( f ) );
+          out[i] = round_clip( f * scale, -32768.0f, 32767.0f );
+        }
+      }
+
+      void sc16_to_be32( const int16_t *__restrict in, uint8_t *__restrict out, size_t n,
+          float r )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          store_float( out + 4 * i, in[i] * r );
+        }
+      }
+
+      void sc8_to_sc16( const uint8_t *__restrict in, int16_t *__restrict out, size_t n )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          out[i] = (int8_t)in[i];
+        }
+      }
+
+      void sc16_to_sc8( const int16_t *__restrict in, uint8_t *__restrict out, size_t n )
+      {
+        for( size_t i = 0; i < n; i++ )
+        {
+          out[i] = (uint8_t)clip( in[i], -128, 127 );
+        }
+      }
+
+      /**
+       * Unpacks 12 bit samples, IIIIIIII IIIIQQQQ QQQQQQQQ. Pairs of samples
+       * are read as three 16 bit words so the loop vectorizes.
+       */
+      void unpack12( const uint8_t *__restrict in, int16_t *__restrict out, size_t nsamples )
+      {
+        size_t npairs = nsamples / 2;
+        for( size_t i = 0; i < npairs; i++ )
+        {
+          uint16_t w0 = load16( in + 6 * i );
+          uint16_t w1 = load16( in + 6 * i + 2 );
+          uint16_t w2 = load16( in + 6 * i + 4 );
+          out[4 * i] = sign_extend12( w0 >> 4 );
+          out[4 * i + 1] = sign_extend12( ( w0 << 8 ) | ( w1 >> 8 ) );
+          out[4 * i + 2] = sign_extend12( ( w1 << 4 ) | ( w2 >> 12 ) );
+          out[4 * i + 3] = sign_extend12( w2 );
+        }
+        if( nsamples & 1 )
+        {
+          const uint8_t *p = in + 6 * npairs;
+          uint32_t w = ( (uint32_t)load16( p ) << 8 ) | p[2];
+          out[4 * npairs] = sign_extend12( w >> 12 );
+          out[4 * npairs + 1] = sign_extend12( w );
+        }
+      }
+
+      /**
+       * Packs 16 bit samples to 12 bits, clipping. Pairs of samples are
+       * written as three 16 bit words.
+       */
+      void pack12( const int16_t *__restrict in, uint8_t *__restrict out, size_t nsamples )
+      {
+        size_t npairs = nsamples / 2;
+        for( size_t i = 0; i < npairs; i++ )
+        {
+          uint16_t v0 = (uint16_t)clip( in[4 * i], -2048, 2047 ) & 0xfff;
+          uint16_t v1 = (uint16_t)clip( in[4 * i + 1], -2048, 2047 ) & 0xfff;
+          uint16_t v2 = (uint16_t)clip( in[4 * i + 2], -2048, 2047 ) & 0xfff;
+          uint16_t v3 = (uint16_t)clip( in[4 * i + 3], -2048, 2047 ) & 0xfff;
+          store16( out + 6 * i, ( v0 << 4 ) | ( v1 >> 8 ) );
+          store16( out + 6 * i + 2, ( v1 << 8 ) | ( v2 >> 4 ) );
+          store16( out + 6 * i + 4, ( v2 << 12 ) | v3 );
+        }
+        if( nsamples & 1 )
+        {
+          uint16_t re = (uint16_t)clip( in[4 * npairs], -2048, 2047 ) & 0xfff;
+          uint16_t im = (uint16_t)clip( in[4 * npairs + 1], -2048, 2047 ) & 0xfff;
+          uint8_t *p = out + 6 * npairs;
+          store16( p, ( re << 4 ) | ( im >> 8 ) );
+          p[2] = im & 0xff;
+        }
+      }
+
+      // 12 bit samples to and from float go through 16 bit values in blocks
+      // that stay in L1, the packing does not vectorize with a float side
+      const size_t SC12_BLOCK = 512;
+
+      void sc12_to_fc32( const uint8_t *in, float *out, size_t nsamples, float r )
+      {
+        int16_t block[2 * SC12_BLOCK];
+        for( size_t i = 0; i < nsamples; i += SC12_BLOCK )
+        {
+          size_t n = std::min( SC12_BLOCK, nsamples - i );
+          unpack12( in + 3 * i, block, n );
+          for( size_t k = 0; k < 2 * n; k++ )
+          {
+            out[2 * i + k] = block[k] * r;
+          }
+        }
+      }
+
+      void fc32_to_sc12( const float *in, uint8_t *out, size_t nsamples, float scale )
+      {
+        int16_t block[2 * SC12_BLOCK];
+        for( size_t i = 0; i < nsamples; i += SC12_BLOCK )
+        {
+          size_t n = std::min( SC12_BLOCK, nsamples - i );
+          for( size_t k = 0; k < 2 * n; k++ )
+          {
+            block[k] = round_clip( in[2 * i + k] * scale, -2048.0f, 2047.0f );
+          }
+          pack12( block, out + 3 * i, n );
+        }
+      }
+    } // namespace
+
+    void vita49_payload::to_sc16( const uint8_t *in, int16_t *out, size_t nsamples,
+        float scale )
+    {
+      switch( d_format )
+      {
+        case SC16:
+          be16_to_sc16( in, out, 2 * nsamples );
+          break;
+        case SC8:
+          sc8_to_sc16( in, out, 2 * nsamples );
+          break;
+        case SC12:
+          unpack12( in, out, nsamples );
+          break;
+        case FC32:
+          be32_to_sc16( in, out, 2 * nsamples, scale );
+          break;
+      }
+    } //end to_sc16
+
+    void vita49_payload::to_fc32( const uint8_t *in, gr_complex *out, size_t nsamples,
+        float scale )
+    {
+      float r = 1.0f / scale;
+      switch( d_format )
+      {
+        case SC8:
+          volk_8i_s32f_convert_32f( (float *)out, (const int8_t *)in, scale, 2 * nsamples );
+          break;
+        case FC32:
+          swap32( in, (uint8_t *)out, 2 * nsamples );
+          break;
+        case SC12:
+          sc12_to_fc32( in, (float *)out, nsamples, r );
+          break;
+        case SC16:
+        default:
+          be16_to_fc32( in, (float *)out, 2 * nsamples, r );
+          break;
+      }
+    } //end to_fc32
+
+    void vita49_payload::from_sc16( const int16_t *in, uint8_t *out, size_t nsamples,
+        float scale )
+    {
+      switch( d_format )
+      {
+        case SC16:
+          sc16_to_be16( in, out, 2 * nsamples );
+          break;
+        case SC8:
+          sc16_to_sc8( in, out, 2 * nsamples );
+          break;
+        case SC12:
+          pack12( in, out, nsamples );
+          break;
+        case FC32:
+          sc16_to_be32( in, out, 2 * nsamples, 1.0f / scale );
+          break;
+      }
+    } //end from_sc16
+
+    void vita49_payload::from_fc32( const gr_complex *in, uint8_t *out, size_t nsamples,
+        float scale )
+    {
+      switch( d_format )
+      {
+        case SC8:
+          volk_32f_s32f_convert_8i( (int8_t *)out, (const float *)in, scale, 2 * nsamples );
+          break;
+        case FC32:
+          swap32( (const uint8_t *)in, out, 2 * nsamples );
+          break;
+        case SC16:
+          fc32_to_be16( (const float *)in, out, 2 * nsamples, scale );
+          break;
+        case SC12:
+        default:
+          fc32_to_sc12( (const float *)in, out, nsamples, scale );
+          break;
+      }
+    } //end from_fc32
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
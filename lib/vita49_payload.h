@@ -0,0 +1,141 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_PAYLOAD_H
+#define INCLUDED_SANDIA_UTILS_VITA49_PAYLOAD_H
+
+#include <gnuradio/gr_complex.h>
+#include <stdint.h>
+#include <string>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * Converts VRT Signal Data payloads to and from host sample formats.
+     *
+     * Payloads are complex samples in network byte order, I first:
+     *   sc16 - 16 bit I and Q, one sample per word
+     *   sc8  - 8 bit I and Q, two samples per word
+     *   sc12 - 12 bit I and Q packed into 3 bytes, samples span words
+     *   fc32 - IEEE float I and Q, one sample per two words
+     * Each conversion is one pass that byte swaps as it converts, written so
+     * the compiler vectorizes it; sc8 to and from float uses VOLK.
+     */
+    class vita49_payload
+    {
+      public:
+        enum format
+        {
+          SC16,
+          SC8,
+          SC12,
+          FC32
+        };
+
+        /**
+         * Constructor
+         *
+         * @param fmt - payload format
+         */
+        vita49_payload( format fmt );
+
+        /**
+         * Constructor
+         *
+         * @param fmt - payload format name, one of sc16, sc8, sc12, fc32.
+         *              Throws on an unknown name
+         */
+        vita49_payload( const std::string &fmt );
+
+        /**
+         * Returns the payload format
+         *
+         * @return format - payload format
+         */
+        format get_format() const
+        {
+          return d_format;
+        }
+
+        /**
+         * Returns the payload bytes per complex sample
+         *
+         * @return size_t - bytes per sample
+         */
+        size_t sample_bytes() const;
+
+        /**
+         * Returns the number of whole samples in a payload
+         *
+         * @param nbytes - payload size in bytes
+         * @return size_t - number of samples
+         */
+        size_t nsamples( size_t nbytes ) const
+        {
+          return nbytes / sample_bytes();
+        }
+
+        /**
+         * Converts samples to interleaved 16 bit I/Q. Integer payloads keep
+         * their values, sc8 and sc12 are sign extended. Float payloads are
+         * multiplied by \p scale.
+         *
+         * @param in - payload, network byte order
+         * @param out - 2 * \p nsamples shorts
+         * @param nsamples - number of complex samples
+         * @param scale - full scale value of float payloads
+         */
+        void to_sc16( const uint8_t *in, int16_t *out, size_t nsamples, float scale = 32768.0 );
+
+        /**
+         * Converts samples to complex float. Integer payloads are divided
+         * by \p scale, float payloads are passed through.
+         *
+         * @param in - payload, network byte order
+         * @param out - \p nsamples complex floats
+         * @param nsamples - number of complex samples
+         * @param scale - full scale value of integer payloads
+         */
+        void to_fc32( const uint8_t *in, gr_complex *out, size_t nsamples, float scale );
+
+        /**
+         * Converts interleaved 16 bit I/Q to the payload format. Values out
+         * of range of sc8 and sc12 are clipped. Float payloads are divided
+         * by \p scale.
+         *
+         * @param in - 2 * \p nsamples shorts
+         * @param out - payload, network byte order
+         * @param nsamples - number of complex samples
+         * @param scale - full scale value of float payloads
+         */
+        void from_sc16( const int16_t *in, uint8_t *out, size_t nsamples,
+            float scale = 32768.0 );
+
+        /**
+         * Converts complex float to the payload format. Integer payloads are
+         * multiplied by \p scale and clipped, float payloads are passed
+         * through.
+         *
+         * @param in - \p nsamples complex floats
+         * @param out - payload, network byte order
+         * @param nsamples - number of complex samples
+         * @param scale - full scale value of integer payloads
+         */
+        void from_fc32( const gr_complex *in, uint8_t *out, size_t nsamples, float scale );
+
+      private:
+        format d_format;
+    }; // end class vita49_payload
+
+  } // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_PAYLOAD_H */
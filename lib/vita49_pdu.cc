@@ -0,0 +1,171 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vita49_pdu.h"
+#include "vita49_payload.h"
+#include "vita/vitatime.h"
+#include <gnuradio/sandia_utils/constants.h>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * Converts a VRT Signal Data packet to a PDU of interleaved s16 IQ
+     *
+     * @param pkt - the packet to convert
+     * @param ignore_time - true to leave the VITA time stamp out of the metadata
+     * @return pmt_t - PDU, or PMT_NIL if the packet has no payload
+     */
+    pmt::pmt_t vita49_data_pdu( VRTPacket *pkt, bool ignore_time )
+    {
+      pmt::pmt_t metadata;
+      pmt::pmt_t data_vec;
+
+      //VRT packet payload is 32bit word oriented. Each 32bit word is a single sample
+      //  16bit for I and 16bit for Q. Thus vector size of int16_t is 2x payload side
+      size_t nwords = pkt->getPayloadWords();
+      if( nwords == 0 )
+      {
+        return pmt::PMT_NIL;
+      }
+
+      size_t len;
+      data_vec = pmt::make_s16vector( 2 * nwords, 0 );
+      int16_t *dt = pmt::s16vector_writable_elements( data_vec, len );
+
+      if( pkt->getPayloadData() )
+      {
+        // decoded from a receive buffer, convert straight from network order
+        vita49_payload conv( vita49_payload::SC16 );
+        conv.to_sc16( pkt->getPayloadData(), dt, nwords );
+      }
+      else
+      {
+        for( size_t i = 0; i < nwords; i++ )
+        {
+          uint32_t raw = pkt->getPayload()->at( i );
+          dt[2 * i] = ( raw >> 16 ) & 0x0000ffff;
+          dt[2 * i + 1] = raw & 0x0000ffff;
+        }
+      }
+
+      metadata = pmt::make_dict();
+
+      // receive time of the first sample, the fraction taken from the
+      // integer picoseconds rather than accumulated in floating point
+      if( !ignore_time )
+      {
+        vita_time t( pkt->getTsEpoch(), pkt->getTsFrac() );
+        pmt::pmt_t time_tag = pmt::make_tuple(pmt::from_uint64( t.sec ), pmt::from_double( t.frac() ));
+        metadata = pmt::dict_add(metadata, PMTCONSTSTR__rx_time(), time_tag);
+      }
+
+      // kernel receive time, when the transport provides one
+      if( pkt->getHostTimeNs() != 0 )
+      {
+        uint64_t ns = pkt->getHostTimeNs();
+        pmt::pmt_t host_time = pmt::make_tuple(pmt::from_uint64( ns / 1000000000ULL ),
+            pmt::from_double( (ns % 1000000000ULL) * 1e-9 ));
+        metadata = pmt::dict_add(metadata, PMTCONSTSTR__host_time(), host_time);
+      }
+
+      return pmt::cons(metadata, data_vec);
+    } //end vita49_data_pdu
+
+    /**
+     * Converts a VRT Context packet to a tune command PDU
+     *
+     * @param pkt - the packet to convert
+     * @param ignore_time - true to leave the VITA time stamp out of the metadata
+     * @return pmt_t - tune PDU
+     */
+    pmt::pmt_t vita49_context_pdu( ContextPacket *pkt, bool ignore_time )
+    {
+      pmt::pmt_t metadata = pmt::make_dict();
+      pmt::pmt_t data_vec = pmt::make_s16vector(1, 0);
+
+      if( !ignore_time )
+      {
+        vita_time t( pkt->getTsEpoch(), pkt->getTsFrac() );
+        pmt::pmt_t time_tag = pmt::make_tuple(pmt::from_uint64( t.sec ), pmt::from_double( t.frac() ));
+        metadata = pmt::dict_add(metadata, PMTCONSTSTR__time(), time_tag);
+        metadata = pmt::dict_add(metadata, PMTCONSTSTR__direction(), PMTCONSTSTR__TX());
+      }
+
+      for( CifValue *cf : *pkt->getValues() )
+      {
+        switch( cf->getId() )
+        {
+          case (29):
+          {
+            //bandwidth
+            metadata = pmt::dict_add(
+                metadata, PMTCONSTSTR__bandwidth(), pmt::from_double(cf->getValue()));
+            break;
+          }
+          case (28):
+          {
+            //IF Ref
+            break;
+          }
+          case (27):
+          {
+            //RF Ref
+            metadata = pmt::dict_add(
+                metadata, PMTCONSTSTR__lo_freq(), pmt::from_double(cf->getValue()));
+            break;
+          }
+          case (21):
+          {
+            //Sample Rate
+            metadata = pmt::dict_add(
+                metadata, PMTCONSTSTR__rate(), pmt::from_double(cf->getValue()));
+            break;
+          }
+
+        } //end switch
+
+      } //end for( cf
+
+      return pmt::cons(metadata, data_vec);
+    } //end vita49_context_pdu
+
+    pmt::pmt_t vita49_stats_msg( const std::vector<vita_stream_stats> &stats, uint64_t resyncs )
+    {
+      pmt::pmt_t streams = pmt::make_dict();
+      for( const vita_stream_stats &st : stats )
+      {
+        pmt::pmt_t d = pmt::make_dict();
+        d = pmt::dict_add( d, PMTCONSTSTR__packets(), pmt::from_uint64( st.packets ) );
+        d = pmt::dict_add( d, PMTCONSTSTR__bytes(), pmt::from_uint64( st.bytes ) );
+        d = pmt::dict_add( d, PMTCONSTSTR__packet_rate(), pmt::from_double( st.packet_rate ) );
+        d = pmt::dict_add( d, PMTCONSTSTR__byte_rate(), pmt::from_double( st.byte_rate ) );
+        d = pmt::dict_add( d, PMTCONSTSTR__seq_gaps(), pmt::from_uint64( st.seq_gaps ) );
+        d = pmt::dict_add( d, PMTCONSTSTR__time_discontinuities(),
+            pmt::from_uint64( st.ts_discont ) );
+        // seconds spent in listener callbacks
+        d = pmt::dict_add( d, PMTCONSTSTR__callback_time(),
+            pmt::from_double( st.callback_ns * 1e-9 ) );
+        streams = pmt::dict_add( streams, pmt::from_uint64( st.stream_id ), d );
+      }
+
+      pmt::pmt_t msg = pmt::make_dict();
+      msg = pmt::dict_add( msg, PMTCONSTSTR__resyncs(), pmt::from_uint64( resyncs ) );
+      msg = pmt::dict_add( msg, PMTCONSTSTR__streams(), streams );
+
+      return msg;
+    } //end vita49_stats_msg
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
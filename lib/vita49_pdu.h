@@ -0,0 +1,236 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_PDU_H
+#define INCLUDED_SANDIA_UTILS_VITA49_PDU_H
+
+#include <gnuradio/block.h>
+#include <pmt/pmt.h>
+
+#include "vita/ContextPacket.h"
+#include "vita/VRTPacket.h"
+#include "vita/vitarxbase.h"
+#include "vita/vitastats.h"
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+    /**
+     * Converts a VRT Signal Data packet to a PDU of interleaved s16 IQ.
+     * Shared by the VITA 49 message sources.
+     *
+     * @param pkt - the packet to convert
+     * @param ignore_time - true to leave the VITA time stamp out of the metadata
+     * @return pmt_t - PDU, or PMT_NIL if the packet has no payload
+     */
+    pmt::pmt_t vita49_data_pdu( VRTPacket *pkt, bool ignore_time );
+
+    /**
+     * Converts a VRT Context packet to a tune command PDU
+     *
+     * @param pkt - the packet to convert
+     * @param ignore_time - true to leave the VITA time stamp out of the metadata
+     * @return pmt_t - tune PDU
+     */
+    pmt::pmt_t vita49_context_pdu( ContextPacket *pkt, bool ignore_time );
+
+    /**
+     * Converts receiver statistics to a stats message, a dictionary with the
+     * resync count and a dictionary of per stream statistics keyed by
+     * stream ID
+     *
+     * @param stats - statistics of every stream ID seen
+     * @param resyncs - number of times the receiver lost packet alignment
+     * @return pmt_t - stats dictionary
+     */
+    pmt::pmt_t vita49_stats_msg( const std::vector<vita_stream_stats> &stats, uint64_t resyncs );
+
+    /**
+     * Receiver statistics shared by the VITA 49 sources. Implements the
+     * statistics getters of the public block class \p Block from the
+     * receiver of the source and registers them with ControlPort.
+     */
+    template<typename Block>
+    class vita49_rx_stats : public Block
+    {
+      protected:
+        /**
+         * Returns the receiver the statistics are read from
+         *
+         * @return vita_rx_base* - receiver
+         */
+        virtual vita_rx_base *receiver() = 0;
+
+        /**
+         * Registers the publisher queue getters with ControlPort, for blocks
+         * that have getQueueDepth() and getQueueDrops()
+         */
+        void setup_queue_rpc();
+
+      public:
+        virtual void setStatsPeriod( double seconds )
+        {
+          receiver()->set_stats_period( seconds );
+        }
+
+        virtual pmt::pmt_t getStats( void )
+        {
+          return vita49_stats_msg( receiver()->get_stats(), receiver()->get_resync_count() );
+        }
+
+        virtual uint64_t getPacketCount( void )
+        {
+          return receiver()->get_totals().packets;
+        }
+
+        virtual uint64_t getByteCount( void )
+        {
+          return receiver()->get_byte_count();
+        }
+
+        virtual uint64_t getSeqGaps( void )
+        {
+          return receiver()->get_totals().seq_gaps;
+        }
+
+        virtual uint64_t getResyncCount( void )
+        {
+          return receiver()->get_resync_count();
+        }
+
+        virtual uint64_t getTimeDiscontinuities( void )
+        {
+          return receiver()->get_totals().ts_discont;
+        }
+
+        virtual double getCallbackTime( void )
+        {
+          return receiver()->get_totals().callback_ns * 1e-9;
+        }
+
+        /**
+         * Registers the packet, byte, sequence gap, resync, time
+         * discontinuity and callback time getters with ControlPort
+         */
+        virtual void setup_rpc();
+    }; // end class vita49_rx_stats
+
+    template<typename Block>
+    void vita49_rx_stats<Block>::setup_rpc()
+    {
+#ifdef GR_CTRLPORT
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "packets",
+                                                   &Block::getPacketCount,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "packets",
+                                                   "Packets received",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "bytes",
+                                                   &Block::getByteCount,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "bytes",
+                                                   "Bytes received",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "seq gaps",
+                                                   &Block::getSeqGaps,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "packets",
+                                                   "Packets missing from the packet count",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "resyncs",
+                                                   &Block::getResyncCount,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "",
+                                                   "Resyncs on bad headers",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "time discontinuities",
+                                                   &Block::getTimeDiscontinuities,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "",
+                                                   "Timestamp discontinuities",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, double>(this->alias(),
+                                                 "callback time",
+                                                 &Block::getCallbackTime,
+                                                 pmt::from_double(0.0),
+                                                 pmt::from_double(1e12),
+                                                 pmt::from_double(0.0),
+                                                 "s",
+                                                 "Time spent handling packets",
+                                                 RPC_PRIVLVL_MIN,
+                                                 DISPTIME | DISPOPTSTRIP)));
+#endif /* GR_CTRLPORT */
+    }
+
+    template<typename Block>
+    void vita49_rx_stats<Block>::setup_queue_rpc()
+    {
+#ifdef GR_CTRLPORT
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "queue depth",
+                                                   &Block::getQueueDepth,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "packets",
+                                                   "Packets waiting to be published",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+
+      this->add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<Block, uint64_t>(this->alias(),
+                                                   "queue drops",
+                                                   &Block::getQueueDrops,
+                                                   pmt::from_uint64(0),
+                                                   pmt::from_uint64(UINT64_MAX),
+                                                   pmt::from_uint64(0),
+                                                   "packets",
+                                                   "Packets dropped on a full queue",
+                                                   RPC_PRIVLVL_MIN,
+                                                   DISPTIME | DISPOPTSTRIP)));
+#endif /* GR_CTRLPORT */
+    }
+
+  } // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_PDU_H */
@@ -0,0 +1,412 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vita49_sink_impl.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sandia_utils/constants.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// prologue of a data packet: header, stream ID, UTC and real time stamps
+#define VITA_SINK_PROLOGUE_WORDS 7
+
+// largest UDP payload over IPv4
+#define VITA_SINK_MAX_DATAGRAM 65507
+
+namespace gr {
+namespace sandia_utils {
+
+vita49_sink::sptr vita49_sink::make(const std::string& host,
+                                    int port,
+                                    const std::string& transport,
+                                    const std::string& type,
+                                    const std::string& payload,
+                                    int samples_per_packet,
+                                    uint32_t stream_id,
+                                    double scale)
+{
+    return gnuradio::get_initial_sptr(new vita49_sink_impl(
+        host, port, transport, type, payload, samples_per_packet, stream_id, scale));
+}
+
+namespace {
+size_t input_itemsize(const std::string& type)
+{
+    if (type == "sc16") {
+        return 2 * sizeof(int16_t);
+    } else if (type == "fc32") {
+        return sizeof(gr_complex);
+    }
+    throw std::invalid_argument(
+        str(boost::format("vita49_sink: unknown input type %s") % type));
+}
+} // namespace
+
+/*
+ * The private constructor
+ */
+vita49_sink_impl::vita49_sink_impl(const std::string& host,
+                                   int port,
+                                   const std::string& transport,
+                                   const std::string& type,
+                                   const std::string& payload,
+                                   int samples_per_packet,
+                                   uint32_t stream_id,
+                                   double scale)
+    : gr::sync_block("vita49_sink",
+                     gr::io_signature::make(1, 1, input_itemsize(type)),
+                     gr::io_signature::make(0, 0, 0)),
+      d_tx(NULL),
+      d_fc32(type == "fc32"),
+      d_scale(scale),
+      d_payload(payload),
+      d_sample_bytes(d_payload.sample_bytes()),
+      d_samples_per_packet(samples_per_packet),
+      d_stream_id(stream_id),
+      d_pkt_buf(NULL),
+      d_pkt_prologue(0),
+      d_pkt_samples(0),
+      d_pkt_offset(0),
+      d_data_count(0),
+      d_ctx_count(0),
+      d_time_valid(false),
+      d_time_sec(0),
+      d_time_frac(0.0),
+      d_time_offset(0),
+      d_rate(0.0),
+      d_freq(-1.0)
+{
+    if (transport != "tcp" && transport != "udp") {
+        throw std::invalid_argument(
+            str(boost::format("vita49_sink: unknown transport %s") % transport));
+    }
+    if (d_scale == 0.0) {
+        d_scale = 1.0;
+    }
+
+    // 4 / gcd(4, sample bytes) samples fill a whole number of words
+    d_align = 1;
+    while ((d_align * d_sample_bytes) % 4) {
+        d_align++;
+    }
+    if (samples_per_packet < 1 || (d_samples_per_packet % d_align)) {
+        throw std::invalid_argument(str(
+            boost::format("vita49_sink: %d samples per packet is not a whole number of "
+                          "%s payload words") %
+            samples_per_packet % payload));
+    }
+
+    size_t max_packet =
+        4 * (VITA_SINK_PROLOGUE_WORDS + (d_samples_per_packet * d_sample_bytes + 3) / 4);
+    if ((transport == "udp" && max_packet > VITA_SINK_MAX_DATAGRAM) ||
+        (max_packet > 4 * 0xffff)) {
+        throw std::invalid_argument(
+            str(boost::format("vita49_sink: %d samples per packet exceeds the largest "
+                              "packet") %
+                samples_per_packet));
+    }
+    // room for a context packet, aligned for the float payload conversions
+    max_packet = (std::max(max_packet, (size_t)64) + 7) & ~(size_t)7;
+
+    d_tx = new vita_tx(host, port, transport == "udp", max_packet);
+
+    // the packet stream carries the tags
+    set_tag_propagation_policy(gr::block::TPP_DONT);
+}
+
+/*
+ * Our virtual destructor.
+ */
+vita49_sink_impl::~vita49_sink_impl()
+{
+    stop();
+    delete d_tx;
+}
+
+bool vita49_sink_impl::start()
+{
+    d_pkt_samples = 0;
+    d_data_count = 0;
+    d_ctx_count = 0;
+    d_time_valid = false;
+    d_rate = 0.0;
+    d_freq = -1.0;
+
+    if (d_tx->start() != 1) {
+        GR_LOG_WARN(d_logger, "Error starting VITA 49 transmitter");
+    }
+
+    return true;
+}
+
+bool vita49_sink_impl::stop()
+{
+    // the end of the stream goes out as a short packet
+    if (d_pkt_samples > 0) {
+        send_packet(d_pkt_samples);
+    }
+    d_tx->stop();
+
+    return true;
+}
+
+uint64_t vita49_sink_impl::getPacketCount(void) { return d_tx->get_packet_count(); }
+
+uint64_t vita49_sink_impl::getByteCount(void) { return d_tx->get_byte_count(); }
+
+uint64_t vita49_sink_impl::getDropCount(void) { return d_tx->get_drop_count(); }
+
+void vita49_sink_impl::setup_rpc()
+{
+#ifdef GR_CTRLPORT
+    add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<vita49_sink, uint64_t>(alias(),
+                                                         "packets",
+                                                         &vita49_sink::getPacketCount,
+                                                         pmt::from_uint64(0),
+                                                         pmt::from_uint64(UINT64_MAX),
+                                                         pmt::from_uint64(0),
+                                                         "packets",
+                                                         "Packets sent",
+                                                         RPC_PRIVLVL_MIN,
+                                                         DISPTIME | DISPOPTSTRIP)));
+
+    add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<vita49_sink, uint64_t>(alias(),
+                                                         "bytes",
+                                                         &vita49_sink::getByteCount,
+                                                         pmt::from_uint64(0),
+                                                         pmt::from_uint64(UINT64_MAX),
+                                                         pmt::from_uint64(0),
+                                                         "bytes",
+                                                         "Bytes sent",
+                                                         RPC_PRIVLVL_MIN,
+                                                         DISPTIME | DISPOPTSTRIP)));
+
+    add_rpc_variable(rpcbasic_sptr(
+        new rpcbasic_register_get<vita49_sink, uint64_t>(alias(),
+                                                         "drops",
+                                                         &vita49_sink::getDropCount,
+                                                         pmt::from_uint64(0),
+                                                         pmt::from_uint64(UINT64_MAX),
+                                                         pmt::from_uint64(0),
+                                                         "packets",
+                                                         "Packets not sent",
+                                                         RPC_PRIVLVL_MIN,
+                                                         DISPTIME | DISPOPTSTRIP)));
+#endif /* GR_CTRLPORT */
+}
+
+bool vita49_sink_impl::item_time(uint64_t offset, uint32_t& sec, uint64_t& ps)
+{
+    if (!d_time_valid || d_rate <= 0.0) {
+        return false;
+    }
+
+    // items before the reference are possible for samples carried over
+    // from a packet that ended at the reference
+    double t = d_time_frac + (double)(int64_t)(offset - d_time_offset) / d_rate;
+    double whole = std::floor(t);
+    uint64_t frac = (uint64_t)std::llround((t - whole) * 1e12);
+    if (frac >= 1000000000000ULL) {
+        frac -= 1000000000000ULL;
+        whole += 1.0;
+    }
+
+    sec = (uint32_t)(d_time_sec + (int64_t)whole);
+    ps = frac;
+
+    return true;
+}
+
+void vita49_sink_impl::stamp(VRTPacket& pkt, uint64_t offset)
+{
+    uint32_t sec;
+    uint64_t ps;
+
+    if (item_time(offset, sec, ps)) {
+        pkt.getHeader()->setTsi(UTC);
+        pkt.getHeader()->setTsf(REAL_TIME);
+        pkt.setTsEpoch(sec);
+        pkt.setTsFrac(ps);
+    } else {
+        pkt.getHeader()->setTsi(NO_TSI);
+        pkt.getHeader()->setTsf(NO_TSF);
+    }
+}
+
+void vita49_sink_impl::start_packet(uint64_t offset)
+{
+    d_data.getHeader()->setType(SIGNAL_DATA_ID);
+    d_data.setStreamId(d_stream_id);
+    stamp(d_data, offset);
+
+    d_pkt_prologue = d_data.getPrologueWords();
+    d_pkt_buf = d_tx->getBuffer();
+    d_pkt_offset = offset;
+    d_pkt_samples = 0;
+}
+
+void vita49_sink_impl::send_packet(size_t nsamples)
+{
+    uint8_t* payload = d_pkt_buf + 4 * d_pkt_prologue;
+    size_t nbytes = nsamples * d_sample_bytes;
+    size_t nwords = (nbytes + 3) / 4;
+
+    // packed formats pad the last word with zeros
+    memset(payload + nbytes, 0, 4 * nwords - nbytes);
+
+    d_data.getHeader()->setPktCount(d_data_count++ & 0xf);
+    d_data.setPayloadData(payload, nwords);
+    d_tx->commit(d_data.pack(d_pkt_buf, d_tx->getMaxPacket()));
+
+    d_pkt_samples = 0;
+}
+
+void vita49_sink_impl::send_context(uint64_t offset)
+{
+    d_context.reset();
+    d_context.getHeader()->setType(CONTEXT);
+    d_context.getHeader()->setPktCount(d_ctx_count++ & 0xf);
+    d_context.setStreamId(d_stream_id);
+    d_context.setChange(true);
+    stamp(d_context, offset);
+
+    if (d_freq >= 0.0) {
+        // RF Ref
+        d_context.addValue(27, d_freq);
+    }
+    if (d_rate > 0.0) {
+        // Sample Rate
+        d_context.addValue(21, d_rate);
+    }
+
+    uint8_t* buf = d_tx->getBuffer();
+    d_tx->commit(d_context.pack(buf, d_tx->getMaxPacket()));
+}
+
+void vita49_sink_impl::handle_tags(const std::vector<gr::tag_t>& tags, size_t& idx)
+{
+    uint64_t offset = tags[idx].offset;
+    bool new_time = false;
+    bool new_context = false;
+    uint64_t sec = 0;
+    double frac = 0.0;
+    double rate = d_rate;
+    double freq = d_freq;
+
+    for (; idx < tags.size() && tags[idx].offset == offset; idx++) {
+        const gr::tag_t& tag = tags[idx];
+        if (pmt::eqv(tag.key, PMTCONSTSTR__rx_time())) {
+            sec = pmt::to_uint64(pmt::tuple_ref(tag.value, 0));
+            frac = pmt::to_double(pmt::tuple_ref(tag.value, 1));
+            new_time = true;
+        } else if (pmt::eqv(tag.key, PMTCONSTSTR__rx_rate())) {
+            rate = pmt::to_double(tag.value);
+        } else if (pmt::eqv(tag.key, PMTCONSTSTR__rx_freq())) {
+            freq = pmt::to_double(tag.value);
+        }
+    }
+    new_context = (rate != d_rate) || (freq != d_freq);
+    if (!new_time && !new_context) {
+        return;
+    }
+
+    // end the packet under the old reference, samples past its last whole
+    // word are carried into the next packet
+    uint8_t carry[4 * sizeof(gr_complex)];
+    size_t ncarry = d_pkt_samples % d_align;
+    uint64_t carry_offset = offset - ncarry;
+    if (d_pkt_samples > 0) {
+        size_t nsend = d_pkt_samples - ncarry;
+        memcpy(carry,
+               d_pkt_buf + 4 * d_pkt_prologue + nsend * d_sample_bytes,
+               ncarry * d_sample_bytes);
+        if (nsend > 0) {
+            send_packet(nsend);
+        }
+        d_pkt_samples = 0;
+    }
+
+    if (new_time) {
+        d_time_valid = true;
+        d_time_sec = sec;
+        d_time_frac = frac;
+        d_time_offset = offset;
+    }
+    d_rate = rate;
+    d_freq = freq;
+    if (new_context) {
+        send_context(offset);
+    }
+
+    if (ncarry > 0) {
+        start_packet(carry_offset);
+        memcpy(d_pkt_buf + 4 * d_pkt_prologue, carry, ncarry * d_sample_bytes);
+        d_pkt_samples = ncarry;
+    }
+}
+
+int vita49_sink_impl::work(int noutput_items,
+                           gr_vector_const_void_star& input_items,
+                           gr_vector_void_star& output_items)
+{
+    uint64_t start = nitems_read(0);
+    std::vector<gr::tag_t> tags;
+    size_t tag_idx = 0;
+    size_t pos = 0;
+
+    get_tags_in_range(tags, 0, start, start + noutput_items);
+    std::sort(tags.begin(), tags.end(), gr::tag_t::offset_compare);
+
+    while (pos < (size_t)noutput_items) {
+        if (tag_idx < tags.size() && tags[tag_idx].offset == start + pos) {
+            handle_tags(tags, tag_idx);
+            continue;
+        }
+
+        // fill packets up to the next tag
+        size_t end = (tag_idx < tags.size()) ? tags[tag_idx].offset - start : noutput_items;
+        while (pos < end) {
+            if (d_pkt_samples == 0) {
+                start_packet(start + pos);
+            }
+
+            size_t n = std::min(end - pos, d_samples_per_packet - d_pkt_samples);
+            uint8_t* out =
+                d_pkt_buf + 4 * d_pkt_prologue + d_pkt_samples * d_sample_bytes;
+            if (d_fc32) {
+                d_payload.from_fc32(
+                    (const gr_complex*)input_items[0] + pos, out, n, d_scale);
+            } else {
+                d_payload.from_sc16(
+                    (const int16_t*)input_items[0] + 2 * pos, out, n, d_scale);
+            }
+            d_pkt_samples += n;
+            pos += n;
+
+            if (d_pkt_samples == d_samples_per_packet) {
+                send_packet(d_pkt_samples);
+            }
+        }
+    }
+
+    // send the packets completed by this call
+    d_tx->flush();
+
+    return noutput_items;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
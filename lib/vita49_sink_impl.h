@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_SINK_IMPL_H
+#define INCLUDED_SANDIA_UTILS_VITA49_SINK_IMPL_H
+
+#include "vita/ContextPacket.h"
+#include "vita/vitatx.h"
+#include "vita49_payload.h"
+#include <gnuradio/sandia_utils/vita49_sink.h>
+#include <gnuradio/tags.h>
+
+namespace gr {
+namespace sandia_utils {
+
+class vita49_sink_impl : public vita49_sink
+{
+private:
+    vita_tx* d_tx;
+    bool d_fc32;
+    float d_scale;
+    vita49_payload d_payload;
+    size_t d_sample_bytes;
+    size_t d_samples_per_packet;
+    uint32_t d_stream_id;
+
+    // samples per whole number of payload words, packets ending early
+    // are cut on a multiple of it
+    size_t d_align;
+
+    // packet being filled, samples are converted straight into its send
+    // buffer after the prologue
+    VRTPacket d_data;
+    ContextPacket d_context;
+    uint8_t* d_pkt_buf;
+    size_t d_pkt_prologue;
+    size_t d_pkt_samples;
+    uint64_t d_pkt_offset;
+    int d_data_count;
+    int d_ctx_count;
+
+    // time reference, the rx_time of item d_time_offset
+    bool d_time_valid;
+    uint64_t d_time_sec;
+    double d_time_frac;
+    uint64_t d_time_offset;
+    double d_rate;
+    double d_freq;
+
+    /**
+     * Computes the time stamp of an item from the time reference
+     *
+     * @param offset - absolute item offset
+     * @param sec - UTC seconds
+     * @param ps - picoseconds into the second
+     * @return bool - false if the time or sample rate is not known
+     */
+    bool item_time(uint64_t offset, uint32_t& sec, uint64_t& ps);
+
+    /**
+     * Sets the time stamp fields of a packet for an item
+     *
+     * @param pkt - packet to stamp
+     * @param offset - absolute item offset of the first sample
+     */
+    void stamp(VRTPacket& pkt, uint64_t offset);
+
+    /**
+     * Starts a data packet at an item
+     *
+     * @param offset - absolute item offset of the first sample
+     */
+    void start_packet(uint64_t offset);
+
+    /**
+     * Sends the first \p nsamples samples of the packet being filled
+     *
+     * @param nsamples - samples to send
+     */
+    void send_packet(size_t nsamples);
+
+    /**
+     * Ends the packet being filled early, on a whole number of payload
+     * words. Samples past the last whole word start the next packet.
+     *
+     * @param offset - absolute item offset the next packet starts after
+     */
+    void end_packet(uint64_t offset);
+
+    /**
+     * Sends a context packet with the frequency and sample rate
+     *
+     * @param offset - absolute item offset the context applies from
+     */
+    void send_context(uint64_t offset);
+
+    /**
+     * Applies the tags at one item offset
+     *
+     * @param tags - tags sorted by offset
+     * @param idx - index of the first tag at the offset, advanced past them
+     */
+    void handle_tags(const std::vector<gr::tag_t>& tags, size_t& idx);
+
+public:
+    vita49_sink_impl(const std::string& host,
+                     int port,
+                     const std::string& transport,
+                     const std::string& type,
+                     const std::string& payload,
+                     int samples_per_packet,
+                     uint32_t stream_id,
+                     double scale);
+    ~vita49_sink_impl();
+
+    bool start();
+    bool stop();
+
+    uint64_t getPacketCount(void);
+    uint64_t getByteCount(void);
+    uint64_t getDropCount(void);
+
+    void setup_rpc();
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_SINK_IMPL_H */
@@ -0,0 +1,325 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vita/vitarx.h"
+#include "vita/vitarxudp.h"
+#include "vita49_pdu.h"
+#include "vita49_stream_source_impl.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sandia_utils/constants.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+namespace sandia_utils {
+
+vita49_stream_source::sptr vita49_stream_source::make(int port,
+                                                      const std::string& transport,
+                                                      const std::string& type,
+                                                      double scale,
+                                                      const std::string& payload)
+{
+    return gnuradio::get_initial_sptr(
+        new vita49_stream_source_impl(port, transport, type, scale, payload));
+}
+
+namespace {
+size_t output_itemsize(const std::string& type)
+{
+    if (type == "sc16") {
+        return 2 * sizeof(int16_t);
+    } else if (type == "fc32") {
+        return sizeof(gr_complex);
+    }
+    throw std::invalid_argument(
+        str(boost::format("vita49_stream_source: unknown output type %s") % type));
+}
+} // namespace
+
+/*
+ * The private constructor
+ */
+vita49_stream_source_impl::vita49_stream_source_impl(int port,
+                                                     const std::string& transport,
+                                                     const std::string& type,
+                                                     double scale,
+                                                     const std::string& payload)
+    : gr::sync_block("vita49_stream_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, output_itemsize(type))),
+      d_rx(NULL),
+      d_fc32(type == "fc32"),
+      d_scale(scale),
+      d_payload(payload),
+      d_sample_bytes(d_payload.sample_bytes()),
+      d_ring(VITA_STREAM_RING_SAMPLES * d_sample_bytes),
+      d_head(0),
+      d_tail(0),
+      d_resync(true),
+      d_last_count(-1),
+      d_rate(0),
+      d_time_sample(0),
+      d_have_time(false),
+      d_overflows(0),
+      d_running(false)
+{
+    if (transport == "tcp") {
+        d_rx = new vita_rx(port);
+    } else if (transport == "udp") {
+        d_rx = new vita_rx_udp(port);
+    } else {
+        throw std::invalid_argument(str(
+            boost::format("vita49_stream_source: unknown transport %s") % transport));
+    }
+    if (d_scale == 0.0) {
+        d_scale = 1.0;
+    }
+    d_rx->add_listener(this);
+    d_rx->set_sample_bytes(d_sample_bytes);
+    d_rx->set_stats_period(1.0);
+
+    message_port_register_out(PMTCONSTSTR__stats());
+}
+
+/*
+ * Our virtual destructor.
+ */
+vita49_stream_source_impl::~vita49_stream_source_impl()
+{
+    stop();
+    delete d_rx;
+}
+
+bool vita49_stream_source_impl::start()
+{
+    {
+        gr::thread::scoped_lock lock(d_ring_mutex);
+        d_head = d_tail = 0;
+        d_pending_tags.clear();
+        d_resync = true;
+        d_last_count = -1;
+        d_have_time = false;
+    }
+
+    d_running = true;
+    if (d_rx->start() != 1) {
+        GR_LOG_WARN(d_logger, "Error starting VITA 49 receiver");
+    }
+
+    return true;
+}
+
+bool vita49_stream_source_impl::stop()
+{
+    d_running = false;
+    d_rx->stop();
+    d_ring_cond.notify_all();
+
+    return true;
+}
+
+void vita49_stream_source_impl::setRcvBuf(int bytes) { d_rx->set_rcvbuf(bytes); }
+
+uint64_t vita49_stream_source_impl::getOverflowCount(void)
+{
+    gr::thread::scoped_lock lock(d_ring_mutex);
+    return d_overflows;
+}
+
+void vita49_stream_source_impl::received_stats(const std::vector<vita_stream_stats>& stats,
+                                                uint64_t resyncs)
+{
+    if (d_running) {
+        message_port_pub(PMTCONSTSTR__stats(), vita49_stats_msg(stats, resyncs));
+    }
+}
+
+void vita49_stream_source_impl::received_packet(PacketType type, VRTPacket* pkt)
+{
+    if (!d_running) {
+        return;
+    }
+
+    gr::thread::scoped_lock lock(d_ring_mutex);
+    switch (type) {
+    case PacketType::SIGNAL_DATA:
+    case PacketType::SIGNAL_DATA_ID:
+        handle_data(pkt);
+        break;
+    case PacketType::CONTEXT:
+        handle_context((ContextPacket*)pkt);
+        break;
+    default:
+        break;
+    }
+}
+
+void vita49_stream_source_impl::add_tag(pmt::pmt_t key, pmt::pmt_t value)
+{
+    gr::tag_t tag;
+    tag.offset = d_head;
+    tag.key = key;
+    tag.value = value;
+    d_pending_tags.push_back(tag);
+}
+
+void vita49_stream_source_impl::handle_data(VRTPacket* pkt)
+{
+    // payload in network byte order, packets built in memory rather than
+    // decoded from a receive buffer only have host order words
+    const uint8_t* data = pkt->getPayloadData();
+    std::vector<uint32_t> words;
+    if (data == NULL) {
+        for (uint32_t word : *pkt->getPayload()) {
+            words.push_back(htonl(word));
+        }
+        data = (const uint8_t*)words.data();
+    }
+
+    // trailing pad bits of packed formats are not a whole sample
+    size_t nsamples = d_payload.nsamples(4 * pkt->getPayloadWords());
+    if (nsamples == 0) {
+        return;
+    }
+
+    // the packet count is 4 bits, any other value means packets were lost
+    int count = pkt->getHeader()->getPktCount();
+    if ((d_last_count >= 0) && (count != ((d_last_count + 1) & 0xf))) {
+        d_resync = true;
+    }
+    d_last_count = count;
+
+    // the output fell behind, drop the packet rather than block the receiver
+    if (d_head - d_tail + nsamples > VITA_STREAM_RING_SAMPLES) {
+        d_overflows++;
+        d_resync = true;
+        return;
+    }
+
+    // packet time in integer seconds and picoseconds, exact when the
+    // fractional time stamp is in picoseconds or a sample count of a known
+    // rate
+    bool timed = (pkt->getHeader()->getTsi() != NO_TSI);
+    bool exact = false;
+    vita_time t(pkt->getTsEpoch(), 0);
+    if (timed && (pkt->getHeader()->getTsf() == REAL_TIME)) {
+        t = vita_time(pkt->getTsEpoch(), pkt->getTsFrac());
+        exact = true;
+    } else if (timed && (pkt->getHeader()->getTsf() == SAMPLE_COUNT) && (d_rate > 0)) {
+        t = vita_time::from_count(pkt->getTsEpoch(), pkt->getTsFrac(), d_rate);
+        exact = true;
+    }
+
+    // the packet should start where the samples since the last rx_time
+    // tag end, anything more than half a sample out is a drop or jitter
+    // the samples cannot follow on from
+    if (!d_resync && d_have_time && exact && (d_rate > 0)) {
+        vita_time expected = d_time.after(d_head - d_time_sample, d_rate);
+        if (!expected.same_sample(t, d_rate)) {
+            d_resync = true;
+        }
+    }
+
+    if (d_resync && timed) {
+        add_tag(PMTCONSTSTR__rx_time(),
+                pmt::make_tuple(pmt::from_uint64(t.sec), pmt::from_double(t.frac())));
+        d_time = t;
+        d_time_sample = d_head;
+        d_have_time = exact;
+        d_resync = false;
+    }
+
+    // the ring holds whole samples, so a sample never wraps
+    size_t idx = d_head & (VITA_STREAM_RING_SAMPLES - 1);
+    size_t first = std::min(nsamples, (size_t)VITA_STREAM_RING_SAMPLES - idx);
+    memcpy(&d_ring[idx * d_sample_bytes], data, first * d_sample_bytes);
+    memcpy(&d_ring[0], data + first * d_sample_bytes, (nsamples - first) * d_sample_bytes);
+    d_head += nsamples;
+
+    d_ring_cond.notify_one();
+}
+
+void vita49_stream_source_impl::handle_context(ContextPacket* pkt)
+{
+    for (CifValue* cf : *pkt->getValues()) {
+        switch (cf->getId()) {
+        case (27):
+            // RF Ref
+            add_tag(PMTCONSTSTR__rx_freq(), pmt::from_double(cf->getValue()));
+            break;
+        case (21):
+            // Sample Rate, a new rate restarts the time reference
+            if (vita_time::rate_fixed(cf->getValue()) != d_rate) {
+                d_rate = vita_time::rate_fixed(cf->getValue());
+                d_resync = true;
+            }
+            add_tag(PMTCONSTSTR__rx_rate(), pmt::from_double(cf->getValue()));
+            break;
+        }
+    }
+}
+
+int vita49_stream_source_impl::work(int noutput_items,
+                                    gr_vector_const_void_star& input_items,
+                                    gr_vector_void_star& output_items)
+{
+    uint64_t tail;
+    size_t nitems;
+
+    {
+        gr::thread::scoped_lock lock(d_ring_mutex);
+        if (d_head == d_tail) {
+            // block until the receiver provides samples rather than spinning.
+            // d_ring_mutex is released while waiting
+            d_ring_cond.wait_for(lock, boost::chrono::milliseconds(VITA_STREAM_WAIT_MS));
+            if (d_head == d_tail) {
+                return 0;
+            }
+        }
+
+        tail = d_tail;
+        nitems = std::min((uint64_t)noutput_items, d_head - d_tail);
+
+        while (!d_pending_tags.empty() && (d_pending_tags.front().offset < tail + nitems)) {
+            gr::tag_t tag = d_pending_tags.front();
+            tag.offset = nitems_written(0) + (tag.offset - tail);
+            add_item_tag(0, tag);
+            d_pending_tags.pop_front();
+        }
+    }
+
+    // the receiver only writes outside [d_tail, d_head), so the samples
+    // are converted without the lock, in at most two runs around the wrap
+    size_t idx = tail & (VITA_STREAM_RING_SAMPLES - 1);
+    size_t first = std::min(nitems, (size_t)VITA_STREAM_RING_SAMPLES - idx);
+    if (d_fc32) {
+        gr_complex* out = (gr_complex*)output_items[0];
+        d_payload.to_fc32(&d_ring[idx * d_sample_bytes], out, first, d_scale);
+        d_payload.to_fc32(&d_ring[0], out + first, nitems - first, d_scale);
+    } else {
+        int16_t* out = (int16_t*)output_items[0];
+        d_payload.to_sc16(&d_ring[idx * d_sample_bytes], out, first, d_scale);
+        d_payload.to_sc16(&d_ring[0], out + 2 * first, nitems - first, d_scale);
+    }
+
+    {
+        gr::thread::scoped_lock lock(d_ring_mutex);
+        d_tail += nitems;
+    }
+
+    return nitems;
+}
+
+} /* namespace sandia_utils */
+} /* namespace gr */
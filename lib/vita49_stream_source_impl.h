@@ -0,0 +1,134 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_IMPL_H
+#define INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_IMPL_H
+
+#include "vita/ContextPacket.h"
+#include "vita/vitarxbase.h"
+#include "vita/vitatime.h"
+#include "vita49_payload.h"
+#include "vita49_pdu.h"
+#include <gnuradio/sandia_utils/vita49_stream_source.h>
+#include <gnuradio/tags.h>
+#include <gnuradio/thread/thread.h>
+#include <deque>
+
+// samples buffered between the receiver and work(), power of 2
+#define VITA_STREAM_RING_SAMPLES (1 << 22)
+
+// longest time work() blocks waiting for samples before returning to the
+// scheduler
+#define VITA_STREAM_WAIT_MS 100
+
+namespace gr {
+namespace sandia_utils {
+
+class vita49_stream_source_impl : public vita49_rx_stats<vita49_stream_source>, public vita_rx_listener
+{
+private:
+    vita_rx_base* d_rx;
+    bool d_fc32;
+    float d_scale;
+    vita49_payload d_payload;
+    size_t d_sample_bytes;
+
+    // payload samples as received, written by the receiver thread and
+    // converted straight into the output buffer by work(). d_head and
+    // d_tail count samples since start, the receiver only writes the free
+    // region so work() converts without holding the lock
+    std::vector<uint8_t> d_ring;
+    uint64_t d_head;
+    uint64_t d_tail;
+    gr::thread::mutex d_ring_mutex;
+    gr::thread::condition_variable d_ring_cond;
+
+    // tags waiting for their samples to be produced, offsets count samples
+    // since start like d_head
+    std::deque<gr::tag_t> d_pending_tags;
+
+    // stream continuity, a time tag is sent on the next packet when set
+    bool d_resync;
+    int d_last_count;
+
+    // sample rate as 44.20 fixed point Hz, 0 until a Context packet has
+    // given it
+    uint64_t d_rate;
+
+    // time of sample d_time_sample, from the last rx_time tag. Valid for
+    // checking later packets against when d_have_time is set
+    vita_time d_time;
+    uint64_t d_time_sample;
+    bool d_have_time;
+    uint64_t d_overflows;
+
+    volatile bool d_running;
+
+    /**
+     * Handles VRT Data packets, called with d_ring_mutex held
+     *
+     * @param pkt - the packet to handle
+     */
+    void handle_data(VRTPacket* pkt);
+
+    /**
+     * Handles VRT Context packets, called with d_ring_mutex held
+     *
+     * @param pkt - the packet to handle
+     */
+    void handle_context(ContextPacket* pkt);
+
+    /**
+     * Queues a tag at the current write position
+     */
+    void add_tag(pmt::pmt_t key, pmt::pmt_t value);
+
+public:
+    vita49_stream_source_impl(int port,
+                              const std::string& transport,
+                              const std::string& type,
+                              double scale,
+                              const std::string& payload);
+    ~vita49_stream_source_impl();
+
+    bool start();
+    bool stop();
+
+    /**
+     * Called by the receiver thread when a packet is received
+     *
+     * @param type - type of packet received
+     * @param pkt - the packet received
+     */
+    virtual void received_packet(PacketType type, VRTPacket* pkt);
+
+    /**
+     * Called by the receiver thread once every statistics period
+     *
+     * @param stats - statistics of every stream ID seen
+     * @param resyncs - number of times the receiver lost packet alignment
+     */
+    virtual void received_stats(const std::vector<vita_stream_stats>& stats,
+                                uint64_t resyncs);
+
+    void setRcvBuf(int bytes);
+    uint64_t getOverflowCount(void);
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+protected:
+    vita_rx_base* receiver() { return d_rx; }
+};
+
+} // namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_STREAM_SOURCE_IMPL_H */
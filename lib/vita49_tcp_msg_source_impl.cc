@@ -12,27 +12,31 @@
 #endif
 
 #include "vita49_tcp_msg_source_impl.h"
+#include "vita49_pdu.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/sandia_utils/constants.h>
-#include <arpa/inet.h>
-#include <endian.h>
+#include <algorithm>
+#include <string>
 
 namespace gr
 {
   namespace sandia_utils
   {
 
-  vita49_tcp_msg_source::sptr vita49_tcp_msg_source::make(int port, bool socket_always_on)
+  vita49_tcp_msg_source::sptr vita49_tcp_msg_source::make(int port, bool socket_always_on,
+      const std::vector<uint32_t> &stream_ids, int num_streams)
   {
       return gnuradio::get_initial_sptr(
-          new vita49_tcp_msg_source_impl(port, socket_always_on));
+          new vita49_tcp_msg_source_impl(port, socket_always_on, stream_ids, num_streams));
     }
 
     /*
      * The private constructor
      */
     vita49_tcp_msg_source_impl::vita49_tcp_msg_source_impl(int port,
-                                                           bool socket_always_on)
+                                                           bool socket_always_on,
+                                                           const std::vector<uint32_t> &stream_ids,
+                                                           int num_streams)
         : gr::block("vita49_tcp_msg_source",
                     gr::io_signature::make(0, 0, 0),
                     gr::io_signature::make(0, 0, 0))
@@ -45,6 +49,8 @@ namespace gr
       d_ignoreTune = false;
       rx = new vita_rx( port );
       rx->add_listener( this );
+      rx->set_stats_period( 1.0 );
+      rx->set_queue_size( VITA_RX_QUEUE_PACKETS );
 
       if (d_socketAlwaysOn) {
           openBackend();
@@ -60,6 +66,23 @@ namespace gr
 
       message_port_register_out(PMTCONSTSTR__out());
       message_port_register_out(PMTCONSTSTR__tune());
+      message_port_register_out(PMTCONSTSTR__stats());
+
+      // listed stream IDs take the first ports, the rest are handed out as
+      // new stream IDs arrive
+      size_t nports = std::max( stream_ids.size(), (size_t)std::max( num_streams, 0 ) );
+      for( size_t i = 0; i < nports; i++ )
+      {
+        d_outPorts.push_back( pmt::mp( "out" + std::to_string( i ) ) );
+        d_tunePorts.push_back( pmt::mp( "tune" + std::to_string( i ) ) );
+        message_port_register_out( d_outPorts.back() );
+        message_port_register_out( d_tunePorts.back() );
+      }
+      for( size_t i = 0; i < stream_ids.size(); i++ )
+      {
+        d_routes[stream_ids[i]] = i;
+      }
+      d_nextPort = stream_ids.size();
 
       return;
     } //end constructor
@@ -186,6 +209,23 @@ namespace gr
         return;
     } // end closeSocket
 
+    /**
+     * Sets the TCP receive buffer size of client connections
+     *
+     * @param bytes - receive buffer size in bytes, 0 for the system default
+     */
+    void vita49_tcp_msg_source_impl::setRcvBuf( int bytes )
+    {
+      rx->set_rcvbuf( bytes );
+      return;
+    }
+
+    void vita49_tcp_msg_source_impl::setCapture( const std::string &path )
+    {
+      rx->set_capture( path );
+      return;
+    }
+
     /**
      * Handles VRT Data packets
      *
@@ -193,48 +233,26 @@ namespace gr
      */
     void vita49_tcp_msg_source_impl::handle_data( VRTPacket *pkt )
     {
-      pmt::pmt_t metadata;
-      pmt::pmt_t data_vec;
+      pmt::pmt_t pdu = vita49_data_pdu( pkt, d_ignoreTime );
 
-
-      //VRT packet payload is 32bit word oriented. Each 32bit word is a single sample
-      //  16bit for I and 16bit for Q. Thus vector size of int16_t is 2x payload side
-      std::vector<int16_t> dt;
-      int16_t iv, qv;
-      uint32_t raw;
-
-      //printf("VRT had %d word\n", pkt->getPayload()->size() );
-      for(size_t i = 0; i < pkt->getPayload()->size(); i++ )
-      {
-        raw = pkt->getPayload()->at( i );
-        //raw = be32toh( raw );
-
-        iv = ((raw & 0xffff0000) >> 16) & 0x0000ffff;
-        qv = raw & 0x0000ffff;
-
-        //iv = ntohs( iv );
-        //qv = ntohs( qv );
-
-        dt.push_back(iv);
-        dt.push_back(qv);
-
-      } //end for(i
-
-      //printf("DT has %d elements\n", dt.size() );
-      if( dt.size() > 0 )
+      if( !pmt::is_null( pdu ) )
       {
-        metadata = pmt::make_dict();
-        data_vec = pmt::init_s16vector( dt.size(), dt.data() );
-
-        if( !d_ignoreTime )
+        uint32_t stream_id = pkt->getStreamId();
+        pmt::pmt_t meta = pmt::car( pdu );
+        if( pkt->getType() == PacketType::SIGNAL_DATA_ID )
+        {
+          meta = pmt::dict_add( meta, PMTCONSTSTR__stream_id(), pmt::from_uint64( stream_id ) );
+        }
+        auto ctx = d_context.find( stream_id );
+        if( ctx != d_context.end() )
         {
-          pmt::pmt_t time_tag = pmt::make_tuple(pmt::from_uint64( pkt->getTsEpoch() ), pmt::from_double( pkt->getTsFrac() * 1e-12));
-          metadata = pmt::dict_add(metadata, PMTCONSTSTR__tx_time(), time_tag);
+          meta = pmt::dict_add( meta, PMTCONSTSTR__context(), ctx->second );
         }
+        pdu = pmt::cons( meta, pmt::cdr( pdu ) );
 
         // ship it!
-        message_port_pub(PMTCONSTSTR__out(), pmt::cons(metadata, data_vec));
-        //printf("VITA49 - Published PDU\n");
+        int idx = route( stream_id );
+        message_port_pub( ( idx < 0 ) ? PMTCONSTSTR__out() : d_outPorts[idx], pdu );
       }
 
       return;
@@ -247,60 +265,42 @@ namespace gr
      */
     void vita49_tcp_msg_source_impl::handle_context( ContextPacket *pkt )
     {
-      pmt::pmt_t metadata = pmt::make_dict();
-      pmt::pmt_t data_vec = pmt::make_s16vector(1, 0);
+      pmt::pmt_t pdu = vita49_context_pdu( pkt, d_ignoreTime );
+      uint32_t stream_id = pkt->getStreamId();
+
+      // kept for the stream's data PDUs even when tune is ignored
+      d_context[stream_id] = pmt::car( pdu );
 
-      if( !d_ignoreTime )
+      if( !d_ignoreTune )
       {
-        pmt::pmt_t time_tag = pmt::make_tuple(pmt::from_uint64( pkt->getTsEpoch() ), pmt::from_double( pkt->getTsFrac() * 1e-12));
-        metadata = pmt::dict_add(metadata, PMTCONSTSTR__time(), time_tag);
-        metadata = pmt::dict_add(metadata, PMTCONSTSTR__direction(), PMTCONSTSTR__TX());
+          pdu = pmt::cons( pmt::dict_add( pmt::car( pdu ), PMTCONSTSTR__stream_id(),
+                pmt::from_uint64( stream_id ) ), pmt::cdr( pdu ) );
+
+          int idx = route( stream_id );
+          message_port_pub( ( idx < 0 ) ? PMTCONSTSTR__tune() : d_tunePorts[idx], pdu );
       }
 
-      for( CifValue *cf : *pkt->getValues() )
-      {
-        switch( cf->getId() )
-        {
-          case (29):
-          {
-            //bandwidth
-            metadata = pmt::dict_add(
-                metadata, PMTCONSTSTR__bandwidth(), pmt::from_double(cf->getValue()));
-            break;
-          }
-          case (28):
-          {
-            //IF Ref
-            break;
-          }
-          case (27):
-          {
-            //RF Ref
-            metadata = pmt::dict_add(
-                metadata, PMTCONSTSTR__lo_freq(), pmt::from_double(cf->getValue()));
-            break;
-          }
-          case (21):
-          {
-            //Sample Rate
-            metadata = pmt::dict_add(
-                metadata, PMTCONSTSTR__rate(), pmt::from_double(cf->getValue()));
-            break;
-          }
-
-        } //end switch
-
-      } //end for( cf
+      return;
+    }
 
+    int vita49_tcp_msg_source_impl::route( uint32_t stream_id )
+    {
+      auto it = d_routes.find( stream_id );
+      if( it != d_routes.end() )
+      {
+        return it->second;
+      }
 
-      if( !d_ignoreTune )
+      if( d_nextPort >= d_outPorts.size() )
       {
-          message_port_pub(PMTCONSTSTR__tune(), pmt::cons(metadata, data_vec));
-          // printf("VITA49 - Published Command PDU\n");
+        return -1;
       }
 
-      return;
-    }
+      GR_LOG_INFO(d_logger, boost::format( "Stream ID 0x%08x routed to out%d" ) % stream_id %
+          d_nextPort);
+      d_routes[stream_id] = d_nextPort;
+      return d_nextPort++;
+    } //end route
 
     void vita49_tcp_msg_source_impl::openBackend(void)
     {
@@ -330,6 +330,45 @@ namespace gr
         return;
     }
 
+    void vita49_tcp_msg_source_impl::setQueueSize( int packets )
+    {
+      rx->set_queue_size( std::max( packets, 0 ) );
+      return;
+    }
+
+    uint64_t vita49_tcp_msg_source_impl::getQueueDepth( void )
+    {
+      return rx->get_queue_depth();
+    }
+
+    uint64_t vita49_tcp_msg_source_impl::getQueueDrops( void )
+    {
+      return rx->get_queue_drop_count();
+    }
+
+    /**
+     * Called by the receiver thread once every statistics period
+     *
+     * @param stats - statistics of every stream ID seen
+     * @param resyncs - number of times the receiver lost packet alignment
+     */
+    void vita49_tcp_msg_source_impl::received_stats( const std::vector<vita_stream_stats> &stats,
+        uint64_t resyncs )
+    {
+      if( d_running )
+      {
+        message_port_pub(PMTCONSTSTR__stats(), vita49_stats_msg( stats, resyncs ));
+      }
+
+      return;
+    }
+
+    void vita49_tcp_msg_source_impl::setup_rpc()
+    {
+      vita49_rx_stats<vita49_tcp_msg_source>::setup_rpc();
+      setup_queue_rpc();
+    }
+
   } /* namespace sandia_utils */
 } /* namespace gr */
 
@@ -12,9 +12,13 @@
 
 #include <gnuradio/sandia_utils/vita49_tcp_msg_source.h>
 
+#include "vita49_pdu.h"
 #include"vita/vitarx.h"
 #include"vita/ContextPacket.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace gr
 {
   namespace sandia_utils
@@ -23,7 +27,7 @@ namespace gr
     /**
      * Implmenting class of VITA 49 msg source
      */
-    class vita49_tcp_msg_source_impl : public vita49_tcp_msg_source, public vita_rx_listener
+    class vita49_tcp_msg_source_impl : public vita49_rx_stats<vita49_tcp_msg_source>, public vita_rx_listener
     {
       private:
         vita_rx *rx;
@@ -32,14 +36,29 @@ namespace gr
         bool d_socketAlwaysOn;
         volatile bool d_running;
 
+        // per stream output ports, out<N> and tune<N>
+        std::vector<pmt::pmt_t> d_outPorts;
+        std::vector<pmt::pmt_t> d_tunePorts;
+
+        // stream ID to port index, and the next port given to a new stream
+        std::unordered_map<uint32_t, size_t> d_routes;
+        size_t d_nextPort;
+
+        // metadata of the last context packet of each stream, only used by
+        // the receiver thread
+        std::unordered_map<uint32_t, pmt::pmt_t> d_context;
+
     public:
         /**
          * Constructor
          *
          * @param port - TCP port to listen on
          * @param socket_always_on - true to always leave TCP socket open, default false
+         * @param stream_ids - stream IDs routed to out0/tune0, out1/tune1, ...
+         * @param num_streams - number of routed port pairs
          */
-        vita49_tcp_msg_source_impl(int port, bool socket_always_on = false);
+        vita49_tcp_msg_source_impl(int port, bool socket_always_on,
+            const std::vector<uint32_t> &stream_ids, int num_streams);
 
         /**
          * Deconstructor
@@ -93,6 +112,42 @@ namespace gr
          */
         virtual void closeSocket(void);
 
+        /**
+         * Sets the TCP receive buffer size of client connections
+         *
+         * @param bytes - receive buffer size in bytes, 0 for the system default
+         */
+        virtual void setRcvBuf( int bytes );
+
+        /**
+         * Records the raw received bytes for replay. Applied when the socket
+         * is next opened.
+         *
+         * @param path - capture file, empty to stop capturing
+         */
+        virtual void setCapture( const std::string &path );
+
+        /**
+         * Called by the receiver thread once every statistics period
+         *
+         * @param stats - statistics of every stream ID seen
+         * @param resyncs - number of times the receiver lost packet alignment
+         */
+        virtual void received_stats( const std::vector<vita_stream_stats> &stats,
+            uint64_t resyncs );
+
+        virtual void setQueueSize( int packets );
+        virtual uint64_t getQueueDepth( void );
+        virtual uint64_t getQueueDrops( void );
+
+        void setup_rpc();
+
+      protected:
+        virtual vita_rx_base *receiver()
+        {
+          return rx;
+        }
+
     private:
         /**
          * Handles VRT Data packets
@@ -108,6 +163,15 @@ namespace gr
          */
         void handle_context( ContextPacket *pkt );
 
+        /**
+         * Returns the routed port index of a stream, assigning a free port to
+         * a stream seen for the first time
+         *
+         * @param stream_id - stream ID of the packet
+         * @return int - port index, -1 to use the default ports
+         */
+        int route( uint32_t stream_id );
+
 
         void openBackend(void);
         void closeBackend(void);
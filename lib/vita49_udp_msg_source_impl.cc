@@ -0,0 +1,227 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vita49_udp_msg_source_impl.h"
+#include "vita49_pdu.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sandia_utils/constants.h>
+#include <algorithm>
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    vita49_udp_msg_source::sptr vita49_udp_msg_source::make(int port)
+    {
+      return gnuradio::get_initial_sptr(
+          new vita49_udp_msg_source_impl(port));
+    }
+
+    /*
+     * The private constructor
+     */
+    vita49_udp_msg_source_impl::vita49_udp_msg_source_impl(int port)
+        : gr::block("vita49_udp_msg_source",
+                    gr::io_signature::make(0, 0, 0),
+                    gr::io_signature::make(0, 0, 0))
+    {
+      d_running = false;
+      d_ignoreTime = false;
+      d_ignoreTune = false;
+      rx = new vita_rx_udp( port );
+      rx->add_listener( this );
+      rx->set_stats_period( 1.0 );
+      rx->set_queue_size( VITA_RX_QUEUE_PACKETS );
+
+      message_port_register_out(PMTCONSTSTR__out());
+      message_port_register_out(PMTCONSTSTR__tune());
+      message_port_register_out(PMTCONSTSTR__stats());
+
+      return;
+    } //end constructor
+
+    /*
+     * Our virtual destructor.
+     */
+    vita49_udp_msg_source_impl::~vita49_udp_msg_source_impl()
+    {
+      closeSocket();
+      delete rx;
+
+      return;
+    } //end deconstructor
+
+
+    bool vita49_udp_msg_source_impl::start( void )
+    {
+      d_running = true;
+
+      if( rx->start() != 1 )
+      {
+        GR_LOG_WARN(d_logger, "Error starting vita_rx_udp component");
+      }
+
+      return true;
+    }
+
+    bool vita49_udp_msg_source_impl::stop( void )
+    {
+      d_running = false;
+
+      closeSocket();
+
+      return true;
+    } // end stop
+
+    /**
+     * Called when a packet is received
+     *
+     * @param type - type of packet received
+     * @param pkt - the packet received
+     */
+    void vita49_udp_msg_source_impl::received_packet( PacketType type, VRTPacket *pkt )
+    {
+      if( !d_running )
+      {
+        return;
+      }
+
+      switch( type )
+      {
+        case PacketType::SIGNAL_DATA:
+        case PacketType::SIGNAL_DATA_ID:
+        {
+          pmt::pmt_t pdu = vita49_data_pdu( pkt, d_ignoreTime );
+          if( !pmt::is_null( pdu ) )
+          {
+            message_port_pub(PMTCONSTSTR__out(), pdu);
+          }
+          break;
+        }
+        case PacketType::CONTEXT:
+        {
+          if( !d_ignoreTune )
+          {
+            message_port_pub(PMTCONSTSTR__tune(),
+                vita49_context_pdu( (ContextPacket*)pkt, d_ignoreTime ));
+          }
+          break;
+        }
+        default:
+        {
+          // drop it
+          GR_LOG_DEBUG(d_logger, "Dropping unhandled packet type");
+          break;
+        }
+      } // end switch
+
+      return;
+    } //end received_packet
+
+    void vita49_udp_msg_source_impl::setIgnoreTime( bool val )
+    {
+      d_ignoreTime = val;
+      return;
+    }
+
+    bool vita49_udp_msg_source_impl::getIgnoreTime( void )
+    {
+      return d_ignoreTime;
+    }
+
+    void vita49_udp_msg_source_impl::setIgnoreTune( bool val )
+    {
+      d_ignoreTune = val;
+      return;
+    }
+
+    bool vita49_udp_msg_source_impl::getIgnoreTune( void )
+    {
+      return d_ignoreTune;
+    }
+
+    /**
+     * Ensures UDP socket is closed
+     */
+    void vita49_udp_msg_source_impl::closeSocket(void)
+    {
+      rx->stop();
+
+      return;
+    } // end closeSocket
+
+    void vita49_udp_msg_source_impl::setRcvBuf( int bytes )
+    {
+      rx->set_rcvbuf( bytes );
+      return;
+    }
+
+    void vita49_udp_msg_source_impl::setCapture( const std::string &path )
+    {
+      rx->set_capture( path );
+      return;
+    }
+
+    void vita49_udp_msg_source_impl::setHostTimestamps( bool val )
+    {
+      rx->set_timestamps( val );
+      return;
+    }
+
+    uint64_t vita49_udp_msg_source_impl::getDropCount( void )
+    {
+      return rx->get_drop_count();
+    }
+
+    void vita49_udp_msg_source_impl::setQueueSize( int packets )
+    {
+      rx->set_queue_size( std::max( packets, 0 ) );
+      return;
+    }
+
+    uint64_t vita49_udp_msg_source_impl::getQueueDepth( void )
+    {
+      return rx->get_queue_depth();
+    }
+
+    uint64_t vita49_udp_msg_source_impl::getQueueDrops( void )
+    {
+      return rx->get_queue_drop_count();
+    }
+
+    /**
+     * Called by the receiver thread once every statistics period
+     *
+     * @param stats - statistics of every stream ID seen
+     * @param resyncs - number of times the receiver lost packet alignment
+     */
+    void vita49_udp_msg_source_impl::received_stats( const std::vector<vita_stream_stats> &stats,
+        uint64_t resyncs )
+    {
+      if( d_running )
+      {
+        message_port_pub(PMTCONSTSTR__stats(), vita49_stats_msg( stats, resyncs ));
+      }
+
+      return;
+    }
+
+    void vita49_udp_msg_source_impl::setup_rpc()
+    {
+      vita49_rx_stats<vita49_udp_msg_source>::setup_rpc();
+      setup_queue_rpc();
+    }
+
+  } /* namespace sandia_utils */
+} /* namespace gr */
@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+ * (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+ * retains certain rights in this software.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_IMPL_H
+#define INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_IMPL_H
+
+#include <gnuradio/sandia_utils/vita49_udp_msg_source.h>
+
+#include "vita49_pdu.h"
+#include"vita/vitarxudp.h"
+#include"vita/ContextPacket.h"
+
+namespace gr
+{
+  namespace sandia_utils
+  {
+
+    /**
+     * Implmenting class of VITA 49 UDP msg source
+     */
+    class vita49_udp_msg_source_impl : public vita49_rx_stats<vita49_udp_msg_source>, public vita_rx_listener
+    {
+      private:
+        vita_rx_udp *rx;
+        bool d_ignoreTime;
+        bool d_ignoreTune;
+        volatile bool d_running;
+
+    public:
+        /**
+         * Constructor
+         *
+         * @param port - UDP port to listen on
+         */
+        vita49_udp_msg_source_impl(int port);
+
+        /**
+         * Deconstructor
+         *
+         */
+        ~vita49_udp_msg_source_impl();
+
+        virtual bool start( void );
+
+        virtual bool stop( void );
+
+        /**
+         * Called when a packet is received
+         *
+         * @param type - type of packet received
+         * @param pkt - the packet received
+         */
+        virtual void received_packet( PacketType type, VRTPacket *pkt );
+
+        virtual void setIgnoreTime( bool val = false );
+        virtual bool getIgnoreTime( void );
+        virtual void setIgnoreTune( bool val = false );
+        virtual bool getIgnoreTune( void );
+        virtual void closeSocket(void);
+        virtual void setRcvBuf( int bytes );
+        virtual void setCapture( const std::string &path );
+        virtual void setHostTimestamps( bool val = false );
+        virtual uint64_t getDropCount( void );
+
+        /**
+         * Called by the receiver thread once every statistics period
+         *
+         * @param stats - statistics of every stream ID seen
+         * @param resyncs - number of times the receiver lost packet alignment
+         */
+        virtual void received_stats( const std::vector<vita_stream_stats> &stats,
+            uint64_t resyncs );
+
+        virtual void setQueueSize( int packets );
+        virtual uint64_t getQueueDepth( void );
+        virtual uint64_t getQueueDrops( void );
+
+        void setup_rpc();
+
+      protected:
+        virtual vita_rx_base *receiver()
+        {
+          return rx;
+        }
+
+    }; // end class vita49_udp_msg_source_impl
+
+  }// namespace sandia_utils
+} // namespace gr
+
+#endif /* INCLUDED_SANDIA_UTILS_VITA49_UDP_MSG_SOURCE_IMPL_H */
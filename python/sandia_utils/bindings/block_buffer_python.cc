@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(1)                                                        */
 /* BINDTOOL_HEADER_FILE(block_buffer.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(afb6f59a47bc39c354c272cda9c04e40)                     */
+/* BINDTOOL_HEADER_FILE_HASH(b1e5b1f44e87ed4d7ae96a670a7fe793)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -41,6 +41,12 @@ void bind_block_buffer(py::module& m)
              py::arg("nsamples"),
              py::arg("samp_rate"),
              py::arg("pass_data") = true,
+             py::arg("pdu_output") = false,
+             py::arg("pool_size") = 4,
+             py::arg("depth") = 3,
+             py::arg("policy") = ::gr::sandia_utils::BLOCK_LATEST,
+             py::arg("keep_every") = 1,
+             py::arg("hop") = 0,
              D(block_buffer, make))
 
 
@@ -50,6 +56,24 @@ void bind_block_buffer(py::module& m)
              D(block_buffer, set_nsamples))
 
 
+        .def("set_policy",
+             &block_buffer::set_policy,
+             py::arg("policy"),
+             py::arg("keep_every") = 1,
+             D(block_buffer, set_policy))
+
+
+        .def("get_dropped_blocks",
+             &block_buffer::get_dropped_blocks,
+             D(block_buffer, get_dropped_blocks))
+
+
+        .def("set_hop",
+             &block_buffer::set_hop,
+             py::arg("hop"),
+             D(block_buffer, set_hop))
+
+
         .def("set_pass_data",
              &block_buffer::set_pass_data,
              py::arg("pass_data"),
@@ -60,4 +84,12 @@ void bind_block_buffer(py::module& m)
             "get_pass_data", &block_buffer::get_pass_data, D(block_buffer, get_pass_data))
 
         ;
+
+    py::enum_<::gr::sandia_utils::block_policy_t>(m, "block_policy_t")
+        .value("BLOCK_LATEST", ::gr::sandia_utils::BLOCK_LATEST)       // 0
+        .value("BLOCK_FIFO", ::gr::sandia_utils::BLOCK_FIFO)           // 1
+        .value("BLOCK_EVERY_KTH", ::gr::sandia_utils::BLOCK_EVERY_KTH) // 2
+        .export_values();
+
+    py::implicitly_convertible<int, ::gr::sandia_utils::block_policy_t>();
 }
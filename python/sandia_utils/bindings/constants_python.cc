@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(constants.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(732665e6e50d836ab05b8300ab0cc7f6)                     */
+/* BINDTOOL_HEADER_FILE_HASH(9b363cc3820f0e7666222f2c42471be8)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -191,4 +191,79 @@ void bind_constants(py::module& m)
     m.def("PMTCONSTSTR__timeout",
           &::gr::sandia_utils::PMTCONSTSTR__timeout,
           D(PMTCONSTSTR__timeout));
+
+
+    m.def("PMTCONSTSTR__annotation",
+          &::gr::sandia_utils::PMTCONSTSTR__annotation,
+          D(PMTCONSTSTR__annotation));
+
+
+    m.def("PMTCONSTSTR__host_time",
+          &::gr::sandia_utils::PMTCONSTSTR__host_time,
+          D(PMTCONSTSTR__host_time));
+
+
+    m.def("PMTCONSTSTR__stats",
+          &::gr::sandia_utils::PMTCONSTSTR__stats,
+          D(PMTCONSTSTR__stats));
+
+
+    m.def("PMTCONSTSTR__resyncs",
+          &::gr::sandia_utils::PMTCONSTSTR__resyncs,
+          D(PMTCONSTSTR__resyncs));
+
+
+    m.def("PMTCONSTSTR__streams",
+          &::gr::sandia_utils::PMTCONSTSTR__streams,
+          D(PMTCONSTSTR__streams));
+
+
+    m.def("PMTCONSTSTR__packets",
+          &::gr::sandia_utils::PMTCONSTSTR__packets,
+          D(PMTCONSTSTR__packets));
+
+
+    m.def("PMTCONSTSTR__bytes",
+          &::gr::sandia_utils::PMTCONSTSTR__bytes,
+          D(PMTCONSTSTR__bytes));
+
+
+    m.def("PMTCONSTSTR__packet_rate",
+          &::gr::sandia_utils::PMTCONSTSTR__packet_rate,
+          D(PMTCONSTSTR__packet_rate));
+
+
+    m.def("PMTCONSTSTR__byte_rate",
+          &::gr::sandia_utils::PMTCONSTSTR__byte_rate,
+          D(PMTCONSTSTR__byte_rate));
+
+
+    m.def("PMTCONSTSTR__seq_gaps",
+          &::gr::sandia_utils::PMTCONSTSTR__seq_gaps,
+          D(PMTCONSTSTR__seq_gaps));
+
+
+    m.def("PMTCONSTSTR__time_discontinuities",
+          &::gr::sandia_utils::PMTCONSTSTR__time_discontinuities,
+          D(PMTCONSTSTR__time_discontinuities));
+
+
+    m.def("PMTCONSTSTR__callback_time",
+          &::gr::sandia_utils::PMTCONSTSTR__callback_time,
+          D(PMTCONSTSTR__callback_time));
+
+
+    m.def("PMTCONSTSTR__stream_id",
+          &::gr::sandia_utils::PMTCONSTSTR__stream_id,
+          D(PMTCONSTSTR__stream_id));
+
+
+    m.def("PMTCONSTSTR__context",
+          &::gr::sandia_utils::PMTCONSTSTR__context,
+          D(PMTCONSTSTR__context));
+
+
+    m.def("PMTCONSTSTR__tags",
+          &::gr::sandia_utils::PMTCONSTSTR__tags,
+          D(PMTCONSTSTR__tags));
 }
@@ -30,6 +30,15 @@ static const char* __doc_gr_sandia_utils_block_buffer_make = R"doc()doc";
 static const char* __doc_gr_sandia_utils_block_buffer_set_nsamples = R"doc()doc";
 
 
+static const char* __doc_gr_sandia_utils_block_buffer_set_policy = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_block_buffer_get_dropped_blocks = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_block_buffer_set_hop = R"doc()doc";
+
+
 static const char* __doc_gr_sandia_utils_block_buffer_set_pass_data = R"doc()doc";
 
 
@@ -109,3 +109,48 @@ static const char* __doc_gr_sandia_utils_PMTCONSTSTR__tune_request = R"doc()doc"
 
 
 static const char* __doc_gr_sandia_utils_PMTCONSTSTR__timeout = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__annotation = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__host_time = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__stats = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__resyncs = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__streams = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__packets = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__bytes = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__packet_rate = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__byte_rate = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__seq_gaps = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__time_discontinuities = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__callback_time = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__stream_id = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__context = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_PMTCONSTSTR__tags = R"doc()doc";
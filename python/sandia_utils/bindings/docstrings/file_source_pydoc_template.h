@@ -33,6 +33,9 @@ static const char* __doc_gr_sandia_utils_file_source_seek = R"doc()doc";
 static const char* __doc_gr_sandia_utils_file_source_open = R"doc()doc";
 
 
+static const char* __doc_gr_sandia_utils_file_source_open_playlist = R"doc()doc";
+
+
 static const char* __doc_gr_sandia_utils_file_source_close = R"doc()doc";
 
 
@@ -46,3 +49,27 @@ static const char* __doc_gr_sandia_utils_file_source_add_file_tags = R"doc()doc"
 
 
 static const char* __doc_gr_sandia_utils_file_source_set_msg_hop_period = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_set_disk_type = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_set_cache_size = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_set_stride = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_set_stride_period = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_set_msg_pacing = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_seek_msg = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_seek_msg_time = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_file_source_msg_count = R"doc()doc";
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, sandia_utils, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_vita49_sink_0 = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_vita49_sink_1 = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_make = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_getPacketCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_getByteCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_sink_getDropCount = R"doc()doc";
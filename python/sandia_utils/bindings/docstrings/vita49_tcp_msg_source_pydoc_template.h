@@ -46,3 +46,42 @@ static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getIgnoreTune =
 
 
 static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_closeSocket = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_setRcvBuf = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_setCapture = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_setStatsPeriod = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getStats = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getPacketCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getByteCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getSeqGaps = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getResyncCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getTimeDiscontinuities = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getCallbackTime = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_setQueueSize = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getQueueDepth = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_tcp_msg_source_getQueueDrops = R"doc()doc";
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr, sandia_utils, __VA_ARGS__)
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_vita49_udp_msg_source_0 = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_vita49_udp_msg_source_1 = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_make = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setIgnoreTime = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getIgnoreTime = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setIgnoreTune = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getIgnoreTune = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_closeSocket = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setRcvBuf = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setCapture = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setHostTimestamps = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getDropCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setStatsPeriod = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getStats = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getPacketCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getByteCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getSeqGaps = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getResyncCount = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getTimeDiscontinuities = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getCallbackTime = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_setQueueSize = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getQueueDepth = R"doc()doc";
+
+
+static const char* __doc_gr_sandia_utils_vita49_udp_msg_source_getQueueDrops = R"doc()doc";
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(1)                                                        */
 /* BINDTOOL_HEADER_FILE(file_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(7fdc6351c4af454784930fbd7e7de3af)                     */
+/* BINDTOOL_HEADER_FILE_HASH(f8d2e88a25ad2cc5528fe076f93e96a0)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -62,6 +62,13 @@ void bind_file_source(py::module& m)
              D(file_source, open))
 
 
+        .def("open_playlist",
+             &file_source::open_playlist,
+             py::arg("pattern"),
+             py::arg("sort_by") = "name",
+             D(file_source, open_playlist))
+
+
         .def("close", &file_source::close, D(file_source, close))
 
 
@@ -88,5 +95,51 @@ void bind_file_source(py::module& m)
              py::arg("period_ms"),
              D(file_source, set_msg_hop_period))
 
+
+        .def("set_disk_type",
+             &file_source::set_disk_type,
+             py::arg("type"),
+             py::arg("scale") = 0.0,
+             D(file_source, set_disk_type))
+
+
+        .def("set_cache_size",
+             &file_source::set_cache_size,
+             py::arg("max_bytes"),
+             py::arg("hugepages") = false,
+             D(file_source, set_cache_size))
+
+
+        .def("set_stride",
+             &file_source::set_stride,
+             py::arg("keep"),
+             py::arg("stride"),
+             D(file_source, set_stride))
+
+
+        .def("set_stride_period",
+             &file_source::set_stride_period,
+             py::arg("keep"),
+             py::arg("period"),
+             D(file_source, set_stride_period))
+
+
+        .def("set_msg_pacing",
+             &file_source::set_msg_pacing,
+             py::arg("mode"),
+             D(file_source, set_msg_pacing))
+
+
+        .def("seek_msg", &file_source::seek_msg, py::arg("n"), D(file_source, seek_msg))
+
+
+        .def("seek_msg_time",
+             &file_source::seek_msg_time,
+             py::arg("time"),
+             D(file_source, seek_msg_time))
+
+
+        .def("msg_count", &file_source::msg_count, D(file_source, msg_count))
+
         ;
 }
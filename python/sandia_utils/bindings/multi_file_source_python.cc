@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
+/* BINDTOOL_USE_PYGCCXML(1)                                                        */
+/* BINDTOOL_HEADER_FILE(multi_file_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(a1b60e54ec99073777eb21f139f3e7e6)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/sandia_utils/multi_file_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <multi_file_source_pydoc.h>
+
+void bind_multi_file_source(py::module& m)
+{
+
+    using multi_file_source = ::gr::sandia_utils::multi_file_source;
+
+
+    py::class_<multi_file_source,
+               gr::sync_block,
+               gr::block,
+               gr::basic_block,
+               std::shared_ptr<multi_file_source>>(
+        m, "multi_file_source", D(multi_file_source))
+
+        .def(py::init(&multi_file_source::make),
+             py::arg("itemsize"),
+             py::arg("filenames"),
+             py::arg("type"),
+             py::arg("align") = true,
+             py::arg("repeat") = false,
+             D(multi_file_source, make))
+
+
+        .def("trimmed",
+             &multi_file_source::trimmed,
+             py::arg("chan"),
+             D(multi_file_source, trimmed))
+
+
+        .def("nitems", &multi_file_source::nitems, D(multi_file_source, nitems))
+
+        ;
+}
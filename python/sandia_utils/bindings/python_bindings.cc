@@ -35,6 +35,10 @@ void bind_stream_gate(py::module& m);
 void bind_tag_debug_file(py::module& m);
 void bind_tagged_bits_to_bytes(py::module& m);
 void bind_vita49_tcp_msg_source(py::module& m);
+void bind_multi_file_source(py::module& m);
+void bind_vita49_udp_msg_source(py::module& m);
+void bind_vita49_stream_source(py::module& m);
+void bind_vita49_sink(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -77,5 +81,9 @@ PYBIND11_MODULE(sandia_utils_python, m)
     bind_tag_debug_file(m);
     bind_tagged_bits_to_bytes(m);
     bind_vita49_tcp_msg_source(m);
+    bind_multi_file_source(m);
+    bind_vita49_udp_msg_source(m);
+    bind_vita49_stream_source(m);
+    bind_vita49_sink(m);
     // ) END BINDING_FUNCTION_CALLS
 }
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
+/* BINDTOOL_USE_PYGCCXML(1)                                                        */
+/* BINDTOOL_HEADER_FILE(vita49_sink.h)                                             */
+/* BINDTOOL_HEADER_FILE_HASH(62680b358762948fe60669f0e71d1fb6)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/sandia_utils/vita49_sink.h>
+// pydoc.h is automatically generated in the build directory
+#include <vita49_sink_pydoc.h>
+
+void bind_vita49_sink(py::module& m)
+{
+
+    using vita49_sink = ::gr::sandia_utils::vita49_sink;
+
+
+    py::class_<vita49_sink,
+               gr::sync_block,
+               gr::block,
+               gr::basic_block,
+               std::shared_ptr<vita49_sink>>(m, "vita49_sink", D(vita49_sink))
+
+        .def(py::init(&vita49_sink::make),
+             py::arg("host"),
+             py::arg("port"),
+             py::arg("transport") = "udp",
+             py::arg("type") = "fc32",
+             py::arg("payload") = "sc16",
+             py::arg("samples_per_packet") = 360,
+             py::arg("stream_id") = 0,
+             py::arg("scale") = 32768.0,
+             D(vita49_sink, make))
+
+
+        .def("getPacketCount",
+             &vita49_sink::getPacketCount,
+             D(vita49_sink, getPacketCount))
+
+
+        .def("getByteCount", &vita49_sink::getByteCount, D(vita49_sink, getByteCount))
+
+
+        .def("getDropCount", &vita49_sink::getDropCount, D(vita49_sink, getDropCount))
+
+        ;
+}
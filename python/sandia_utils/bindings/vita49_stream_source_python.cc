@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
+/* BINDTOOL_USE_PYGCCXML(1)                                                        */
+/* BINDTOOL_HEADER_FILE(vita49_stream_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(34788dd96219373693903654fb55b9e4)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/sandia_utils/vita49_stream_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <vita49_stream_source_pydoc.h>
+
+void bind_vita49_stream_source(py::module& m)
+{
+
+    using vita49_stream_source = ::gr::sandia_utils::vita49_stream_source;
+
+
+    py::class_<vita49_stream_source,
+               gr::sync_block,
+               gr::block,
+               gr::basic_block,
+               std::shared_ptr<vita49_stream_source>>(
+        m, "vita49_stream_source", D(vita49_stream_source))
+
+        .def(py::init(&vita49_stream_source::make),
+             py::arg("port"),
+             py::arg("transport") = "tcp",
+             py::arg("type") = "fc32",
+             py::arg("scale") = 32768.0,
+             py::arg("payload") = "sc16",
+             D(vita49_stream_source, make))
+
+
+        .def("setRcvBuf",
+             &vita49_stream_source::setRcvBuf,
+             py::arg("bytes"),
+             D(vita49_stream_source, setRcvBuf))
+
+
+        .def("getOverflowCount",
+             &vita49_stream_source::getOverflowCount,
+             D(vita49_stream_source, getOverflowCount))
+
+
+        .def("setStatsPeriod",
+             &vita49_stream_source::setStatsPeriod,
+             py::arg("seconds"),
+             D(vita49_stream_source, setStatsPeriod))
+
+
+        .def("getStats",
+             &vita49_stream_source::getStats,
+             D(vita49_stream_source, getStats))
+
+
+        .def("getPacketCount",
+             &vita49_stream_source::getPacketCount,
+             D(vita49_stream_source, getPacketCount))
+
+
+        .def("getByteCount",
+             &vita49_stream_source::getByteCount,
+             D(vita49_stream_source, getByteCount))
+
+
+        .def("getSeqGaps",
+             &vita49_stream_source::getSeqGaps,
+             D(vita49_stream_source, getSeqGaps))
+
+
+        .def("getResyncCount",
+             &vita49_stream_source::getResyncCount,
+             D(vita49_stream_source, getResyncCount))
+
+
+        .def("getTimeDiscontinuities",
+             &vita49_stream_source::getTimeDiscontinuities,
+             D(vita49_stream_source, getTimeDiscontinuities))
+
+
+        .def("getCallbackTime",
+             &vita49_stream_source::getCallbackTime,
+             D(vita49_stream_source, getCallbackTime))
+
+        ;
+}
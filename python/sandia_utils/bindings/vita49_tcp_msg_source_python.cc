@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(1)                                                        */
 /* BINDTOOL_HEADER_FILE(vita49_tcp_msg_source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(ab18a598d17112d21df619d014df21a4)                     */
+/* BINDTOOL_HEADER_FILE_HASH(db39abe5c82f33a68eaf7b00aee46683)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -42,6 +42,8 @@ void bind_vita49_tcp_msg_source(py::module& m)
         .def(py::init(&vita49_tcp_msg_source::make),
              py::arg("port"),
              py::arg("socket_always_on") = false,
+             py::arg("stream_ids") = std::vector<uint32_t>(),
+             py::arg("num_streams") = 0,
              D(vita49_tcp_msg_source, make))
 
 
@@ -71,5 +73,74 @@ void bind_vita49_tcp_msg_source(py::module& m)
              &vita49_tcp_msg_source::closeSocket,
              D(vita49_tcp_msg_source, closeSocket))
 
+
+        .def("setRcvBuf",
+             &vita49_tcp_msg_source::setRcvBuf,
+             py::arg("bytes"),
+             D(vita49_tcp_msg_source, setRcvBuf))
+
+
+        .def("setCapture",
+             &vita49_tcp_msg_source::setCapture,
+             py::arg("path"),
+             D(vita49_tcp_msg_source, setCapture))
+
+
+        .def("setStatsPeriod",
+             &vita49_tcp_msg_source::setStatsPeriod,
+             py::arg("seconds"),
+             D(vita49_tcp_msg_source, setStatsPeriod))
+
+
+        .def("getStats",
+             &vita49_tcp_msg_source::getStats,
+             D(vita49_tcp_msg_source, getStats))
+
+
+        .def("getPacketCount",
+             &vita49_tcp_msg_source::getPacketCount,
+             D(vita49_tcp_msg_source, getPacketCount))
+
+
+        .def("getByteCount",
+             &vita49_tcp_msg_source::getByteCount,
+             D(vita49_tcp_msg_source, getByteCount))
+
+
+        .def("getSeqGaps",
+             &vita49_tcp_msg_source::getSeqGaps,
+             D(vita49_tcp_msg_source, getSeqGaps))
+
+
+        .def("getResyncCount",
+             &vita49_tcp_msg_source::getResyncCount,
+             D(vita49_tcp_msg_source, getResyncCount))
+
+
+        .def("getTimeDiscontinuities",
+             &vita49_tcp_msg_source::getTimeDiscontinuities,
+             D(vita49_tcp_msg_source, getTimeDiscontinuities))
+
+
+        .def("getCallbackTime",
+             &vita49_tcp_msg_source::getCallbackTime,
+             D(vita49_tcp_msg_source, getCallbackTime))
+
+
+        .def("setQueueSize",
+             &vita49_tcp_msg_source::setQueueSize,
+             py::arg("packets"),
+             D(vita49_tcp_msg_source, setQueueSize))
+
+
+        .def("getQueueDepth",
+             &vita49_tcp_msg_source::getQueueDepth,
+             D(vita49_tcp_msg_source, getQueueDepth))
+
+
+        .def("getQueueDrops",
+             &vita49_tcp_msg_source::getQueueDrops,
+             D(vita49_tcp_msg_source, getQueueDrops))
+
         ;
 }
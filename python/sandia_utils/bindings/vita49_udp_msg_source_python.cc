@@ -0,0 +1,154 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
+/* BINDTOOL_USE_PYGCCXML(1)                                                        */
+/* BINDTOOL_HEADER_FILE(vita49_udp_msg_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(4d17d36c2aaed0c4b3a12e8ec380d377)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/sandia_utils/vita49_udp_msg_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <vita49_udp_msg_source_pydoc.h>
+
+void bind_vita49_udp_msg_source(py::module& m)
+{
+
+    using vita49_udp_msg_source = ::gr::sandia_utils::vita49_udp_msg_source;
+
+
+    py::class_<vita49_udp_msg_source,
+               gr::block,
+               gr::basic_block,
+               std::shared_ptr<vita49_udp_msg_source>>(
+        m, "vita49_udp_msg_source", D(vita49_udp_msg_source))
+
+        .def(py::init(&vita49_udp_msg_source::make),
+             py::arg("port"),
+             D(vita49_udp_msg_source, make))
+
+
+        .def("setIgnoreTime",
+             &vita49_udp_msg_source::setIgnoreTime,
+             py::arg("val") = false,
+             D(vita49_udp_msg_source, setIgnoreTime))
+
+
+        .def("getIgnoreTime",
+             &vita49_udp_msg_source::getIgnoreTime,
+             D(vita49_udp_msg_source, getIgnoreTime))
+
+
+        .def("setIgnoreTune",
+             &vita49_udp_msg_source::setIgnoreTune,
+             py::arg("val") = false,
+             D(vita49_udp_msg_source, setIgnoreTune))
+
+
+        .def("getIgnoreTune",
+             &vita49_udp_msg_source::getIgnoreTune,
+             D(vita49_udp_msg_source, getIgnoreTune))
+
+
+        .def("closeSocket",
+             &vita49_udp_msg_source::closeSocket,
+             D(vita49_udp_msg_source, closeSocket))
+
+
+        .def("setRcvBuf",
+             &vita49_udp_msg_source::setRcvBuf,
+             py::arg("bytes"),
+             D(vita49_udp_msg_source, setRcvBuf))
+
+
+        .def("setCapture",
+             &vita49_udp_msg_source::setCapture,
+             py::arg("path"),
+             D(vita49_udp_msg_source, setCapture))
+
+
+        .def("setHostTimestamps",
+             &vita49_udp_msg_source::setHostTimestamps,
+             py::arg("val") = false,
+             D(vita49_udp_msg_source, setHostTimestamps))
+
+
+        .def("getDropCount",
+             &vita49_udp_msg_source::getDropCount,
+             D(vita49_udp_msg_source, getDropCount))
+
+
+        .def("setStatsPeriod",
+             &vita49_udp_msg_source::setStatsPeriod,
+             py::arg("seconds"),
+             D(vita49_udp_msg_source, setStatsPeriod))
+
+
+        .def("getStats",
+             &vita49_udp_msg_source::getStats,
+             D(vita49_udp_msg_source, getStats))
+
+
+        .def("getPacketCount",
+             &vita49_udp_msg_source::getPacketCount,
+             D(vita49_udp_msg_source, getPacketCount))
+
+
+        .def("getByteCount",
+             &vita49_udp_msg_source::getByteCount,
+             D(vita49_udp_msg_source, getByteCount))
+
+
+        .def("getSeqGaps",
+             &vita49_udp_msg_source::getSeqGaps,
+             D(vita49_udp_msg_source, getSeqGaps))
+
+
+        .def("getResyncCount",
+             &vita49_udp_msg_source::getResyncCount,
+             D(vita49_udp_msg_source, getResyncCount))
+
+
+        .def("getTimeDiscontinuities",
+             &vita49_udp_msg_source::getTimeDiscontinuities,
+             D(vita49_udp_msg_source, getTimeDiscontinuities))
+
+
+        .def("getCallbackTime",
+             &vita49_udp_msg_source::getCallbackTime,
+             D(vita49_udp_msg_source, getCallbackTime))
+
+
+        .def("setQueueSize",
+             &vita49_udp_msg_source::setQueueSize,
+             py::arg("packets"),
+             D(vita49_udp_msg_source, setQueueSize))
+
+
+        .def("getQueueDepth",
+             &vita49_udp_msg_source::getQueueDepth,
+             D(vita49_udp_msg_source, getQueueDepth))
+
+
+        .def("getQueueDrops",
+             &vita49_udp_msg_source::getQueueDrops,
+             D(vita49_udp_msg_source, getQueueDrops))
+
+        ;
+}
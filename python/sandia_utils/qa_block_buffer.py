@@ -9,6 +9,7 @@
 #
 
 import time
+import pmt
 from gnuradio import gr, gr_unittest
 from gnuradio import blocks, analog
 try:
@@ -77,6 +78,186 @@ class qa_block_buffer(gr_unittest.TestCase):
         self.tb.stop()
         self.tb.wait()
 
+    def test_2_pdu(self):
+        '''
+        Blocks published as pooled PDUs, with time and tags in the metadata
+        '''
+        data = [complex(i, -i) for i in range(1000)]
+        tags = [gr.tag_utils.python_to_tag((0, pmt.intern("rx_time"),
+                                            pmt.make_tuple(pmt.from_uint64(5),
+                                                           pmt.from_double(0.25)))),
+                gr.tag_utils.python_to_tag((150, pmt.intern("foo"), pmt.from_long(7)))]
+        source = blocks.vector_source_c(data, False, 1, tags)
+        block_buffer = sandia_utils.block_buffer(gr.sizeof_gr_complex, 100, 1000, True,
+                                                 True, 4)
+        message_debug = blocks.message_debug()
+        self.tb.connect(source, block_buffer)
+        self.tb.msg_connect((block_buffer, 'pdu_out'), (message_debug, 'store'))
+        self.tb.run()
+
+        # the stored PDUs hold every pooled vector, later samples are skipped
+        self.assertEqual(4, message_debug.num_messages())
+        for i in range(4):
+            pdu = message_debug.get_message(i)
+            meta = pmt.car(pdu)
+            self.assertEqual(data[100 * i:100 * (i + 1)],
+                             list(pmt.c32vector_elements(pmt.cdr(pdu))))
+            self.assertEqual(0, pmt.to_uint64(pmt.dict_ref(meta, pmt.intern("BLOCK"),
+                                                           pmt.PMT_NIL)))
+            rx_time = pmt.dict_ref(meta, pmt.intern("rx_time"), pmt.PMT_NIL)
+            self.assertEqual(5, pmt.to_uint64(pmt.tuple_ref(rx_time, 0)))
+            self.assertAlmostEqual(0.25 + 0.1 * i, pmt.to_double(pmt.tuple_ref(rx_time, 1)))
+
+        meta = pmt.car(message_debug.get_message(1))
+        tags = pmt.dict_ref(meta, pmt.intern("tags"), pmt.PMT_NIL)
+        self.assertEqual(1, pmt.length(tags))
+        tag = pmt.vector_ref(tags, 0)
+        self.assertEqual(50, pmt.to_uint64(pmt.tuple_ref(tag, 0)))
+        self.assertEqual("foo", pmt.symbol_to_string(pmt.tuple_ref(tag, 1)))
+
+    def test_3_every_kth(self):
+        '''
+        Every third block kept, the others counted as dropped and skipped
+        '''
+        data = [float(i) for i in range(1000)]
+        source = blocks.vector_source_f(data)
+        block_buffer = sandia_utils.block_buffer(gr.sizeof_float, 100, 1000, True, True, 10,
+                                                 3, sandia_utils.BLOCK_EVERY_KTH, 3)
+        message_debug = blocks.message_debug()
+        self.tb.connect(source, block_buffer)
+        self.tb.msg_connect((block_buffer, 'pdu_out'), (message_debug, 'store'))
+        self.tb.run()
+
+        self.assertEqual(4, message_debug.num_messages())
+        self.assertEqual(6, block_buffer.get_dropped_blocks())
+        for i in range(4):
+            pdu = message_debug.get_message(i)
+            self.assertEqual(data[300 * i:300 * i + 100], list(pmt.f32vector_elements(pmt.cdr(pdu))))
+            skipped = pmt.to_uint64(pmt.dict_ref(pmt.car(pdu), pmt.intern("BLOCK"), pmt.PMT_NIL))
+            self.assertEqual(0 if i == 0 else 200, skipped)
+
+    def run_stream(self, depth, policy):
+        '''
+        Runs 20 blocks of 100 samples through a stream output ring. The
+        whole input arrives in one call before any block is written out,
+        as it does when the consumer has fallen behind, so the ring fills
+        and the policy decides which blocks are kept
+        '''
+        data = [float(i) for i in range(2000)]
+        tags = [gr.tag_utils.python_to_tag((0, pmt.intern("rx_time"),
+                                            pmt.make_tuple(pmt.from_uint64(5),
+                                                           pmt.from_double(0.25))))]
+        source = blocks.vector_source_f(data, False, 1, tags)
+        block_buffer = sandia_utils.block_buffer(gr.sizeof_float, 100, 1000, True, False, 4,
+                                                 depth, policy)
+        # bounds the samples written per call, and with it the space work()
+        # keeps in reserve
+        block_buffer.set_max_noutput_items(1000)
+        sink = blocks.vector_sink_f()
+        self.tb.connect(source, block_buffer, sink)
+        self.tb.run()
+
+        block_tags = [(t.offset, pmt.to_uint64(t.value)) for t in sink.tags()
+                      if pmt.symbol_to_string(t.key) == 'BLOCK']
+        time_tags = [(t.offset, pmt.to_uint64(pmt.tuple_ref(t.value, 0)),
+                      pmt.to_double(pmt.tuple_ref(t.value, 1))) for t in sink.tags()
+                     if pmt.symbol_to_string(t.key) == 'rx_time']
+        return data, block_buffer, sink, block_tags, time_tags
+
+    def test_4_fifo(self):
+        '''
+        FIFO keeps the oldest blocks in order until the ring is full, then
+        drops new ones
+        '''
+        data, block_buffer, sink, block_tags, time_tags = \
+            self.run_stream(5, sandia_utils.BLOCK_FIFO)
+
+        # one block written out and three waiting, the rest dropped
+        self.assertFloatTuplesAlmostEqual(data[:400], sink.data())
+        self.assertEqual(16, block_buffer.get_dropped_blocks())
+        self.assertEqual([(0, 0), (100, 0), (200, 0), (300, 0)], block_tags)
+        self.assertEqual(1, len(time_tags))
+        self.assertEqual(0, time_tags[0][0])
+
+    def test_5_latest(self):
+        '''
+        LATEST drops the oldest waiting block to make room, the skip is
+        reported in the BLOCK tag with an estimated rx_time
+        '''
+        data, block_buffer, sink, block_tags, time_tags = \
+            self.run_stream(4, sandia_utils.BLOCK_LATEST)
+
+        # the first block is written out, the last two were waiting
+        self.assertFloatTuplesAlmostEqual(data[:100] + data[1800:], sink.data())
+        self.assertEqual(17, block_buffer.get_dropped_blocks())
+        self.assertEqual([(0, 0), (100, 1700), (200, 0)], block_tags)
+        self.assertEqual(2, len(time_tags))
+        self.assertEqual((0, 5), time_tags[0][:2])
+        self.assertAlmostEqual(0.25, time_tags[0][2])
+        self.assertEqual((100, 7), time_tags[1][:2])
+        self.assertAlmostEqual(0.05, time_tags[1][2])
+
+    def test_6_hop(self):
+        '''
+        Overlapping blocks, each starting half a block after the last
+        '''
+        data = [float(i) for i in range(300)]
+        source = blocks.vector_source_f(data)
+        block_buffer = sandia_utils.block_buffer(gr.sizeof_float, 100, 1000, True, True, 10,
+                                                 3, sandia_utils.BLOCK_LATEST, 1, 50)
+        message_debug = blocks.message_debug()
+        self.tb.connect(source, block_buffer)
+        self.tb.msg_connect((block_buffer, 'pdu_out'), (message_debug, 'store'))
+        self.tb.run()
+
+        self.assertEqual(5, message_debug.num_messages())
+        self.assertEqual(0, block_buffer.get_dropped_blocks())
+        for i in range(5):
+            pdu = message_debug.get_message(i)
+            self.assertEqual(data[50 * i:50 * i + 100], list(pmt.f32vector_elements(pmt.cdr(pdu))))
+            skipped = pmt.to_uint64(pmt.dict_ref(pmt.car(pdu), pmt.intern("BLOCK"), pmt.PMT_NIL))
+            self.assertEqual(0, skipped)
+
+    def test_7_hop_stream(self):
+        '''
+        Overlapping blocks on the stream output, the carried samples and
+        tags are written out again with each window
+        '''
+        data = [float(i) for i in range(300)]
+        tags = [gr.tag_utils.python_to_tag((0, pmt.intern("rx_time"),
+                                            pmt.make_tuple(pmt.from_uint64(5),
+                                                           pmt.from_double(0.25)))),
+                gr.tag_utils.python_to_tag((120, pmt.intern("foo"), pmt.from_long(7)))]
+        source = blocks.vector_source_f(data, False, 1, tags)
+        block_buffer = sandia_utils.block_buffer(gr.sizeof_float, 100, 1000, True, False, 4,
+                                                 8, sandia_utils.BLOCK_LATEST, 1, 50)
+        block_buffer.set_max_noutput_items(1000)
+        sink = blocks.vector_sink_f()
+        self.tb.connect(source, block_buffer, sink)
+        self.tb.run()
+
+        expected = []
+        for i in range(5):
+            expected += data[50 * i:50 * i + 100]
+        self.assertFloatTuplesAlmostEqual(expected, sink.data())
+        self.assertEqual(0, block_buffer.get_dropped_blocks())
+
+        out_tags = sink.tags()
+        block_tags = [(t.offset, pmt.to_uint64(t.value)) for t in out_tags
+                      if pmt.symbol_to_string(t.key) == 'BLOCK']
+        self.assertEqual([(100 * i, 0) for i in range(5)], block_tags)
+
+        # every window has its own rx_time, one hop later than the last
+        time_tags = [t for t in out_tags if pmt.symbol_to_string(t.key) == 'rx_time']
+        self.assertEqual([100 * i for i in range(5)], [t.offset for t in time_tags])
+        for i, tag in enumerate(time_tags):
+            self.assertEqual(5, pmt.to_uint64(pmt.tuple_ref(tag.value, 0)))
+            self.assertAlmostEqual(0.25 + 0.05 * i, pmt.to_double(pmt.tuple_ref(tag.value, 1)))
+
+        # the tag at input 120 is in the windows starting at 50 and 100
+        foo_tags = [t.offset for t in out_tags if pmt.symbol_to_string(t.key) == 'foo']
+        self.assertEqual([170, 220], foo_tags)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_block_buffer, "qa_block_buffer.xml")
@@ -65,6 +65,21 @@ class qa_constants (gr_unittest.TestCase):
         assert(pmt.eq(sandia_utils.PMTCONSTSTR__tune_request(), pmt.intern("tune_request")))
         assert(pmt.eq(sandia_utils.PMTCONSTSTR__publish(), pmt.intern("publish")))
         assert(pmt.eq(sandia_utils.PMTCONSTSTR__timeout(), pmt.intern("timeout")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__annotation(), pmt.intern("annotation")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__host_time(), pmt.intern("host_time")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__stats(), pmt.intern("stats")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__resyncs(), pmt.intern("resyncs")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__streams(), pmt.intern("streams")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__packets(), pmt.intern("packets")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__bytes(), pmt.intern("bytes")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__packet_rate(), pmt.intern("packet_rate")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__byte_rate(), pmt.intern("byte_rate")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__seq_gaps(), pmt.intern("seq_gaps")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__time_discontinuities(), pmt.intern("time_discontinuities")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__callback_time(), pmt.intern("callback_time")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__stream_id(), pmt.intern("stream_id")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__context(), pmt.intern("context")))
+        assert(pmt.eq(sandia_utils.PMTCONSTSTR__tags(), pmt.intern("tags")))
 
 
 if __name__ == '__main__':
@@ -20,6 +20,13 @@ except ImportError:
     from gnuradio import sandia_utils
 
 from gnuradio import pdu_utils
+import json
+import numpy as np
+import os
+import pmt
+import shutil
+import struct
+import tempfile
 import time
 
 
@@ -33,6 +40,18 @@ class qa_file_source(gr_unittest.TestCase):
     def tearDown(self):
         self.tb = None
 
+    def write_raw_header(self, fname, freq, rate, start_time, data):
+        with open(fname, 'wb') as f:
+            np.array([freq, rate, start_time], dtype=np.float64).tofile(f)
+            np.array(data, dtype=np.complex64).tofile(f)
+
+    def write_messages(self, fname, msgs):
+        with open(fname, 'wb') as f:
+            for msg in msgs:
+                st = pmt.serialize_str(msg)
+                f.write(struct.pack('=I', len(st)))
+                f.write(st)
+
     def test_001_instantiation(self):
 
         dut = sandia_utils.file_source(gr.sizeof_gr_complex * 1, '/dev/null', 'message', False, False)
@@ -45,6 +64,342 @@ class qa_file_source(gr_unittest.TestCase):
 
         self.assertTrue(True)
 
+    def test_002_playlist(self):
+        '''
+        Files are played back to back in name order with file tags only
+        where the header time jumps
+        '''
+        tmpdir = tempfile.mkdtemp()
+        rate = 1000.0
+        nsamples = 100
+        # first three files are contiguous in time, the fourth has a gap
+        times = [10.0, 10.1, 10.2, 20.0]
+        expected = []
+        for i, t in enumerate(times):
+            data = np.arange(nsamples) + i * nsamples
+            self.write_raw_header(os.path.join(tmpdir, 'capture_%02d.dat' % i),
+                                  915e6, rate, t, data)
+            expected.extend(data)
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, '', 'raw_header', False, False)
+        dut.open_playlist(os.path.join(tmpdir, 'capture_*.dat'), 'name')
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, sink)
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertComplexTuplesAlmostEqual(expected, sink.data())
+        offsets = [tag.offset for tag in sink.tags()
+                   if pmt.eq(tag.key, pmt.intern('rx_time'))]
+        self.assertEqual([0, 3 * nsamples], offsets)
+
+        shutil.rmtree(tmpdir)
+
+    def test_003_playlist_time_order(self):
+        '''
+        Playlist can be ordered by header time instead of file name
+        '''
+        tmpdir = tempfile.mkdtemp()
+        self.write_raw_header(os.path.join(tmpdir, 'a.dat'), 0, 1000.0, 5.0, [2, 2])
+        self.write_raw_header(os.path.join(tmpdir, 'b.dat'), 0, 1000.0, 1.0, [1, 1])
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, '', 'raw_header', False, False)
+        dut.open_playlist(tmpdir, 'time')
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, sink)
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertComplexTuplesAlmostEqual([1, 1, 2, 2], sink.data())
+
+        shutil.rmtree(tmpdir)
+
+
+    def test_004_message_burst_seek(self):
+        '''
+        Message files replay without a delay in burst mode and can be
+        indexed to seek by message number and time
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'msgs.dat')
+        nmsgs = 2000
+        msgs = []
+        for i in range(nmsgs):
+            meta = pmt.dict_add(pmt.make_dict(), pmt.intern('rx_time'),
+                                pmt.make_tuple(pmt.from_uint64(100 + i), pmt.from_double(0.0)))
+            msgs.append(pmt.cons(meta, pmt.init_u8vector(1, [i % 256])))
+        self.write_messages(fname, msgs)
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, fname, 'message', False, False)
+        dut.set_msg_pacing('burst')
+        self.assertEqual(nmsgs, dut.msg_count())
+        self.assertFalse(dut.seek_msg(nmsgs))
+        self.assertTrue(dut.seek_msg_time(100 + 500.5))
+        self.tb.msg_connect((dut, 'out'), (self.debug, 'store'))
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        # first message after the seek time
+        self.assertEqual(nmsgs - 501, self.debug.num_messages())
+        meta = pmt.car(self.debug.get_message(0))
+        rx_time = pmt.dict_ref(meta, pmt.intern('rx_time'), pmt.PMT_NIL)
+        self.assertEqual(601, pmt.to_uint64(pmt.tuple_ref(rx_time, 0)))
+
+        shutil.rmtree(tmpdir)
+
+
+    def test_005_disk_type(self):
+        '''
+        sc16 files are converted to complex float while reading
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'sc16.dat')
+        data = np.array([0, 16384, -32768, 8192, 100, -100], dtype=np.int16)
+        data.tofile(fname)
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, '', 'raw', False, False)
+        dut.set_disk_type('sc16', 32768.0)
+        dut.open(fname, False)
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, sink)
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        expected = (data[0::2] + 1j * data[1::2]) / 32768.0
+        self.assertComplexTuplesAlmostEqual(expected, sink.data(), 6)
+
+        shutil.rmtree(tmpdir)
+
+
+    def test_006_cached_repeat(self):
+        '''
+        Repeated small files are served from memory
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'vector.dat')
+        data = np.arange(10, dtype=np.complex64)
+        data.tofile(fname)
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, '', 'raw', True, False)
+        dut.set_cache_size(1024 * 1024)
+        dut.set_begin_tag(pmt.intern('pass'))
+        dut.open(fname, True)
+        head = blocks.head(gr.sizeof_gr_complex, 1000)
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, head, sink)
+        self.tb.run()
+
+        self.assertComplexTuplesAlmostEqual(np.tile(data, 100), sink.data())
+        tags = [t for t in sink.tags() if pmt.eq(t.key, pmt.intern('pass'))]
+        self.assertEqual([0], [t.offset for t in tags])
+        self.assertEqual(0, pmt.to_long(tags[0].value))
+
+        shutil.rmtree(tmpdir)
+
+
+    def test_007_sigmf(self):
+        '''
+        SigMF captures and annotations become tags at their sample index
+        '''
+        tmpdir = tempfile.mkdtemp()
+        base = os.path.join(tmpdir, 'recording')
+        data = np.arange(200, dtype=np.int16)
+        data.tofile(base + '.sigmf-data')
+        meta = {
+            'global': {'core:datatype': 'ci16_le', 'core:sample_rate': 1e6,
+                       'core:version': '1.0.0'},
+            'captures': [
+                {'core:sample_start': 0, 'core:frequency': 915e6,
+                 'core:datetime': '2020-01-01T00:00:01.5Z'},
+                {'core:sample_start': 60, 'core:frequency': 920e6}],
+            'annotations': [
+                {'core:sample_start': 25, 'core:sample_count': 10,
+                 'core:label': 'burst'},
+                {'core:sample_start': 80, 'core:sample_count': 5}]}
+        with open(base + '.sigmf-meta', 'w') as f:
+            json.dump(meta, f)
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, base + '.sigmf-data', 'sigmf',
+                                       False, False)
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, sink)
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        # ci16 recordings are converted to complex float
+        self.assertComplexTuplesAlmostEqual(data[0::2] + 1j * data[1::2], sink.data())
+
+        tags = {}
+        for tag in sink.tags():
+            tags.setdefault(pmt.symbol_to_string(tag.key), []).append(tag)
+        self.assertEqual([0, 60], [t.offset for t in tags['rx_freq']])
+        self.assertAlmostEqual(920e6, pmt.to_double(tags['rx_freq'][1].value))
+        self.assertEqual([0], [t.offset for t in tags['rate']])
+        self.assertEqual(1577836801, pmt.to_uint64(pmt.tuple_ref(tags['rx_time'][0].value, 0)))
+        self.assertEqual([25, 80], [t.offset for t in tags['annotation']])
+        label = pmt.dict_ref(tags['annotation'][0].value, pmt.intern('core:label'), pmt.PMT_NIL)
+        self.assertEqual('burst', pmt.symbol_to_string(label))
+
+        shutil.rmtree(tmpdir)
+
+
+    def write_blue(self, fname, data, xdelta, timecode, keywords, ext_keywords):
+        '''
+        Minimal type 1000 CI BLUE file with main and extended keywords
+        '''
+        payload = np.array(data, dtype=np.int16).tobytes()
+        ext = b''
+        for name, fmt, value in ext_keywords:
+            tag = name.encode()
+            body = value.encode() if fmt == 'A' else struct.pack('<' + {'D': 'd', 'L': 'i'}[fmt], value)
+            lkey = 8 + len(body) + len(tag)
+            pad = (8 - lkey % 8) % 8
+            lkey += pad
+            ext += struct.pack('<ihbc', lkey, lkey - len(body), len(tag), fmt.encode()) + \
+                body + tag + b'\0' * pad
+        ext_start = (512 + len(payload) + 511) // 512
+        hcb = bytearray(512)
+        hcb[0:12] = b'BLUEEEEIEEEI'
+        struct.pack_into('<ii', hcb, 24, ext_start, len(ext))
+        struct.pack_into('<dd', hcb, 32, 512.0, float(len(payload)))
+        struct.pack_into('<i', hcb, 48, 1000)
+        hcb[52:54] = b'CI'
+        struct.pack_into('<d', hcb, 56, timecode)
+        keys = b'\0'.join(k.encode() for k in keywords)
+        struct.pack_into('<i', hcb, 160, len(keys))
+        hcb[164:164 + len(keys)] = keys
+        struct.pack_into('<dd', hcb, 256, 0.0, xdelta)
+        with open(fname, 'wb') as f:
+            f.write(bytes(hcb))
+            f.write(payload)
+            f.write(b'\0' * (ext_start * 512 - 512 - len(payload)))
+            f.write(ext)
+
+    def test_008_blue(self):
+        '''
+        Native BLUE reader parses the header, keywords and the data region
+        without reading the extended header as samples
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'capture.tmp')
+        data = np.arange(-50, 50)
+        # timecode is seconds since 1950
+        self.write_blue(fname, data, 1e-6, 631152000.0 + 1000.25, ['OPERATOR=test'],
+                        [('RFFREQ', 'D', 2.4e9), ('GAIN', 'L', 30), ('SITE', 'A', 'lab')])
+
+        dut = sandia_utils.file_source(gr.sizeof_gr_complex, fname, 'blue', False, False)
+        sink = blocks.vector_sink_c()
+        self.tb.connect(dut, sink)
+
+        self.tb.start()
+        time.sleep(.5)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertComplexTuplesAlmostEqual(data[0::2] + 1j * data[1::2], sink.data())
+
+        tags = {pmt.symbol_to_string(t.key): t.value for t in sink.tags()}
+        self.assertAlmostEqual(2.4e9, pmt.to_double(tags['rx_freq']))
+        self.assertAlmostEqual(1e6, pmt.to_double(tags['rate']))
+        self.assertEqual(1000, pmt.to_uint64(pmt.tuple_ref(tags['rx_time'], 0)))
+        self.assertAlmostEqual(0.25, pmt.to_double(pmt.tuple_ref(tags['rx_time'], 1)))
+        self.assertEqual(30, pmt.to_long(tags['GAIN']))
+        self.assertEqual('lab', pmt.symbol_to_string(tags['SITE']))
+        self.assertEqual('test', pmt.symbol_to_string(tags['OPERATOR']))
+
+        shutil.rmtree(tmpdir)
+
+    def test_009_stride(self):
+        '''
+        Strided reads keep one block per stride and tag each block's time
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'capture.dat')
+        data = np.arange(1000, dtype=np.complex64)
+        self.write_raw_header(fname, 915e6, 1000.0, 100.5, data)
+
+        for period in [False, True]:
+            self.tb = gr.top_block()
+            dut = sandia_utils.file_source(gr.sizeof_gr_complex, fname, 'raw_header',
+                                           False, False)
+            dut.add_file_tags(True)
+            if period:
+                dut.set_stride_period(10, 0.1)
+            else:
+                dut.set_stride(10, 100)
+            sink = blocks.vector_sink_c()
+            self.tb.connect(dut, sink)
+
+            self.tb.start()
+            time.sleep(.5)
+            self.tb.stop()
+            self.tb.wait()
+
+            expected = np.concatenate([data[i:i + 10] for i in range(0, 1000, 100)])
+            self.assertComplexTuplesAlmostEqual(expected, sink.data())
+
+            times = [(t.offset, pmt.to_uint64(pmt.tuple_ref(t.value, 0)) +
+                      pmt.to_double(pmt.tuple_ref(t.value, 1)))
+                     for t in sink.tags() if pmt.eq(t.key, pmt.intern('rx_time'))]
+            self.assertEqual(list(range(0, 100, 10)), [t[0] for t in times])
+            for n, t in enumerate(times):
+                self.assertAlmostEqual(100.5 + 0.1 * n, t[1])
+
+        shutil.rmtree(tmpdir)
+
+    def test_010_pdu_latency(self):
+        '''
+        A PDU to an idle source starts the file without waiting out the idle
+        timeout
+        '''
+        tmpdir = tempfile.mkdtemp()
+        fname = os.path.join(tmpdir, 'capture.dat')
+        data = np.arange(1000, dtype=np.complex64)
+        self.write_raw_header(fname, 915e6, 1000.0, 100.5, data)
+        pdu = pmt.cons(pmt.dict_add(pmt.make_dict(), pmt.intern('fname'),
+                                    pmt.intern(fname)), pmt.PMT_NIL)
+
+        latency = []
+        for _ in range(5):
+            self.tb = gr.top_block()
+            dut = sandia_utils.file_source(gr.sizeof_gr_complex, '', 'raw_header',
+                                           False, False)
+            sink = blocks.vector_sink_c()
+            self.tb.connect(dut, sink)
+
+            self.tb.start()
+            # let work() settle into its idle wait
+            time.sleep(.2)
+
+            start = time.monotonic()
+            dut.to_basic_block()._post(pmt.intern('pdu'), pdu)
+            while len(sink.data()) == 0 and time.monotonic() - start < 1.0:
+                time.sleep(.001)
+            latency.append(time.monotonic() - start)
+
+            self.tb.stop()
+            self.tb.wait()
+
+        shutil.rmtree(tmpdir)
+
+        # the idle wait is 100 ms, a PDU that waited it out would show here
+        self.assertLess(np.median(latency), .05)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_file_source)
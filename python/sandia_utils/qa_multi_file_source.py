@@ -0,0 +1,142 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+# (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+# retains certain rights in this software.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+try:
+    from gnuradio import sandia_utils
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio import sandia_utils
+
+import numpy as np
+import os
+import pmt
+import shutil
+import struct
+import tempfile
+
+
+class qa_multi_file_source(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.tmpdir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        self.tb = None
+        shutil.rmtree(self.tmpdir)
+
+    def write_raw_header(self, fname, rate, start_time, data):
+        with open(fname, 'wb') as f:
+            np.array([0.0, rate, start_time], dtype=np.float64).tofile(f)
+            np.array(data, dtype=np.complex64).tofile(f)
+
+    def write_blue(self, fname, data, timecode):
+        '''
+        Type 1000 CI BLUE file at 1 MHz, with an extended header after the
+        data
+        '''
+        payload = np.array(data, dtype=np.int16).tobytes()
+        ext = struct.pack('<ihbc', 16, 12, 4, b'L') + struct.pack('<i', 30) + b'GAIN'
+        ext_start = (512 + len(payload) + 511) // 512
+        hcb = bytearray(512)
+        hcb[0:12] = b'BLUEEEEIEEEI'
+        struct.pack_into('<ii', hcb, 24, ext_start, len(ext))
+        struct.pack_into('<dd', hcb, 32, 512.0, float(len(payload)))
+        struct.pack_into('<i', hcb, 48, 1000)
+        hcb[52:54] = b'CI'
+        struct.pack_into('<d', hcb, 56, timecode)
+        struct.pack_into('<dd', hcb, 256, 0.0, 1e-6)
+        with open(fname, 'wb') as f:
+            f.write(bytes(hcb))
+            f.write(payload)
+            f.write(b'\0' * (ext_start * 512 - 512 - len(payload)))
+            f.write(ext)
+
+    def test_001_aligned(self):
+        '''
+        Channels are trimmed to the latest start time and stop with the
+        shortest channel
+        '''
+        rate = 1000.0
+        fnames = [os.path.join(self.tmpdir, 'ch%d.dat' % i) for i in range(3)]
+        # channel 1 starts 10 samples late, channel 2 starts 25 samples late
+        self.write_raw_header(fnames[0], rate, 5.0, np.arange(1000))
+        self.write_raw_header(fnames[1], rate, 5.010, np.arange(10, 1010))
+        self.write_raw_header(fnames[2], rate, 5.025, np.arange(25, 925))
+
+        dut = sandia_utils.multi_file_source(gr.sizeof_gr_complex, fnames, 'raw_header')
+        sinks = [blocks.vector_sink_c() for _ in fnames]
+        for i, sink in enumerate(sinks):
+            self.tb.connect((dut, i), sink)
+        self.tb.run()
+
+        self.assertEqual([25, 15, 0], [dut.trimmed(i) for i in range(3)])
+        self.assertEqual(900, dut.nitems())
+        expected = np.arange(25, 925)
+        for sink in sinks:
+            self.assertComplexTuplesAlmostEqual(expected, sink.data())
+
+        # every channel reports the aligned start
+        for sink in sinks:
+            tags = [t for t in sink.tags() if pmt.eq(t.key, pmt.intern('rx_time'))]
+            self.assertEqual(1, len(tags))
+            self.assertEqual(0, tags[0].offset)
+            t = pmt.to_uint64(pmt.tuple_ref(tags[0].value, 0)) + \
+                pmt.to_double(pmt.tuple_ref(tags[0].value, 1))
+            self.assertAlmostEqual(5.025, t)
+
+    def test_002_unaligned(self):
+        '''
+        Raw files are played from the start of each file
+        '''
+        fnames = [os.path.join(self.tmpdir, 'ch%d.dat' % i) for i in range(2)]
+        np.arange(100, dtype=np.float32).tofile(fnames[0])
+        np.arange(100, 150, dtype=np.float32).tofile(fnames[1])
+
+        dut = sandia_utils.multi_file_source(gr.sizeof_float, fnames, 'raw', False)
+        sinks = [blocks.vector_sink_f() for _ in fnames]
+        for i, sink in enumerate(sinks):
+            self.tb.connect((dut, i), sink)
+        self.tb.run()
+
+        self.assertFloatTuplesAlmostEqual(np.arange(50), sinks[0].data())
+        self.assertFloatTuplesAlmostEqual(np.arange(100, 150), sinks[1].data())
+
+    def test_003_blue_sc16(self):
+        '''
+        16 bit complex BLUE files are read in their own itemsize and
+        converted, without reading past the data region
+        '''
+        fnames = [os.path.join(self.tmpdir, 'ch%d.blue' % i) for i in range(2)]
+        data = np.arange(-400, 400)
+        # timecode is seconds since 1950, channel 1 starts 10 samples late
+        self.write_blue(fnames[0], data, 631152000.0 + 1000.0)
+        self.write_blue(fnames[1], data[20:], 631152000.0 + 1000.0 + 10e-6)
+
+        dut = sandia_utils.multi_file_source(gr.sizeof_gr_complex, fnames, 'blue')
+        sinks = [blocks.vector_sink_c() for _ in fnames]
+        for i, sink in enumerate(sinks):
+            self.tb.connect((dut, i), sink)
+        self.tb.run()
+
+        self.assertEqual([10, 0], [dut.trimmed(i) for i in range(2)])
+        self.assertEqual(390, dut.nitems())
+        expected = data[20::2] + 1j * data[21::2]
+        for sink in sinks:
+            self.assertComplexTuplesAlmostEqual(expected, sink.data())
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_multi_file_source)
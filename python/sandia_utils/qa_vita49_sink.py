@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+# (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+# retains certain rights in this software.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import socket
+import struct
+import time
+import pmt
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+try:
+    from gnuradio import sandia_utils
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio import sandia_utils
+
+
+def make_tag(offset, key, value):
+    tag = gr.tag_t()
+    tag.offset = offset
+    tag.key = pmt.intern(key)
+    tag.value = value
+    return tag
+
+
+class qa_vita49_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def source(self, data):
+        tags = [make_tag(0, "rx_time", pmt.make_tuple(pmt.from_uint64(10),
+                                                      pmt.from_double(0.25))),
+                make_tag(0, "rx_rate", pmt.from_double(1e6)),
+                make_tag(0, "rx_freq", pmt.from_double(1e9))]
+        return blocks.vector_source_c(data, False, 1, tags)
+
+    def test_001_packets(self):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(('127.0.0.1', 8111))
+        sock.settimeout(1.0)
+
+        data = [complex(i, -i) / 32768.0 for i in range(250)]
+        dut = sandia_utils.vita49_sink("127.0.0.1", 8111, "udp", "fc32", "sc16", 100, 7)
+        self.tb.connect(self.source(data), dut)
+        self.tb.run()
+
+        packets = [sock.recv(65536) for i in range(4)]
+        sock.close()
+
+        # context, sid 7, UTC + real time, RF reference and sample rate
+        words = struct.unpack('>10I', packets[0])
+        self.assertEqual(0x4060000a, words[0])
+        self.assertEqual(7, words[1])
+        self.assertEqual(10, words[2])
+        self.assertEqual(250000000000, (words[3] << 32) | words[4])
+        self.assertEqual(0x80000000 | (1 << 27) | (1 << 21), words[5])
+        self.assertEqual(int(1e9) << 20, (words[6] << 32) | words[7])
+        self.assertEqual(int(1e6) << 20, (words[8] << 32) | words[9])
+
+        # 100, 100 then 50 samples, time advancing at the sample rate
+        for (count, pkt) in enumerate(packets[1:]):
+            nsamples = 50 if count == 2 else 100
+            words = struct.unpack('>5I', pkt[:20])
+            self.assertEqual(0x10600000 | (count << 16) | (5 + nsamples), words[0])
+            self.assertEqual(7, words[1])
+            self.assertEqual(10, words[2])
+            self.assertEqual(250000000000 + count * 100000000, (words[3] << 32) | words[4])
+            samples = struct.unpack('>%dh' % (2 * nsamples), pkt[20:])
+            self.assertEqual(100 * count, samples[0])
+            self.assertEqual(-(100 * count + 1), samples[3])
+
+        self.assertEqual(4, dut.getPacketCount())
+        self.assertEqual(0, dut.getDropCount())
+
+    def test_002_loopback(self):
+        # stream source on its own flowgraph, so it is listening first
+        rx_tb = gr.top_block()
+        src = sandia_utils.vita49_stream_source(8111, "udp", "fc32", 32768.0, "sc12")
+        sink = blocks.vector_sink_c()
+        rx_tb.connect(src, sink)
+        rx_tb.start()
+        time.sleep(0.05)
+
+        data = [complex(i % 100, -(i % 100)) / 32768.0 for i in range(1000)]
+        dut = sandia_utils.vita49_sink("127.0.0.1", 8111, "udp", "fc32", "sc12", 128, 1)
+        self.tb.connect(self.source(data), dut)
+        self.tb.run()
+
+        time.sleep(0.1)
+        rx_tb.stop()
+        rx_tb.wait()
+
+        # the last short packet is padded to a whole word
+        self.assertComplexTuplesAlmostEqual(data, sink.data()[:1000], 1e-6)
+
+        tags = sorted(sink.tags(), key=lambda t: pmt.symbol_to_string(t.key))
+        keys = [(t.offset, pmt.symbol_to_string(t.key)) for t in tags]
+        self.assertEqual([(0, 'rx_freq'), (0, 'rx_rate'), (0, 'rx_time')], keys)
+        self.assertAlmostEqual(1e9, pmt.to_double(tags[0].value))
+        self.assertEqual(10, pmt.to_uint64(pmt.tuple_ref(tags[2].value, 0)))
+        self.assertAlmostEqual(0.25, pmt.to_double(pmt.tuple_ref(tags[2].value, 1)))
+        self.assertEqual(0, src.getSeqGaps())
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_vita49_sink)
@@ -0,0 +1,146 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2018, 2019, 2020 National Technology & Engineering Solutions of Sandia, LLC
+# (NTESS). Under the terms of Contract DE-NA0003525 with NTESS, the U.S. Government
+# retains certain rights in this software.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import socket
+import struct
+import time
+import pmt
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+try:
+    from gnuradio import sandia_utils
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio import sandia_utils
+
+
+def data_packet(count, sec, frac_ps, samples):
+    '''
+    Signal data packet, UTC + real time stamps, one (I, Q) pair per word
+    '''
+    size = 4 + len(samples)
+    words = [0x00600000 | (count << 16) | size, sec, frac_ps >> 32, frac_ps & 0xffffffff]
+    words += [((i & 0xffff) << 16) | (q & 0xffff) for (i, q) in samples]
+    return struct.pack('>%dI' % len(words), *words)
+
+
+def context_packet(freq, rate):
+    '''
+    Context packet with RF reference frequency and sample rate
+    '''
+    words = [0x40600000 | 10, 1, 0, 0, 0, (1 << 27) | (1 << 21)]
+    for value in (freq, rate):
+        fixed = int(value * (1 << 20))
+        words += [fixed >> 32, fixed & 0xffffffff]
+    return struct.pack('>%dI' % len(words), *words)
+
+
+class qa_vita49_stream_source(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_udp(self, dut, sink, packets):
+        self.tb.connect(dut, sink)
+        self.tb.start()
+        time.sleep(0.05)
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        for pkt in packets:
+            sock.sendto(pkt, ('127.0.0.1', 8109))
+        sock.close()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_001_sc16(self):
+        dut = sandia_utils.vita49_stream_source(8109, "udp", "sc16")
+        sink = blocks.vector_sink_s(2)
+        samples = [(1, -1), (258, 772), (-32768, 32767)]
+        self.run_udp(dut, sink, [data_packet(0, 50, 300000, samples)])
+
+        self.assertEqual([x for s in samples for x in s], list(sink.data()))
+
+        tags = sink.tags()
+        self.assertEqual(1, len(tags))
+        self.assertEqual(0, tags[0].offset)
+        self.assertTrue(pmt.equal(pmt.intern("rx_time"), tags[0].key))
+        self.assertEqual(50, pmt.to_uint64(pmt.tuple_ref(tags[0].value, 0)))
+        self.assertEqual(3e-7, pmt.to_double(pmt.tuple_ref(tags[0].value, 1)))
+
+    def test_002_fc32_tags(self):
+        dut = sandia_utils.vita49_stream_source(8109, "udp", "fc32", 32768.0)
+        sink = blocks.vector_sink_c()
+        samples = [(16384, -16384)] * 4
+        # continuous, then a context update, then a lost packet
+        self.run_udp(dut, sink, [data_packet(0, 10, 0, samples),
+                                 data_packet(1, 10, 4000, samples),
+                                 context_packet(1e9, 1e6),
+                                 data_packet(3, 10, 12000, samples)])
+
+        data = sink.data()
+        self.assertEqual(12, len(data))
+        self.assertComplexTuplesAlmostEqual([0.5 - 0.5j] * 12, data)
+
+        tags = sorted(sink.tags(), key=lambda t: (t.offset, pmt.symbol_to_string(t.key)))
+        keys = [(t.offset, pmt.symbol_to_string(t.key)) for t in tags]
+        self.assertEqual([(0, 'rx_time'), (8, 'rx_freq'), (8, 'rx_rate'), (8, 'rx_time')],
+                         keys)
+        self.assertAlmostEqual(1e9, pmt.to_double(tags[1].value))
+        self.assertAlmostEqual(1e6, pmt.to_double(tags[2].value))
+        self.assertAlmostEqual(12e-9, pmt.to_double(pmt.tuple_ref(tags[3].value, 1)))
+
+        # data packets carry no stream ID, the context packet is stream 1
+        self.assertEqual(4, dut.getPacketCount())
+        self.assertEqual(1, dut.getSeqGaps())
+        self.assertEqual(0, dut.getResyncCount())
+        streams = pmt.dict_ref(dut.getStats(), pmt.intern("streams"), pmt.PMT_NIL)
+        stream0 = pmt.dict_ref(streams, pmt.from_uint64(0), pmt.PMT_NIL)
+        self.assertEqual(3, pmt.to_uint64(pmt.dict_ref(stream0, pmt.intern("packets"),
+                                                       pmt.PMT_NIL)))
+
+    def test_003_sc12_payload(self):
+        dut = sandia_utils.vita49_stream_source(8109, "udp", "sc16", 2048.0, "sc12")
+        sink = blocks.vector_sink_s(2)
+        # (2047, -1), (-2048, 1) packed into 6 bytes, padded to two words
+        payload = bytes([0x7f, 0xff, 0xff, 0x80, 0x00, 0x01, 0x00, 0x00])
+        header = struct.pack('>4I', 0x00600000 | 6, 50, 0, 0)
+        self.run_udp(dut, sink, [header + payload])
+
+        self.assertEqual([2047, -1, -2048, 1], list(sink.data()))
+
+    def test_004_time_follows(self):
+        dut = sandia_utils.vita49_stream_source(8109, "udp", "sc16")
+        sink = blocks.vector_sink_s(2)
+        samples = [(1, 1)] * 4
+        # 1 MHz, 4 us packets. Jitter under half a sample is absorbed, a
+        # jump in time with an unbroken packet count is a new time reference
+        us = 1000000
+        self.run_udp(dut, sink, [context_packet(1e9, 1e6),
+                                 data_packet(0, 1700000000, 999992 * us, samples),
+                                 data_packet(1, 1700000000, 999996 * us + 400000, samples),
+                                 data_packet(2, 1700000001, 0, samples),
+                                 data_packet(3, 1700000001, 40 * us, samples),
+                                 data_packet(4, 1700000001, 44 * us - 100000, samples)])
+
+        self.assertEqual(20, len(sink.data()))
+        times = [(t.offset, pmt.to_uint64(pmt.tuple_ref(t.value, 0)),
+                  pmt.to_double(pmt.tuple_ref(t.value, 1)))
+                 for t in sink.tags() if pmt.symbol_to_string(t.key) == 'rx_time']
+        self.assertEqual([(0, 1700000000, 0.999992), (12, 1700000001, 40e-6)], times)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_vita49_stream_source)